@@ -70,15 +70,55 @@ typedef enum CdRipRipModes {
     RIP_MODES_BEST = 1,
     /** Default (currently maps to best). */
     RIP_MODES_DEFAULT = 2,
+    /** Test and copy: read twice without checks, re-read only mismatching ranges with full checks. */
+    RIP_MODES_VERIFY = 3,
+    /** Hybrid: overlap checks only, escalating to full checks around regions that report read errors. */
+    RIP_MODES_HYBRID = 4,
+    /** Salvage: read the whole disc fast first, then retry only ranges that reported errors (see cdrip_salvage_disc). */
+    RIP_MODES_SALVAGE = 5,
 } CdRipRipModes;
 
+/**
+ * Special FLAC compression level values (0-8 select a fixed level).
+ */
+typedef enum CdRipCompressionLevels {
+    /** Pick by rip mode (fast --> 1, best --> 5). */
+    CDRIP_COMPRESSION_AUTO = -1,
+    /** Start like auto, then move the level between tracks from measured encoder headroom. */
+    CDRIP_COMPRESSION_ADAPTIVE = -2,
+} CdRipCompressionLevels;
+
+/** Container of an output added by cdrip_add_output. */
+typedef enum CdRipOutputKinds {
+    /** FLAC at its own compression level. */
+    CDRIP_OUTPUT_FLAC = 0,
+    /** RIFF WAVE, 16-bit little-endian PCM. */
+    CDRIP_OUTPUT_WAV = 1,
+    /** AIFF, 16-bit big-endian PCM. */
+    CDRIP_OUTPUT_AIFF = 2,
+    /** Headerless 16-bit little-endian stereo PCM. */
+    CDRIP_OUTPUT_RAW = 3,
+} CdRipOutputKinds;
+
+/**
+ * How cover art is stored with ripped/updated tracks.
+ */
+typedef enum CdRipCoverArtEmbedModes {
+    /** Embed the normalized cover art into every track (default). */
+    CDRIP_COVER_ART_EMBED_FULL = 0,
+    /** Embed a small thumbnail into every track; the full image lives in an album cover file. */
+    CDRIP_COVER_ART_EMBED_THUMBNAIL = 1,
+    /** Do not embed cover art; the image only lives in an album cover file. */
+    CDRIP_COVER_ART_EMBED_NONE = 2,
+} CdRipCoverArtEmbedModes;
+
 /** Global configuration loaded from INI or defaults. */
 typedef struct CdRipConfig {
     /** CD device path (nullable => auto-detect). */
     const char* device;
     /** Output filename/dirname format template. */
     const char* format;
-    /** FLAC compression (0-8, <0 => auto). */
+    /** FLAC compression (0-8, or CdRipCompressionLevels; other negative values => auto). */
     int compression_level;
     /** Cover art maximum width in pixels (<=0 => default). */
     int max_width;
@@ -125,6 +165,23 @@ void cdrip_release_config(
 void cdrip_set_cover_art_max_width(
     int max_width_px);
 
+/**
+ * Set how cover art is embedded into track files for future rips/updates.
+ * @param mode Embed mode (unknown values => CDRIP_COVER_ART_EMBED_FULL).
+ */
+void cdrip_set_cover_art_embed_mode(
+    CdRipCoverArtEmbedModes mode);
+
+/**
+ * Set the on-disk cache for normalized cover art images.
+ * @param directory Cache directory (nullable; NULL or empty disables the cache).
+ * @param max_bytes Size budget for cached images; least recently used entries are
+ *        evicted beyond it (<=0 => default 256 MiB).
+ */
+void cdrip_set_cover_art_cache(
+    const char* directory,
+    long long max_bytes);
+
 /** Detected CD drive information. */
 typedef struct CdRipDetectedDrive {
     /** Device path. */
@@ -159,12 +216,16 @@ void cdrip_release_detecteddrive_list(
 typedef struct CdRipSettings {
     /** Output filename/dirname format template. */
     const char* format;
-    /** FLAC compression (0-8, <0 => auto). */
+    /** FLAC compression (0-8, or CdRipCompressionLevels; other negative values => auto). */
     int compression_level;
     /** Rip mode. */
     CdRipRipModes mode;
     /** Drive speed selection (false: slow, true: fast). */
     bool speed_fast;
+    /** FLAC encoder threads per track (<=0 => auto: all cores with speed_fast, otherwise 1). Ignored when libFLAC lacks multithreading. */
+    int encoder_threads;
+    /** Drive read offset in samples (as listed by AccurateRip); audio is shifted so tracks start at the true sample. */
+    int read_offset;
 } CdRipSettings;
 
 /** Opaque handle for Scheme CD ripper. */
@@ -234,7 +295,7 @@ typedef struct CdRipTagKV {
 
 /** Cover art image (front cover). */
 typedef struct CdRipCoverArt {
-    /** Raw image bytes (owned). */
+    /** Raw image bytes (owned, allocated with new[]; released with the entry list). */
     const uint8_t* data;
     /** Size of image bytes. */
     size_t size;
@@ -483,6 +544,61 @@ typedef struct CdRipTaggedTocList {
     size_t count;
 } CdRipTaggedTocList;
 
+/**
+ * Set the persistent scan index used by cdrip_collect_cddb_queries_from_path.
+ * Files whose size, mtime and inode match the index are not opened again.
+ * @param index_path Index file path (nullable; NULL or empty disables the index).
+ */
+void cdrip_set_scan_index(
+    const char* index_path);
+
+/**
+ * Set the AccurateRip database that ripped tracks are checked against.
+ * The source is a local directory or GIO URI holding dBAR-*.bin files (flat or in the server's a/b/c/ layout),
+ * or an http(s) base URL such as http://www.accuraterip.com/accuraterip.
+ * Checksums are computed and tagged either way; only the ACCURATERIP_RESULT tag needs a database.
+ * @param source Database location (nullable; NULL or empty disables lookups).
+ */
+void cdrip_set_accuraterip_database(
+    const char* source);
+
+/**
+ * Set the archive index used to detect discs that were already ripped.
+ * The index maps disc identifiers to album locations and is appended to as albums are registered.
+ * @param index_path Index file path (nullable; NULL or empty disables the index).
+ */
+void cdrip_set_archive_index(
+    const char* index_path);
+
+/**
+ * Look up a disc in the archive index.
+ * Locations that no longer exist are ignored.
+ * @param toc Disc TOC.
+ * @return Archived album location, or NULL when not archived; free with cdrip_release_archived_location.
+ */
+const char* cdrip_find_archived_disc(
+    const CdRipDiscToc* toc);
+
+/**
+ * Release a location returned by cdrip_find_archived_disc.
+ * @param p Location pointer (nullable).
+ */
+void cdrip_release_archived_location(
+    const char* p);
+
+/**
+ * Register a disc in the archive index.
+ * Succeeds without writing when the index is disabled or already holds this mapping.
+ * @param toc Disc TOC.
+ * @param location Album location (directory path or URI); relative paths are stored as absolute paths.
+ * @param error Optional error string out-parameter.
+ * @return Non-zero on success.
+ */
+int cdrip_register_archived_disc(
+    const CdRipDiscToc* toc,
+    const char* location,
+    const char** error /* nullable */);
+
 /**
  * Collect CDDB query information from FLAC files under the path.
  * If path is a directory, recursively enumerates *.flac files.
@@ -514,8 +630,75 @@ int cdrip_update_flac_with_cddb_entry(
     const CdRipCddbEntry* entry,
     const char** error /* nullable */);
 
+/**
+ * Outcome of updating an existing FLAC file's tags.
+ */
+typedef enum CdRipUpdateResults {
+    /** Update failed (see error). */
+    CDRIP_UPDATE_FAILED = 0,
+    /** Tags or picture differed and were written (or would be, in dry-run). */
+    CDRIP_UPDATE_CHANGED = 1,
+    /** File already carries identical tags and picture; nothing was written. */
+    CDRIP_UPDATE_UNCHANGED = 2,
+} CdRipUpdateResults;
+
+/**
+ * Update an existing FLAC file's tags, skipping the write when nothing changes.
+ * @param tagged Source tagged TOC (path + toc + track number).
+ * @param entry Selected CDDB entry.
+ * @param dry_run Non-zero to only compare; the file is never written.
+ * @param error Optional error string out-parameter.
+ * @return Update outcome.
+ */
+CdRipUpdateResults cdrip_update_flac_with_cddb_entry_ex(
+    const CdRipTaggedToc* tagged,
+    const CdRipCddbEntry* entry,
+    int dry_run,
+    const char** error /* nullable */);
+
 /* ------------------------------------------------------------------- */
 
+/** Read statistics of a track, counted from cd-paranoia callback events. */
+typedef struct CdRipReadStats {
+    /** Verified overlaps (routine in modes with integrity checks). */
+    long verified;
+    /** Fixed up edges/atoms and corrected dropped or duplicated bytes. */
+    long fixups;
+    /** Scratches detected or repaired. */
+    long scratches;
+    /** Positions given up and skipped. */
+    long skips;
+    /** Drift (jitter) corrections. */
+    long drifts;
+    /** Drive read or cache errors. */
+    long read_errors;
+    /** Times the hybrid mode switched to full integrity checks. */
+    long escalations;
+    /** Sectors read with full integrity checks by the hybrid mode. */
+    long escalated_sectors;
+} CdRipReadStats;
+
+/** Number of buckets in CdRipReadTelemetry::sector_time_histogram. */
+enum { CDRIP_READ_TIME_BUCKETS = 8 };
+
+/** Read quality telemetry of a track, collected when enabled by cdrip_set_read_telemetry. */
+typedef struct CdRipReadTelemetry {
+    /** Track number (1-based). */
+    int track_number;
+    /** Paranoia event counts. */
+    CdRipReadStats stats;
+    /** Sector reads, including re-reads. */
+    long sectors_read;
+    /** Sectors read again (verify mode mismatches and hybrid mode escalations). */
+    long reread_sectors;
+    /** Wall-clock seconds spent in sector reads. */
+    double read_seconds;
+    /** Slowest single sector read in seconds. */
+    double slowest_sector_sec;
+    /** Sector reads by duration: <1 ms, <2 ms, <5 ms, <20 ms, <100 ms, <500 ms, <2 s, >=2 s. */
+    long sector_time_histogram[CDRIP_READ_TIME_BUCKETS];
+} CdRipReadTelemetry;
+
 /** Progress information passed to callback during ripping. */
 typedef struct CdRipProgressInfo {
     /** Current track number. */
@@ -548,6 +731,22 @@ typedef struct CdRipProgressInfo {
     const char* safe_title;
     /** Destination path/URI currently writing. */
     const char* path;
+    /** FLAC compression level used for the current track (resolved, 0-8). */
+    int compression_level;
+    /** Non-zero when compression_level was chosen by the adaptive mode. */
+    int compression_adaptive;
+    /** AccurateRip result of the track; set only on the final update when a database is configured (nullable). */
+    const char* accuraterip;
+    /** Sectors re-read with full integrity checks so far (verify mode only). */
+    long verify_reread_sectors;
+    /** Read statistics of the track so far (nullable; valid only during the callback). */
+    const CdRipReadStats* read_stats;
+    /** Read quality telemetry of the track so far (nullable; set only when telemetry is enabled). */
+    const CdRipReadTelemetry* telemetry;
+    /** Sectors that exhausted the read budget so far (kept as read, or silence when unreadable). */
+    long damaged_sectors;
+    /** Integrity checks lowered by the read budget: 0 none, 1 overlap checks only, 2 no checks. */
+    int read_degrade_level;
 } CdRipProgressInfo;
 
 /** Progress callback signature. */
@@ -579,6 +778,131 @@ int cdrip_rip_track(
     double total_album_sec,
     double wall_start_sec);
 
+/**
+ * Rip the audio tracks of a disc into one FLAC image with an embedded CUESHEET and SEEKTABLE.
+ * The path comes from the handle's format template, resolved against album tags with TITLE
+ * set to the album; per-track tags are stored as CUE_TRACKnn_<KEY>.
+ * @param cdrip Ripper handle.
+ * @param meta CDDB metadata for the album.
+ * @param toc Disc TOC; its audio tracks must be contiguous.
+ * @param progress Progress callback (nullable); reports the image as a single track.
+ * @param error Optional error string out-parameter.
+ * @param wall_start_sec Wall-clock start timestamp (seconds since epoch).
+ * @return Non-zero on success, zero on failure.
+ */
+int cdrip_rip_disc_image(
+    CdRip* cdrip,
+    const CdRipCddbEntry* meta,
+    const CdRipDiscToc* toc,
+    CdRipProgressCallback progress,
+    const char** error /* nullable */,
+    double wall_start_sec);
+
+/**
+ * Enable read quality telemetry for tracks ripped through this handle.
+ * Telemetry is delivered with progress updates, tagged as CDRIP_READ_QUALITY, kept per track
+ * for cdrip_write_read_report, and summarized per track through the observer.
+ * @param cdrip Ripper handle.
+ * @param enabled Collect telemetry (collection is skipped entirely when false).
+ * @param observer Optional observer for per-track summaries (copied; nullable).
+ */
+void cdrip_set_read_telemetry(
+    CdRip* cdrip,
+    bool enabled,
+    const CdRipDiagnosticObserver* observer /* nullable */);
+
+/**
+ * Limit how long ripping may spend reading, so damaged discs degrade instead of stalling.
+ * A sector read over the sector budget lowers the integrity checks one step (full, overlap only,
+ * none) with fewer retries; a track over its budget drops to no checks at once. At the lowest step,
+ * slow sectors are flagged and unreadable ones become silence; both are listed in the
+ * CDRIP_DAMAGED_SECTORS tag. A watchdog reports reads that block past the sector budget.
+ * @param cdrip Ripper handle.
+ * @param sector_budget_sec Budget of a single sector read in seconds (<=0 => unlimited).
+ * @param track_budget_sec Budget of all reads of a track in seconds (<=0 => unlimited).
+ * @param observer Optional observer for watchdog and degrade notices (copied; nullable).
+ */
+void cdrip_set_read_budget(
+    CdRip* cdrip,
+    double sector_budget_sec,
+    double track_budget_sec,
+    const CdRipDiagnosticObserver* observer /* nullable */);
+
+/**
+ * Read adjacent tracks as one continuous stream.
+ * A track that starts right where the previous track stopped continues the same reader without
+ * seeking, so the drive and the paranoia cache stream across track boundaries and the read offset
+ * carries over sample-exact. Tracks ripped out of order, after a data track or in verify/salvage
+ * mode are read as usual.
+ * @param cdrip Ripper handle.
+ * @param enabled Keep the reader positioned between tracks.
+ */
+void cdrip_set_sequential_read(
+    CdRip* cdrip,
+    bool enabled);
+
+/**
+ * Add an output written from the same sector reads as the main FLAC of every track.
+ * Each output encodes on its own thread behind a bounded queue, so an output costs CPU time,
+ * not another pass over the disc. Outputs are published as soon as their track is complete;
+ * ReplayGain tags are only written to the main FLAC, and WAV, AIFF and raw outputs carry no tags.
+ * @param cdrip Ripper handle.
+ * @param kind Output container.
+ * @param format Filename/dirname format template of this output.
+ * @param compression_level FLAC compression 0-8 (ignored by other containers).
+ * @param error Optional error string out-parameter.
+ * @return Non-zero on success, zero on failure.
+ */
+int cdrip_add_output(
+    CdRip* cdrip,
+    CdRipOutputKinds kind,
+    const char* format,
+    int compression_level,
+    const char** error /* nullable */);
+
+/**
+ * Remove every output added by cdrip_add_output.
+ * @param cdrip Ripper handle.
+ */
+void cdrip_clear_outputs(
+    CdRip* cdrip);
+
+/**
+ * Read every audio track of a disc ahead of encoding, leaving damaged ranges for last (salvage mode).
+ * The first pass reads the whole disc at full speed with overlap checks only and records the ranges
+ * that reported errors. Later passes retry only those ranges at low speed, first with overlap checks,
+ * then with full checks. The audio is kept in a temporary spool that cdrip_rip_track then encodes
+ * from and releases once every track was encoded; ranges that never read cleanly are listed in the
+ * CDRIP_DAMAGED_SECTORS tag. cdrip_rip_track calls this implicitly in salvage mode when the disc has
+ * not been read yet, reporting through its own progress callback.
+ * @param cdrip Ripper handle.
+ * @param toc Disc TOC to read.
+ * @param observer Optional observer for per-pass summaries (nullable).
+ * @param progress Optional callback for the progress of each pass; the pass is passed as track name (nullable).
+ * @param error Optional error string out-parameter.
+ * @return Non-zero on success, zero on failure.
+ */
+int cdrip_salvage_disc(
+    CdRip* cdrip,
+    const CdRipDiscToc* toc,
+    const CdRipDiagnosticObserver* observer /* nullable */,
+    CdRipProgressCallback progress /* nullable */,
+    const char** error /* nullable */);
+
+/**
+ * Write the telemetry of the disc's ripped tracks as a JSON report.
+ * @param cdrip Ripper handle.
+ * @param toc Disc TOC the tracks were ripped from.
+ * @param path Destination path or URI.
+ * @param error Optional error string out-parameter.
+ * @return Non-zero on success, zero on failure.
+ */
+int cdrip_write_read_report(
+    CdRip* cdrip,
+    const CdRipDiscToc* toc,
+    const char* path,
+    const char** error /* nullable */);
+
 #ifdef __cplusplus
 }
 #endif
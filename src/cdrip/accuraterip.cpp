@@ -0,0 +1,311 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gio/gio.h>
+
+#include "internal.h"
+#include "http_retry.h"
+#include "version.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+// Per pressing: track count, id1, id2, CDDB id; then per track: confidence, CRC, frame 450 CRC.
+constexpr size_t kDbHeaderBytes = 1 + 4 * 3;
+constexpr size_t kDbTrackBytes = 1 + 4 * 2;
+
+std::mutex g_accuraterip_mutex;
+std::string g_accuraterip_source;
+
+// Database of the disc being ripped; every track of a disc shares one lookup.
+struct AccurateRipDbCache {
+    std::string source;
+    std::string relative_path;
+    bool found{false};
+    std::string error;
+    std::vector<std::vector<AccurateRipDbEntry>> tracks;
+};
+AccurateRipDbCache g_accuraterip_cache;
+
+static std::string accuraterip_user_agent() {
+    std::string ua = "SchemeCDRipper/";
+    ua += VERSION;
+    ua += " (https://github.com/kekyo/scheme-cd-ripper)";
+    return ua;
+}
+
+static uint32_t read_le32(
+    const uint8_t* p) {
+
+    return static_cast<uint32_t>(p[0]) |
+        (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) |
+        (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static bool is_http_source(
+    const std::string& source) {
+
+    return source.rfind("http://", 0) == 0 || source.rfind("https://", 0) == 0;
+}
+
+static std::string join_source_path(
+    const std::string& base,
+    const std::string& relative) {
+
+    if (base.empty() || base.back() == '/') return base + relative;
+    return base + "/" + relative;
+}
+
+static bool load_gio_file(
+    const std::string& location,
+    std::vector<uint8_t>& out,
+    bool& out_missing,
+    std::string& err) {
+
+    out.clear();
+    out_missing = false;
+    GFile* file = is_uri(location)
+        ? g_file_new_for_uri(location.c_str())
+        : g_file_new_for_path(location.c_str());
+    char* contents = nullptr;
+    gsize length = 0;
+    GError* gerr = nullptr;
+    const bool ok = g_file_load_contents(file, nullptr, &contents, &length, nullptr, &gerr);
+    g_object_unref(file);
+    if (!ok) {
+        out_missing = gerr && g_error_matches(gerr, G_IO_ERROR, G_IO_ERROR_NOT_FOUND);
+        err = std::string("Failed to read AccurateRip database: ") + (gerr ? gerr->message : location);
+        g_clear_error(&gerr);
+        return false;
+    }
+    out.assign(contents, contents + length);
+    g_free(contents);
+    return true;
+}
+
+// Fetch the database file of a disc. A missing file means the disc was never submitted.
+static bool fetch_accuraterip_db(
+    const std::string& source,
+    const AccurateRipDiscIds& ids,
+    std::vector<uint8_t>& out,
+    bool& out_found,
+    std::string& err) {
+
+    out_found = false;
+    const std::string relative = accuraterip_db_relative_path(ids);
+    if (is_http_source(source)) {
+        HttpRetryPolicy policy{};
+        std::string content_type;
+        guint status = 0;
+        if (http_get_bytes_with_retry(
+                "AccurateRip",
+                join_source_path(source, relative),
+                accuraterip_user_agent(),
+                nullptr,
+                policy,
+                out,
+                content_type,
+                err,
+                &status)) {
+            out_found = true;
+            return true;
+        }
+        if (status == SOUP_STATUS_NOT_FOUND) {
+            err.clear();
+            return true;
+        }
+        return false;
+    }
+
+    // Local mirror: either the server layout (a/b/c/dBAR-...) or all files in one directory.
+    const std::string file_name = relative.substr(relative.find_last_of('/') + 1);
+    for (const auto& candidate : {join_source_path(source, relative), join_source_path(source, file_name)}) {
+        bool missing = false;
+        if (load_gio_file(candidate, out, missing, err)) {
+            out_found = true;
+            return true;
+        }
+        if (!missing) return false;
+    }
+    err.clear();
+    return true;
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+bool compute_accuraterip_disc_ids(
+    const CdRipDiscToc* toc,
+    AccurateRipDiscIds& out) {
+
+    out = AccurateRipDiscIds{};
+    if (!toc || !toc->tracks || toc->tracks_count == 0 || !toc->cddb_discid) return false;
+
+    // Audio session only: the lead-out is where the last audio track ends.
+    const long leadout = toc->tracks[toc->tracks_count - 1].end + 1;
+    for (size_t i = 0; i < toc->tracks_count; ++i) {
+        const uint32_t offset = static_cast<uint32_t>(toc->tracks[i].start);
+        out.id1 += offset;
+        out.id2 += (offset > 0 ? offset : 1) * static_cast<uint32_t>(i + 1);
+    }
+    out.id1 += static_cast<uint32_t>(leadout);
+    out.id2 += static_cast<uint32_t>(leadout) * static_cast<uint32_t>(toc->tracks_count + 1);
+    out.track_count = static_cast<unsigned>(toc->tracks_count);
+
+    char* end = nullptr;
+    const unsigned long cddb = std::strtoul(toc->cddb_discid, &end, 16);
+    if (!end || end == toc->cddb_discid || *end != '\0') return false;
+    out.cddb = static_cast<uint32_t>(cddb);
+    return true;
+}
+
+std::string accuraterip_db_relative_path(
+    const AccurateRipDiscIds& ids) {
+
+    char buf[64];
+    std::snprintf(
+        buf,
+        sizeof(buf),
+        "%x/%x/%x/dBAR-%03u-%08x-%08x-%08x.bin",
+        static_cast<unsigned>(ids.id1 & 0xF),
+        static_cast<unsigned>((ids.id1 >> 4) & 0xF),
+        static_cast<unsigned>((ids.id1 >> 8) & 0xF),
+        ids.track_count,
+        static_cast<unsigned>(ids.id1),
+        static_cast<unsigned>(ids.id2),
+        static_cast<unsigned>(ids.cddb));
+    return std::string{buf};
+}
+
+bool parse_accuraterip_db(
+    const std::vector<uint8_t>& data,
+    const AccurateRipDiscIds& ids,
+    std::vector<std::vector<AccurateRipDbEntry>>& out_tracks,
+    std::string& err) {
+
+    err.clear();
+    out_tracks.assign(ids.track_count, {});
+    size_t pos = 0;
+    while (pos < data.size()) {
+        if (data.size() - pos < kDbHeaderBytes) {
+            err = "Truncated AccurateRip database header";
+            return false;
+        }
+        const unsigned track_count = data[pos];
+        const uint32_t id1 = read_le32(&data[pos + 1]);
+        const uint32_t id2 = read_le32(&data[pos + 5]);
+        const uint32_t cddb = read_le32(&data[pos + 9]);
+        pos += kDbHeaderBytes;
+        if (data.size() - pos < static_cast<size_t>(track_count) * kDbTrackBytes) {
+            err = "Truncated AccurateRip database entry";
+            return false;
+        }
+        const bool matches = track_count == ids.track_count && id1 == ids.id1 && id2 == ids.id2 && cddb == ids.cddb;
+        for (unsigned i = 0; i < track_count; ++i) {
+            const uint8_t* entry = &data[pos + static_cast<size_t>(i) * kDbTrackBytes];
+            if (matches && entry[0] > 0) {
+                out_tracks[i].push_back(AccurateRipDbEntry{entry[0], read_le32(entry + 1)});
+            }
+        }
+        pos += static_cast<size_t>(track_count) * kDbTrackBytes;
+    }
+    return true;
+}
+
+bool check_accuraterip(
+    const CdRipDiscToc* toc,
+    size_t track_index,
+    const AccurateRipChecksum& checksum,
+    std::string& out_result) {
+
+    out_result.clear();
+    std::string source;
+    {
+        std::lock_guard<std::mutex> guard(g_accuraterip_mutex);
+        source = g_accuraterip_source;
+    }
+    if (source.empty()) return false;
+
+    AccurateRipDiscIds ids{};
+    if (!compute_accuraterip_disc_ids(toc, ids)) {
+        out_result = "lookup failed: unusable TOC";
+        return true;
+    }
+    const std::string relative = accuraterip_db_relative_path(ids);
+    AccurateRipDbCache cache{};
+    bool cached = false;
+    {
+        std::lock_guard<std::mutex> guard(g_accuraterip_mutex);
+        if (g_accuraterip_cache.source == source && g_accuraterip_cache.relative_path == relative) {
+            cache = g_accuraterip_cache;
+            cached = true;
+        }
+    }
+    if (!cached) {
+        // The download runs without the lock, so other callers only wait for the cache itself.
+        cache.source = source;
+        cache.relative_path = relative;
+        std::vector<uint8_t> data;
+        if (fetch_accuraterip_db(cache.source, ids, data, cache.found, cache.error) && cache.found) {
+            parse_accuraterip_db(data, ids, cache.tracks, cache.error);
+        }
+        std::lock_guard<std::mutex> guard(g_accuraterip_mutex);
+        // The source may have changed during the download; keep only a current result.
+        if (g_accuraterip_source == source) g_accuraterip_cache = cache;
+    }
+
+    if (!cache.error.empty()) {
+        out_result = "lookup failed: " + cache.error;
+        return true;
+    }
+    if (!cache.found || track_index >= cache.tracks.size()) {
+        out_result = "not in database";
+        return true;
+    }
+    const auto& entries = cache.tracks[track_index];
+    unsigned v1_confidence = 0;
+    unsigned v2_confidence = 0;
+    for (const auto& entry : entries) {
+        if (entry.crc == checksum.v2) v2_confidence += entry.confidence;
+        if (entry.crc == checksum.v1) v1_confidence += entry.confidence;
+    }
+    if (v2_confidence > 0) {
+        out_result = "verified v2 (confidence " + std::to_string(v2_confidence) + ")";
+    } else if (v1_confidence > 0) {
+        out_result = "verified v1 (confidence " + std::to_string(v1_confidence) + ")";
+    } else if (entries.empty()) {
+        out_result = "not in database";
+    } else {
+        out_result = "mismatch (" + std::to_string(entries.size()) + " submission(s))";
+    }
+    return true;
+}
+
+}  // namespace cdrip::detail
+
+/* ------------------------------------------------------------------- */
+/* Exported API functions */
+
+extern "C" {
+
+void cdrip_set_accuraterip_database(
+    const char* source) {
+
+    std::lock_guard<std::mutex> guard(g_accuraterip_mutex);
+    g_accuraterip_source = to_string_or_empty(source);
+    g_accuraterip_cache = AccurateRipDbCache{};
+}
+
+};
@@ -0,0 +1,238 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gio/gio.h>
+
+#include "internal.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+constexpr const char* kArchiveIndexHeader = "cdrip-archive-index 1";
+
+// The index is append-only; rewrite it once superseded lines outnumber live ones.
+constexpr size_t kArchiveIndexCompactSlack = 256;
+
+std::mutex g_archive_index_mutex;
+std::string g_archive_index_path;
+bool g_archive_index_loaded = false;
+std::unordered_map<std::string, std::string> g_archive_index;
+
+static bool location_exists(
+    const std::string& location) {
+
+    GFile* file = is_uri(location)
+        ? g_file_new_for_uri(location.c_str())
+        : g_file_new_for_path(location.c_str());
+    const bool exists = g_file_query_exists(file, nullptr);
+    g_object_unref(file);
+    return exists;
+}
+
+// Local locations are kept absolute, so the index means the same from any working directory.
+static std::string normalize_archive_location(
+    const std::string& location) {
+
+    if (location.empty() || is_uri(location)) return location;
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::absolute(location, ec);
+    if (ec) return {};
+    path = path.lexically_normal();
+    if (!path.has_filename() && path.has_parent_path() && path != path.root_path()) path = path.parent_path();
+    return path.string();
+}
+
+static bool rewrite_archive_index_locked(
+    std::string& err) {
+
+    const std::filesystem::path path(g_archive_index_path);
+    std::filesystem::path tmp = path;
+    tmp += ".tmp" + std::to_string(::getpid());
+    std::error_code ec;
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            err = "Failed to write archive index: " + tmp.string();
+            return false;
+        }
+        out << kArchiveIndexHeader << "\n";
+        for (const auto& [key, location] : g_archive_index) {
+            out << escape_index_field(key) << "\t" << escape_index_field(location) << "\n";
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmp, ec);
+            err = "Failed to write archive index: " + tmp.string();
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        err = "Failed to replace archive index: " + g_archive_index_path;
+        return false;
+    }
+    return true;
+}
+
+// Caller holds g_archive_index_mutex.
+static void ensure_archive_index_loaded_locked() {
+    if (g_archive_index_loaded) return;
+    g_archive_index_loaded = true;
+    g_archive_index.clear();
+    if (g_archive_index_path.empty()) return;
+
+    std::ifstream in(g_archive_index_path, std::ios::binary);
+    if (!in) return;
+    std::string line;
+    if (!std::getline(in, line) || line != kArchiveIndexHeader) return;
+    // Line: key, location. Later lines supersede earlier ones.
+    size_t lines = 0;
+    while (std::getline(in, line)) {
+        const auto fields = split_index_fields(line);
+        if (fields.size() != 2) continue;
+        g_archive_index[unescape_index_field(fields[0])] = unescape_index_field(fields[1]);
+        ++lines;
+    }
+    in.close();
+
+    if (lines > g_archive_index.size() * 2 + kArchiveIndexCompactSlack) {
+        std::string err;
+        rewrite_archive_index_locked(err);
+    }
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+std::vector<std::string> build_archive_keys(
+    const CdRipDiscToc* toc) {
+
+    std::vector<std::string> keys;
+    if (!toc) return keys;
+    const std::string mb_discid = to_string_or_empty(toc->mb_discid);
+    if (!mb_discid.empty()) {
+        keys.push_back("mb:" + mb_discid);
+    }
+    // CDDB ids collide easily; the offsets make the key specific to one pressing.
+    std::string cddb_discid = to_string_or_empty(toc->cddb_discid);
+    const std::string offsets = build_cddb_offsets_tag(toc);
+    if (!cddb_discid.empty() && !offsets.empty()) {
+        for (auto& ch : cddb_discid) {
+            ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        }
+        keys.push_back("cddb:" + cddb_discid + "|" + offsets);
+    }
+    return keys;
+}
+
+}  // namespace cdrip::detail
+
+/* ------------------------------------------------------------------- */
+/* Exported API functions */
+
+extern "C" {
+
+void cdrip_set_archive_index(
+    const char* index_path) {
+
+    std::lock_guard<std::mutex> guard(g_archive_index_mutex);
+    g_archive_index_path = to_string_or_empty(index_path);
+    g_archive_index_loaded = false;
+    g_archive_index.clear();
+}
+
+const char* cdrip_find_archived_disc(
+    const CdRipDiscToc* toc) {
+
+    const auto keys = build_archive_keys(toc);
+    if (keys.empty()) return nullptr;
+    std::lock_guard<std::mutex> guard(g_archive_index_mutex);
+    if (g_archive_index_path.empty()) return nullptr;
+    ensure_archive_index_loaded_locked();
+    for (const auto& key : keys) {
+        const auto it = g_archive_index.find(key);
+        if (it == g_archive_index.end()) continue;
+        // An album removed from the archive must not block ripping it again. Relative locations
+        // from older indexes depend on the working directory and cannot be trusted either.
+        const bool relative = !is_uri(it->second) && !std::filesystem::path(it->second).is_absolute();
+        if (relative || !location_exists(it->second)) {
+            g_archive_index.erase(it);
+            continue;
+        }
+        return make_cstr_copy(it->second);
+    }
+    return nullptr;
+}
+
+void cdrip_release_archived_location(
+    const char* p) {
+
+    delete[] p;
+}
+
+int cdrip_register_archived_disc(
+    const CdRipDiscToc* toc,
+    const char* location,
+    const char** error) {
+
+    clear_error(error);
+    const auto keys = build_archive_keys(toc);
+    const std::string location_str = normalize_archive_location(to_string_or_empty(location));
+    if (keys.empty() || location_str.empty()) {
+        set_error(error, "Disc has no identifiers or location to register");
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> guard(g_archive_index_mutex);
+    if (g_archive_index_path.empty()) return 1;
+    ensure_archive_index_loaded_locked();
+
+    std::vector<const std::string*> changed;
+    for (const auto& key : keys) {
+        const auto it = g_archive_index.find(key);
+        if (it != g_archive_index.end() && it->second == location_str) continue;
+        changed.push_back(&key);
+    }
+    if (changed.empty()) return 1;
+
+    const std::filesystem::path path(g_archive_index_path);
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    const bool fresh = !std::filesystem::exists(path, ec) || std::filesystem::file_size(path, ec) == 0;
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    if (!out) {
+        set_error(error, "Failed to open archive index: " + g_archive_index_path);
+        return 0;
+    }
+    if (fresh) out << kArchiveIndexHeader << "\n";
+    for (const auto* key : changed) {
+        out << escape_index_field(*key) << "\t" << escape_index_field(location_str) << "\n";
+    }
+    out.flush();
+    if (!out) {
+        set_error(error, "Failed to append archive index: " + g_archive_index_path);
+        return 0;
+    }
+    for (const auto* key : changed) {
+        g_archive_index[*key] = location_str;
+    }
+    return 1;
+}
+
+};
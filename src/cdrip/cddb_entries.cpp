@@ -129,7 +129,7 @@ static void release_cddb_entry(CdRipCddbEntry& e) {
     release_cstr(e.source_url);
     release_cstr(e.fetched_at);
     if (e.cover_art.data) {
-        delete[] e.cover_art.data;
+        release_cover_art_data(e.cover_art.data);
         e.cover_art.data = nullptr;
     }
     release_cstr(e.cover_art.mime_type);
@@ -1745,7 +1745,7 @@ void cdrip_release_cddbentry_list(
             release_cstr(e->source_url);
             release_cstr(e->fetched_at);
             if (e->cover_art.data) {
-                delete[] e->cover_art.data;
+                release_cover_art_data(e->cover_art.data);
                 e->cover_art.data = nullptr;
             }
             release_cstr(e->cover_art.mime_type);
@@ -154,6 +154,9 @@ static CdRipRipModes parse_mode(
     const std::string upper = to_lower(trim(value));
     if (upper == "fast") return RIP_MODES_FAST;
     if (upper == "best") return RIP_MODES_BEST;
+    if (upper == "verify") return RIP_MODES_VERIFY;
+    if (upper == "hybrid") return RIP_MODES_HYBRID;
+    if (upper == "salvage") return RIP_MODES_SALVAGE;
     return RIP_MODES_DEFAULT;
 }
 
@@ -269,7 +272,9 @@ CdRipConfig* cdrip_load_config(
             g_free(value);
             const std::string upper = to_lower(v);
             if (upper == "auto") {
-                cfg->compression_level = -1;
+                cfg->compression_level = CDRIP_COMPRESSION_AUTO;
+            } else if (upper == "adaptive") {
+                cfg->compression_level = CDRIP_COMPRESSION_ADAPTIVE;
             } else {
                 try {
                     cfg->compression_level = std::stoi(v);
@@ -10,9 +10,11 @@
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <jpeglib.h>
@@ -36,8 +38,16 @@ constexpr int kCoverArtRetryDelayMs = 1200;
 
 constexpr int kDefaultCoverArtMaxWidth = 512;
 constexpr size_t kMaxFlacPictureBytes = 16 * 1024 * 1024 - 1;
+// Embedded thumbnail width when the full image lives in an album cover file.
+constexpr int kCoverArtThumbnailWidth = 128;
 
 std::atomic<int> g_cover_art_max_width{kDefaultCoverArtMaxWidth};
+std::atomic<int> g_cover_art_embed_mode{CDRIP_COVER_ART_EMBED_FULL};
+
+// Extra references of shared cover art buffers, kept beside the bytes so every payload stays a
+// plain new[] buffer. A buffer is listed only while it has more than one owner.
+std::mutex g_cover_art_refs_mutex;
+std::unordered_map<const uint8_t*, size_t> g_cover_art_refs;
 
 static std::string cover_art_user_agent() {
     std::string ua = "SchemeCDRipper/";
@@ -804,7 +814,8 @@ static bool http_get_bytes(
         err);
 }
 
-static bool http_get_discogs_json(
+static bool http_get_json_text(
+    const std::string& service_name,
     const std::string& url,
     std::string& body,
     std::string& err) {
@@ -819,7 +830,7 @@ static bool http_get_discogs_json(
     std::vector<uint8_t> bytes;
     std::string ct;
     if (!http_get_bytes_with_retry(
-            "Discogs",
+            service_name,
             url,
             cover_art_user_agent(),
             "application/json",
@@ -834,6 +845,22 @@ static bool http_get_discogs_json(
     return true;
 }
 
+static bool http_get_discogs_json(
+    const std::string& url,
+    std::string& body,
+    std::string& err) {
+
+    return http_get_json_text("Discogs", url, body, err);
+}
+
+static bool http_get_caa_json(
+    const std::string& url,
+    std::string& body,
+    std::string& err) {
+
+    return http_get_json_text("Cover Art Archive", url, body, err);
+}
+
 static std::string json_get_string_member(JsonObject* obj, const char* name) {
     if (!obj || !name) return {};
     if (!json_object_has_member(obj, name)) return {};
@@ -847,22 +874,144 @@ static JsonArray* json_get_array_member(JsonObject* obj, const char* name) {
     return json_object_get_array_member(obj, name);
 }
 
-static std::string select_discogs_image_url(JsonObject* release_obj) {
+static JsonObject* json_get_object_member(JsonObject* obj, const char* name) {
+    if (!obj || !name) return nullptr;
+    if (!json_object_has_member(obj, name)) return nullptr;
+    JsonNode* node = json_object_get_member(obj, name);
+    if (!node || !JSON_NODE_HOLDS_OBJECT(node)) return nullptr;
+    return json_node_get_object(node);
+}
+
+static int json_get_int_member(JsonObject* obj, const char* name) {
+    if (!obj || !name) return 0;
+    if (!json_object_has_member(obj, name)) return 0;
+    JsonNode* node = json_object_get_member(obj, name);
+    if (!node || !JSON_NODE_HOLDS_VALUE(node)) return 0;
+    const gint64 value = json_node_get_int(node);
+    if (value <= 0 || value > std::numeric_limits<int>::max()) return 0;
+    return static_cast<int>(value);
+}
+
+static bool parse_json_object(
+    const std::string& json_text,
+    const char* service_name,
+    JsonParser*& parser_out,
+    JsonObject*& root_out,
+    std::string& err) {
+
+    parser_out = nullptr;
+    root_out = nullptr;
+    JsonParser* parser = json_parser_new();
+    GError* gerr = nullptr;
+    if (!json_parser_load_from_data(parser, json_text.c_str(), json_text.size(), &gerr)) {
+        err = (gerr && gerr->message)
+            ? std::string{gerr->message}
+            : std::string{service_name} + " response parse error";
+        if (gerr) g_error_free(gerr);
+        g_object_unref(parser);
+        return false;
+    }
+    JsonNode* root = json_parser_get_root(parser);
+    if (!root || !JSON_NODE_HOLDS_OBJECT(root)) {
+        g_object_unref(parser);
+        err = std::string{service_name} + " response is not a JSON object";
+        return false;
+    }
+    parser_out = parser;
+    root_out = json_node_get_object(root);
+    return true;
+}
+
+// Pick the smallest candidate that still covers max_width_px.
+// Candidates with unknown width (0) are treated as large enough but least preferred,
+// and the largest known candidate is used when nothing covers max_width_px.
+static std::string pick_sized_image_url(
+    const std::vector<std::pair<int, std::string>>& candidates,
+    int max_width_px) {
+
+    if (max_width_px <= 0) max_width_px = kDefaultCoverArtMaxWidth;
+    const std::pair<int, std::string>* best_fit = nullptr;
+    const std::pair<int, std::string>* largest = nullptr;
+    const std::pair<int, std::string>* unknown = nullptr;
+    for (const auto& candidate : candidates) {
+        if (candidate.second.empty()) continue;
+        if (candidate.first <= 0) {
+            if (!unknown) unknown = &candidate;
+            continue;
+        }
+        if (candidate.first >= max_width_px &&
+            (!best_fit || candidate.first < best_fit->first)) {
+            best_fit = &candidate;
+        }
+        if (!largest || candidate.first > largest->first) {
+            largest = &candidate;
+        }
+    }
+    if (best_fit) return best_fit->second;
+    if (unknown) return unknown->second;
+    return largest ? largest->second : std::string{};
+}
+
+static std::string normalize_caa_url(const std::string& url) {
+    // The CAA index still lists plain http:// URLs for older uploads.
+    static const std::string kHttpPrefix = "http://";
+    if (url.compare(0, kHttpPrefix.size(), kHttpPrefix) == 0) {
+        return "https://" + url.substr(kHttpPrefix.size());
+    }
+    return url;
+}
+
+static bool caa_image_is_front(JsonObject* img) {
+    if (!img) return false;
+    if (json_object_has_member(img, "front")) {
+        JsonNode* node = json_object_get_member(img, "front");
+        if (node && JSON_NODE_HOLDS_VALUE(node) &&
+            json_object_get_boolean_member(img, "front")) {
+            return true;
+        }
+    }
+    JsonArray* types = json_get_array_member(img, "types");
+    if (!types) return false;
+    const guint len = json_array_get_length(types);
+    for (guint i = 0; i < len; ++i) {
+        const gchar* type = json_array_get_string_element(types, i);
+        if (type && to_lower(type) == "front") return true;
+    }
+    return false;
+}
+
+static std::string select_discogs_image_url(
+    JsonObject* release_obj,
+    int max_width_px) {
+
     JsonArray* images = json_get_array_member(release_obj, "images");
     if (!images) return {};
     const guint len = json_array_get_length(images);
-    std::string first_any;
-    for (guint i = 0; i < len; ++i) {
+    JsonObject* first_any = nullptr;
+    JsonObject* chosen = nullptr;
+    for (guint i = 0; i < len && !chosen; ++i) {
         JsonObject* img = json_array_get_object_element(images, i);
         if (!img) continue;
-        std::string uri = json_get_string_member(img, "uri");
-        if (uri.empty()) uri = json_get_string_member(img, "resource_url");
-        if (uri.empty()) continue;
-        if (first_any.empty()) first_any = uri;
+        if (json_get_string_member(img, "uri").empty() &&
+            json_get_string_member(img, "resource_url").empty()) {
+            continue;
+        }
+        if (!first_any) first_any = img;
         const std::string type = to_lower(json_get_string_member(img, "type"));
-        if (type == "primary") return uri;
+        if (type == "primary") chosen = img;
     }
-    return first_any;
+    if (!chosen) chosen = first_any;
+    if (!chosen) return {};
+
+    std::string uri = json_get_string_member(chosen, "uri");
+    if (uri.empty()) uri = json_get_string_member(chosen, "resource_url");
+    // Discogs only publishes a 150px variant next to the original.
+    const std::vector<std::pair<int, std::string>> candidates{
+        {150, json_get_string_member(chosen, "uri150")},
+        {json_get_int_member(chosen, "width"), uri},
+    };
+    const std::string picked = pick_sized_image_url(candidates, max_width_px);
+    return picked.empty() ? uri : picked;
 }
 
 static bool http_get_discogs_image_bytes(
@@ -889,6 +1038,27 @@ static bool http_get_discogs_image_bytes(
         err);
 }
 
+static void assign_normalized_cover_art(
+    CdRipCddbEntry* entry,
+    const std::vector<uint8_t>& png) {
+
+    if (entry->cover_art.data) {
+        release_cover_art_data(entry->cover_art.data);
+        entry->cover_art.data = nullptr;
+    }
+    entry->cover_art.size = 0;
+    if (entry->cover_art.mime_type) {
+        delete[] entry->cover_art.mime_type;
+        entry->cover_art.mime_type = nullptr;
+    }
+
+    entry->cover_art.size = png.size();
+    entry->cover_art.data = make_shared_cover_art_data(png.data(), png.size());
+    entry->cover_art.mime_type = make_cstr_copy("image/png");
+    entry->cover_art.is_front = 1;
+    entry->cover_art.available = 1;
+}
+
 static void emit_cover_art_activity(
     const CdRipActivityObserver* observer,
     void* callback_state,
@@ -907,8 +1077,184 @@ static void emit_cover_art_activity(
 
 }  // namespace
 
+namespace cdrip::detail {
+
+bool select_caa_front_image_urls(
+    const std::string& index_json,
+    int max_width_px,
+    std::vector<std::string>& out_urls,
+    std::string& err) {
+
+    out_urls.clear();
+    err.clear();
+    JsonParser* parser = nullptr;
+    JsonObject* root_obj = nullptr;
+    if (!parse_json_object(index_json, "Cover Art Archive", parser, root_obj, err)) {
+        return false;
+    }
+
+    JsonArray* images = json_get_array_member(root_obj, "images");
+    JsonObject* front = nullptr;
+    if (images) {
+        const guint len = json_array_get_length(images);
+        for (guint i = 0; i < len && !front; ++i) {
+            JsonObject* img = json_array_get_object_element(images, i);
+            if (caa_image_is_front(img)) front = img;
+        }
+    }
+    if (!front) {
+        g_object_unref(parser);
+        err = "Cover Art Archive release has no front image";
+        return false;
+    }
+
+    const std::string original = normalize_caa_url(json_get_string_member(front, "image"));
+    std::vector<std::pair<int, std::string>> thumbnails;
+    JsonObject* thumbs = json_get_object_member(front, "thumbnails");
+    if (thumbs) {
+        // "small"/"large" are legacy aliases of 250/500 kept by older index documents.
+        static const std::pair<int, const char*> kThumbnailKeys[] = {
+            {250, "250"},
+            {500, "500"},
+            {1200, "1200"},
+            {250, "small"},
+            {500, "large"},
+        };
+        for (const auto& key : kThumbnailKeys) {
+            const std::string url = json_get_string_member(thumbs, key.second);
+            if (!url.empty()) thumbnails.emplace_back(key.first, normalize_caa_url(url));
+        }
+    }
+    g_object_unref(parser);
+
+    // The original has no published width; it is only picked when no thumbnail is big enough.
+    thumbnails.emplace_back(0, original);
+    const std::string picked = pick_sized_image_url(thumbnails, max_width_px);
+    if (!picked.empty()) out_urls.push_back(picked);
+    // Keep the original as a fallback: thumbnails of fresh uploads may not exist yet.
+    if (!original.empty() && picked != original) out_urls.push_back(original);
+    if (out_urls.empty()) {
+        err = "Cover Art Archive front image has no URL";
+        return false;
+    }
+    return true;
+}
+
+bool select_discogs_front_image_url(
+    const std::string& release_json,
+    int max_width_px,
+    std::string& out_url,
+    std::string& err) {
+
+    out_url.clear();
+    err.clear();
+    JsonParser* parser = nullptr;
+    JsonObject* root_obj = nullptr;
+    if (!parse_json_object(release_json, "Discogs", parser, root_obj, err)) {
+        return false;
+    }
+    out_url = select_discogs_image_url(root_obj, max_width_px);
+    g_object_unref(parser);
+    if (out_url.empty()) {
+        err = "Discogs release has no images";
+        return false;
+    }
+    return true;
+}
+
+const uint8_t* make_shared_cover_art_data(
+    const uint8_t* bytes,
+    size_t size) {
+
+    if (!bytes || size == 0) return nullptr;
+    auto* data = new uint8_t[size];
+    std::memcpy(data, bytes, size);
+    return data;
+}
+
+const uint8_t* retain_cover_art_data(
+    const uint8_t* data) {
+
+    if (!data) return nullptr;
+    std::lock_guard<std::mutex> guard(g_cover_art_refs_mutex);
+    auto [it, inserted] = g_cover_art_refs.emplace(data, 2);
+    if (!inserted) ++it->second;
+    return data;
+}
+
+void release_cover_art_data(
+    const uint8_t* data) {
+
+    if (!data) return;
+    {
+        std::lock_guard<std::mutex> guard(g_cover_art_refs_mutex);
+        auto it = g_cover_art_refs.find(data);
+        if (it != g_cover_art_refs.end()) {
+            if (--it->second <= 1) g_cover_art_refs.erase(it);
+            return;
+        }
+    }
+    delete[] data;
+}
+
+bool build_track_picture_block(
+    const CdRipCoverArt& art,
+    FLAC__StreamMetadata*& out_block,
+    std::string& err) {
+
+    out_block = nullptr;
+    if (!has_cover_art_data(art)) return true;
+
+    const int mode = g_cover_art_embed_mode.load(std::memory_order_relaxed);
+    if (mode == CDRIP_COVER_ART_EMBED_NONE) return true;
+    if (mode != CDRIP_COVER_ART_EMBED_THUMBNAIL) {
+        out_block = build_picture_block(art);
+        if (!out_block) {
+            err = "Failed to build picture metadata";
+            return false;
+        }
+        return true;
+    }
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(art.data);
+    const std::vector<uint8_t> input(bytes, bytes + art.size);
+    std::vector<uint8_t> thumbnail;
+    std::string norm_err;
+    if (!normalize_image_to_png(input, kCoverArtThumbnailWidth, thumbnail, norm_err)) {
+        err = "Failed to build cover art thumbnail: " + norm_err;
+        return false;
+    }
+    CdRipCoverArt thumb_art{};
+    thumb_art.data = thumbnail.data();
+    thumb_art.size = thumbnail.size();
+    thumb_art.mime_type = "image/png";
+    thumb_art.is_front = art.is_front;
+    out_block = build_picture_block(thumb_art);
+    if (!out_block) {
+        err = "Failed to build picture metadata";
+        return false;
+    }
+    return true;
+}
+
+}  // namespace cdrip::detail
+
 extern "C" {
 
+void cdrip_set_cover_art_embed_mode(
+    CdRipCoverArtEmbedModes mode) {
+
+    switch (mode) {
+    case CDRIP_COVER_ART_EMBED_THUMBNAIL:
+    case CDRIP_COVER_ART_EMBED_NONE:
+        break;
+    default:
+        mode = CDRIP_COVER_ART_EMBED_FULL;
+        break;
+    }
+    g_cover_art_embed_mode.store(mode, std::memory_order_relaxed);
+}
+
 void cdrip_set_cover_art_max_width(
     int max_width_px) {
 
@@ -951,6 +1297,16 @@ int cdrip_fetch_cover_art(
         return 0;
     }
 
+    const int max_width_px = g_cover_art_max_width.load(std::memory_order_relaxed);
+    // The release-group cache is only a fallback, like the network order below: a sibling
+    // release cached first must not hide this release's own front cover.
+    std::vector<uint8_t> cached;
+    if (!release_id.empty() &&
+        load_cached_cover_art("caa-release", release_id, max_width_px, cached)) {
+        assign_normalized_cover_art(entry, cached);
+        return 1;
+    }
+
     emit_cover_art_activity(
         observer,
         state,
@@ -979,14 +1335,62 @@ int cdrip_fetch_cover_art(
         return true;
     };
 
+    std::string cache_source;
+    std::string cache_id;
+
+    // Resolve through the JSON index so a thumbnail close to max_width is downloaded
+    // instead of the (possibly huge) original upload behind /front.
+    auto try_index = [&](const std::string& index_url) -> bool {
+        std::string index_json;
+        std::string local_err;
+        if (!http_get_caa_json(index_url, index_json, local_err)) {
+            if (!local_err.empty()) err_msg = local_err;
+            return false;
+        }
+        std::vector<std::string> urls;
+        if (!select_caa_front_image_urls(index_json, max_width_px, urls, local_err)) {
+            if (!local_err.empty()) err_msg = local_err;
+            return false;
+        }
+        for (const auto& url : urls) {
+            if (try_fetch(url)) return true;
+        }
+        return false;
+    };
+
     bool success = false;
     if (!release_id.empty()) {
-        const std::string url = "https://coverartarchive.org/release/" + release_id + "/front";
-        success = try_fetch(url);
+        success = try_index("https://coverartarchive.org/release/" + release_id);
+        if (success) {
+            cache_source = "caa-release";
+            cache_id = release_id;
+        }
+    }
+    // A release without a front cover of its own keeps the release-group image under its own
+    // key too, so the next lookup of this release is served from disk without a request.
+    const bool release_fallback = !success && !release_id.empty();
+    if (!success && !release_group_id.empty() &&
+        load_cached_cover_art("caa-release-group", release_group_id, max_width_px, cached)) {
+        if (release_fallback) store_cached_cover_art("caa-release", release_id, max_width_px, cached);
+        assign_normalized_cover_art(entry, cached);
+        emit_cover_art_activity(
+            observer,
+            state,
+            CDRIP_ACTIVITY_STATE_SOURCE_FINISHED,
+            "coverartarchive");
+        emit_cover_art_activity(
+            observer,
+            state,
+            CDRIP_ACTIVITY_STATE_PHASE_FINISHED,
+            nullptr);
+        return 1;
     }
     if (!success && !release_group_id.empty()) {
-        const std::string url = "https://coverartarchive.org/release-group/" + release_group_id + "/front";
-        success = try_fetch(url);
+        success = try_index("https://coverartarchive.org/release-group/" + release_group_id);
+        if (success) {
+            cache_source = "caa-release-group";
+            cache_id = release_group_id;
+        }
     }
 
     if (!success) {
@@ -1006,7 +1410,6 @@ int cdrip_fetch_cover_art(
 
     std::vector<uint8_t> normalized;
     std::string norm_err;
-    const int max_width_px = g_cover_art_max_width.load(std::memory_order_relaxed);
     if (!normalize_image_to_png(data, max_width_px, normalized, norm_err)) {
         emit_cover_art_activity(
             observer,
@@ -1022,13 +1425,9 @@ int cdrip_fetch_cover_art(
         return 0;
     }
 
-    content_type = "image/png";
-    entry->cover_art.size = normalized.size();
-    entry->cover_art.data = new uint8_t[entry->cover_art.size];
-    std::copy(normalized.begin(), normalized.end(), const_cast<uint8_t*>(entry->cover_art.data));
-    entry->cover_art.mime_type = make_cstr_copy(content_type);
-    entry->cover_art.is_front = 1;
-    entry->cover_art.available = 1;
+    store_cached_cover_art(cache_source, cache_id, max_width_px, normalized);
+    if (release_fallback) store_cached_cover_art("caa-release", release_id, max_width_px, normalized);
+    assign_normalized_cover_art(entry, normalized);
     emit_cover_art_activity(
         observer,
         state,
@@ -1072,6 +1471,13 @@ int cdrip_fetch_discogs_cover_art(
         }
     }
 
+    const int max_width_px = g_cover_art_max_width.load(std::memory_order_relaxed);
+    std::vector<uint8_t> cached;
+    if (load_cached_cover_art("discogs", release_id, max_width_px, cached)) {
+        assign_normalized_cover_art(entry, cached);
+        return 1;
+    }
+
     emit_cover_art_activity(
         observer,
         state,
@@ -1101,45 +1507,9 @@ int cdrip_fetch_discogs_cover_art(
         return 0;
     }
 
-    JsonParser* parser = json_parser_new();
-    GError* gerr = nullptr;
-    if (!json_parser_load_from_data(parser, body.c_str(), body.size(), &gerr)) {
-        std::string msg = (gerr && gerr->message) ? std::string{gerr->message} : "Discogs response parse error";
-        if (gerr) g_error_free(gerr);
-        g_object_unref(parser);
-        emit_cover_art_activity(
-            observer,
-            state,
-            CDRIP_ACTIVITY_STATE_SOURCE_FINISHED,
-            "discogs");
-        emit_cover_art_activity(
-            observer,
-            state,
-            CDRIP_ACTIVITY_STATE_PHASE_FINISHED,
-            nullptr);
-        set_error(error, msg);
-        return 0;
-    }
-    JsonNode* root = json_parser_get_root(parser);
-    if (!root || !JSON_NODE_HOLDS_OBJECT(root)) {
-        g_object_unref(parser);
-        emit_cover_art_activity(
-            observer,
-            state,
-            CDRIP_ACTIVITY_STATE_SOURCE_FINISHED,
-            "discogs");
-        emit_cover_art_activity(
-            observer,
-            state,
-            CDRIP_ACTIVITY_STATE_PHASE_FINISHED,
-            nullptr);
-        set_error(error, "Discogs response is not a JSON object");
-        return 0;
-    }
-    JsonObject* root_obj = json_node_get_object(root);
-    const std::string image_url = select_discogs_image_url(root_obj);
-    g_object_unref(parser);
-    if (image_url.empty()) {
+    std::string image_url;
+    std::string select_err;
+    if (!select_discogs_front_image_url(body, max_width_px, image_url, select_err)) {
         emit_cover_art_activity(
             observer,
             state,
@@ -1150,7 +1520,7 @@ int cdrip_fetch_discogs_cover_art(
             state,
             CDRIP_ACTIVITY_STATE_PHASE_FINISHED,
             nullptr);
-        set_error(error, "Discogs release has no images");
+        set_error(error, select_err);
         return 0;
     }
 
@@ -1173,7 +1543,6 @@ int cdrip_fetch_discogs_cover_art(
 
     std::vector<uint8_t> normalized;
     std::string norm_err;
-    const int max_width_px = g_cover_art_max_width.load(std::memory_order_relaxed);
     if (!normalize_image_to_png(data, max_width_px, normalized, norm_err)) {
         emit_cover_art_activity(
             observer,
@@ -1189,23 +1558,8 @@ int cdrip_fetch_discogs_cover_art(
         return 0;
     }
 
-    if (entry->cover_art.data) {
-        delete[] entry->cover_art.data;
-        entry->cover_art.data = nullptr;
-    }
-    entry->cover_art.size = 0;
-    if (entry->cover_art.mime_type) {
-        delete[] entry->cover_art.mime_type;
-        entry->cover_art.mime_type = nullptr;
-    }
-
-    content_type = "image/png";
-    entry->cover_art.size = normalized.size();
-    entry->cover_art.data = new uint8_t[entry->cover_art.size];
-    std::copy(normalized.begin(), normalized.end(), const_cast<uint8_t*>(entry->cover_art.data));
-    entry->cover_art.mime_type = make_cstr_copy(content_type);
-    entry->cover_art.is_front = 1;
-    entry->cover_art.available = 1;
+    store_cached_cover_art("discogs", release_id, max_width_px, normalized);
+    assign_normalized_cover_art(entry, normalized);
     emit_cover_art_activity(
         observer,
         state,
@@ -0,0 +1,223 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <glib.h>
+
+#include "internal.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+constexpr long long kDefaultCoverArtCacheMaxBytes = 256LL * 1024 * 1024;
+
+std::mutex g_cover_art_cache_mutex;
+std::string g_cover_art_cache_dir;
+long long g_cover_art_cache_max_bytes = kDefaultCoverArtCacheMaxBytes;
+
+static std::string build_cache_key(
+    const std::string& source,
+    const std::string& id,
+    int max_width_px) {
+
+    const std::string material = source + "|" + id + "|" + std::to_string(max_width_px);
+    gchar* digest = g_compute_checksum_for_string(G_CHECKSUM_SHA256, material.c_str(), -1);
+    std::string key = digest ? std::string{digest} : std::string{};
+    g_free(digest);
+    return key;
+}
+
+static bool write_file_atomically(
+    const std::filesystem::path& path,
+    const char* data,
+    size_t size) {
+
+    // Unique per process and thread so concurrent fetchers never share a temp file.
+    std::ostringstream suffix;
+    suffix << ".tmp" << ::getpid() << "-" << std::hash<std::thread::id>{}(std::this_thread::get_id());
+    std::filesystem::path tmp = path;
+    tmp += suffix.str();
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(data, static_cast<std::streamsize>(size));
+        if (!out) {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+// Drop least recently used entries (by PNG mtime, refreshed on every hit) until the
+// directory fits the byte budget. Caller holds g_cover_art_cache_mutex.
+static void evict_cover_art_cache_locked(
+    const std::filesystem::path& dir,
+    long long max_bytes) {
+
+    struct CacheFile {
+        std::filesystem::path png;
+        std::filesystem::file_time_type last_used;
+        long long bytes{0};
+    };
+
+    std::vector<CacheFile> files;
+    long long total = 0;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const auto& path = it->path();
+        if (path.extension() != ".png") continue;
+        CacheFile file{};
+        file.png = path;
+        file.last_used = std::filesystem::last_write_time(path, ec);
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        file.bytes = static_cast<long long>(std::filesystem::file_size(path, ec));
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        std::filesystem::path meta = path;
+        meta.replace_extension(".meta");
+        const auto meta_size = std::filesystem::file_size(meta, ec);
+        if (!ec) file.bytes += static_cast<long long>(meta_size);
+        ec.clear();
+        total += file.bytes;
+        files.push_back(std::move(file));
+    }
+    if (total <= max_bytes) return;
+
+    std::sort(files.begin(), files.end(), [](const CacheFile& lhs, const CacheFile& rhs) {
+        return lhs.last_used < rhs.last_used;
+    });
+    for (const auto& file : files) {
+        if (total <= max_bytes) break;
+        std::filesystem::path meta = file.png;
+        meta.replace_extension(".meta");
+        std::filesystem::remove(file.png, ec);
+        std::filesystem::remove(meta, ec);
+        total -= file.bytes;
+    }
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+bool load_cached_cover_art(
+    const std::string& source,
+    const std::string& id,
+    int max_width_px,
+    std::vector<uint8_t>& out_png) {
+
+    out_png.clear();
+    if (source.empty() || id.empty()) return false;
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> guard(g_cover_art_cache_mutex);
+        dir = g_cover_art_cache_dir;
+    }
+    if (dir.empty()) return false;
+
+    const std::string key = build_cache_key(source, id, max_width_px);
+    if (key.empty()) return false;
+    const std::filesystem::path png_path = std::filesystem::path(dir) / (key + ".png");
+
+    std::ifstream in(png_path, std::ios::binary);
+    if (!in) return false;
+    std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    if (data.size() < 8 || data[0] != 0x89 || data[1] != 'P' || data[2] != 'N' || data[3] != 'G') {
+        return false;
+    }
+    out_png.swap(data);
+
+    // Refresh the LRU position; failures only make the entry look older.
+    std::error_code ec;
+    std::filesystem::last_write_time(png_path, std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void store_cached_cover_art(
+    const std::string& source,
+    const std::string& id,
+    int max_width_px,
+    const std::vector<uint8_t>& png) {
+
+    if (source.empty() || id.empty() || png.empty()) return;
+    std::lock_guard<std::mutex> guard(g_cover_art_cache_mutex);
+    if (g_cover_art_cache_dir.empty()) return;
+
+    const std::filesystem::path dir(g_cover_art_cache_dir);
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) return;
+
+    const std::string key = build_cache_key(source, id, max_width_px);
+    if (key.empty()) return;
+
+    char* fetched_at = cdrip_current_timestamp_iso();
+    std::ostringstream meta;
+    meta << "source=" << source << "\n"
+         << "id=" << id << "\n"
+         << "max_width=" << max_width_px << "\n"
+         << "mime_type=image/png\n"
+         << "size=" << png.size() << "\n"
+         << "fetched_at=" << to_string_or_empty(fetched_at) << "\n";
+    cdrip_release_timestamp(fetched_at);
+    const std::string meta_text = meta.str();
+
+    // Metadata first: a PNG is only visible to readers once its description exists.
+    if (!write_file_atomically(dir / (key + ".meta"), meta_text.data(), meta_text.size())) return;
+    if (!write_file_atomically(
+            dir / (key + ".png"),
+            reinterpret_cast<const char*>(png.data()),
+            png.size())) {
+        return;
+    }
+    evict_cover_art_cache_locked(dir, g_cover_art_cache_max_bytes);
+}
+
+}  // namespace cdrip::detail
+
+/* ------------------------------------------------------------------- */
+/* Exported API functions */
+
+extern "C" {
+
+void cdrip_set_cover_art_cache(
+    const char* directory,
+    long long max_bytes) {
+
+    std::lock_guard<std::mutex> guard(g_cover_art_cache_mutex);
+    g_cover_art_cache_dir = to_string_or_empty(directory);
+    g_cover_art_cache_max_bytes = (max_bytes > 0) ? max_bytes : kDefaultCoverArtCacheMaxBytes;
+}
+
+};
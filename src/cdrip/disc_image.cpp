@@ -0,0 +1,258 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include <cdio/cdio.h>
+#include <FLAC/metadata.h>
+
+#include "internal.h"
+#include "format_value.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr int kSampleRate = 44100;
+constexpr int kSamplesPerSector = CDIO_CD_FRAMESIZE_RAW / (kChannels * sizeof(int16_t));
+
+// CD-DA cue sheets end with lead-out track 170 and start after a lead-in of at least 2 seconds.
+constexpr FLAC__byte kCueSheetLeadOutTrack = 170;
+constexpr FLAC__uint64 kCueSheetLeadInSamples = 2 * kSampleRate;
+
+static std::string cue_track_prefix(
+    int track_number) {
+
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "CUE_TRACK%02d_", track_number);
+    return std::string{buf};
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+bool build_disc_image_track(
+    const CdRipDiscToc* toc,
+    CdRipTrackInfo& out,
+    std::string& err) {
+
+    err.clear();
+    out = CdRipTrackInfo{};
+    if (!toc || !toc->tracks || toc->tracks_count == 0) {
+        err = "Disc image needs a TOC";
+        return false;
+    }
+    size_t first = toc->tracks_count;
+    size_t last = 0;
+    for (size_t i = 0; i < toc->tracks_count; ++i) {
+        if (!toc->tracks[i].is_audio) continue;
+        if (first == toc->tracks_count) first = i;
+        last = i;
+    }
+    if (first == toc->tracks_count) {
+        err = "Disc has no audio tracks";
+        return false;
+    }
+    // A data track inside the span would end up in the image as noise.
+    for (size_t i = first; i <= last; ++i) {
+        if (!toc->tracks[i].is_audio) {
+            err = "Disc image needs contiguous audio tracks (track " +
+                std::to_string(toc->tracks[i].number) + " is a data track)";
+            return false;
+        }
+    }
+    out.number = toc->tracks[first].number;
+    out.start = toc->tracks[first].start;
+    out.end = toc->tracks[last].end;
+    out.is_audio = 1;
+    return true;
+}
+
+std::map<std::string, std::string> build_disc_image_vorbis_tags(
+    const CdRipCddbEntry* meta,
+    const CdRipDiscToc* toc,
+    std::string& title_out,
+    std::string& track_name_out,
+    std::string& safe_title_out) {
+
+    title_out.clear();
+    track_name_out.clear();
+    safe_title_out.clear();
+    if (!meta || !toc || !toc->tracks) return {};
+
+    int audio_tracks = 0;
+    for (size_t i = 0; i < toc->tracks_count; ++i) {
+        if (toc->tracks[i].is_audio) ++audio_tracks;
+    }
+
+    // Track number 0 matches no track, which leaves exactly the album-level tags.
+    CdRipTrackInfo album_track{};
+    album_track.is_audio = 1;
+    std::string ignored_title;
+    std::string ignored_name;
+    std::string ignored_safe;
+    std::map<std::string, std::string> tags = build_track_vorbis_tags(
+        &album_track, meta, toc, audio_tracks, ignored_title, ignored_name, ignored_safe);
+    const auto album = tags.find("ALBUM");
+    const std::string discid = to_string_or_empty(toc->cddb_discid);
+    const std::string title = album != tags.end() && !album->second.empty()
+        ? album->second
+        : (discid.empty() ? std::string{"Disc"} : "Disc " + discid);
+    tags["TITLE"] = title;
+
+    // Per-track tags in the CUE-aware convention: CUE_TRACKnn_<KEY>, only where a track differs.
+    std::map<std::string, std::string> cue_tags;
+    for (size_t i = 0; i < toc->tracks_count; ++i) {
+        const auto& track = toc->tracks[i];
+        if (!track.is_audio) continue;
+        std::string track_title;
+        std::string track_name;
+        std::string safe_title;
+        const auto track_tags = build_track_vorbis_tags(
+            &track, meta, toc, audio_tracks, track_title, track_name, safe_title);
+        const std::string prefix = cue_track_prefix(track.number);
+        for (const auto& [key, value] : track_tags) {
+            if (key == "TRACKNUMBER") continue;
+            const auto it = tags.find(key);
+            if (key == "TITLE" || it == tags.end() || it->second != value) {
+                cue_tags[prefix + key] = value;
+            }
+        }
+    }
+    tags.insert(cue_tags.begin(), cue_tags.end());
+
+    title_out = title;
+    track_name_out = title;
+    safe_title_out = format_safe_string(title);
+    return tags;
+}
+
+FLAC__StreamMetadata* build_disc_image_cuesheet(
+    const CdRipDiscToc* toc,
+    const CdRipTrackInfo& image_track,
+    std::string& err) {
+
+    err.clear();
+    FLAC__StreamMetadata* cuesheet = FLAC__metadata_object_new(FLAC__METADATA_TYPE_CUESHEET);
+    if (!cuesheet) {
+        err = "Failed to create FLAC cue sheet";
+        return nullptr;
+    }
+    cuesheet->data.cue_sheet.is_cd = true;
+    cuesheet->data.cue_sheet.lead_in = kCueSheetLeadInSamples;
+
+    unsigned index = 0;
+    for (size_t i = 0; toc && i < toc->tracks_count; ++i) {
+        const auto& track = toc->tracks[i];
+        if (!track.is_audio || track.start < image_track.start || track.end > image_track.end) continue;
+        if (!FLAC__metadata_object_cuesheet_insert_blank_track(cuesheet, index) ||
+            !FLAC__metadata_object_cuesheet_track_insert_blank_index(cuesheet, index, 0)) {
+            FLAC__metadata_object_delete(cuesheet);
+            err = "Failed to add a track to the FLAC cue sheet";
+            return nullptr;
+        }
+        // Inserting may reallocate, so the track is looked up only once it is complete.
+        auto& cue_track = cuesheet->data.cue_sheet.tracks[index];
+        cue_track.offset = static_cast<FLAC__uint64>(track.start - image_track.start) * kSamplesPerSector;
+        cue_track.number = static_cast<FLAC__byte>(track.number);
+        cue_track.type = 0;
+        cue_track.pre_emphasis = 0;
+        cue_track.indices[0].offset = 0;
+        cue_track.indices[0].number = 1;
+        ++index;
+    }
+    if (!FLAC__metadata_object_cuesheet_insert_blank_track(cuesheet, index)) {
+        FLAC__metadata_object_delete(cuesheet);
+        err = "Failed to add the lead-out to the FLAC cue sheet";
+        return nullptr;
+    }
+    auto& lead_out = cuesheet->data.cue_sheet.tracks[index];
+    lead_out.offset =
+        static_cast<FLAC__uint64>(image_track.end - image_track.start + 1) * kSamplesPerSector;
+    lead_out.number = kCueSheetLeadOutTrack;
+
+    const char* violation = nullptr;
+    if (!FLAC__metadata_object_cuesheet_is_legal(cuesheet, /*check_cd_da_subset=*/true, &violation)) {
+        err = std::string("Invalid disc image cue sheet: ") + (violation ? violation : "unknown");
+        FLAC__metadata_object_delete(cuesheet);
+        return nullptr;
+    }
+    return cuesheet;
+}
+
+FLAC__StreamMetadata* build_disc_image_seektable(
+    const CdRipDiscToc* toc,
+    const CdRipTrackInfo& image_track) {
+
+    FLAC__StreamMetadata* seektable = FLAC__metadata_object_new(FLAC__METADATA_TYPE_SEEKTABLE);
+    if (!seektable) return nullptr;
+    const FLAC__uint64 total_samples =
+        static_cast<FLAC__uint64>(image_track.end - image_track.start + 1) * kSamplesPerSector;
+    // A point every second, plus one at every track start so players jump straight to a track.
+    bool ok = FLAC__metadata_object_seektable_template_append_spaced_points_by_samples(
+        seektable, kSampleRate, total_samples);
+    for (size_t i = 0; ok && toc && i < toc->tracks_count; ++i) {
+        const auto& track = toc->tracks[i];
+        if (!track.is_audio || track.start < image_track.start || track.end > image_track.end) continue;
+        ok = FLAC__metadata_object_seektable_template_append_point(
+            seektable, static_cast<FLAC__uint64>(track.start - image_track.start) * kSamplesPerSector);
+    }
+    if (!ok || !FLAC__metadata_object_seektable_template_sort(seektable, /*compact=*/true)) {
+        FLAC__metadata_object_delete(seektable);
+        return nullptr;
+    }
+    return seektable;
+}
+
+}  // namespace cdrip::detail
+
+/* ------------------------------------------------------------------- */
+/* Exported API functions */
+
+extern "C" {
+
+int cdrip_rip_disc_image(
+    CdRip* cdrip,
+    const CdRipCddbEntry* meta,
+    const CdRipDiscToc* toc,
+    CdRipProgressCallback progress,
+    const char** error,
+    double wall_start_sec) {
+
+    clear_error(error);
+    std::string err;
+    CdRipTrackInfo image_track{};
+    if (!build_disc_image_track(toc, image_track, err)) {
+        set_error(error, err);
+        return 0;
+    }
+    const double total_sec =
+        static_cast<double>(image_track.end - image_track.start + 1) * kSamplesPerSector / kSampleRate;
+    RipTrackWriteOptions options{};
+    options.disc_image = true;
+    if (!rip_track_with_options(
+            cdrip,
+            &image_track,
+            meta,
+            toc,
+            progress,
+            1,
+            0.0,
+            total_sec,
+            wall_start_sec,
+            &options,
+            nullptr,
+            err)) {
+        set_error(error, err);
+        return 0;
+    }
+    return 1;
+}
+
+};
@@ -85,6 +85,63 @@ auto live_set_drive_speed = [](
     return true;
 };
 
+static int paranoia_flags_for_mode(
+    CdRipRipModes mode) {
+
+    switch (mode) {
+        case RIP_MODES_FAST:
+        case RIP_MODES_VERIFY:
+            // Verify mode escalates single ranges through a second, full mode reader.
+            return PARANOIA_MODE_DISABLE;
+        case RIP_MODES_HYBRID:
+            // Overlap checks are cheap and still report the events that trigger escalation.
+            return PARANOIA_MODE_OVERLAP;
+        case RIP_MODES_BEST:
+        case RIP_MODES_SALVAGE:
+            // Salvage passes pick their own checks through set_reader_mode.
+        default:
+            return PARANOIA_MODE_FULL;
+    }
+}
+
+// paranoia_read() callbacks carry no context; reads run on the calling thread.
+thread_local CdRipReadStats* t_read_stats = nullptr;
+
+static void paranoia_event_callback(
+    long,
+    paranoia_cb_mode_t event) {
+
+    CdRipReadStats* stats = t_read_stats;
+    if (!stats) return;
+    switch (event) {
+        case PARANOIA_CB_VERIFY:
+            ++stats->verified;
+            break;
+        case PARANOIA_CB_FIXUP_EDGE:
+        case PARANOIA_CB_FIXUP_ATOM:
+        case PARANOIA_CB_FIXUP_DROPPED:
+        case PARANOIA_CB_FIXUP_DUPED:
+            ++stats->fixups;
+            break;
+        case PARANOIA_CB_SCRATCH:
+        case PARANOIA_CB_REPAIR:
+            ++stats->scratches;
+            break;
+        case PARANOIA_CB_SKIP:
+            ++stats->skips;
+            break;
+        case PARANOIA_CB_DRIFT:
+            ++stats->drifts;
+            break;
+        case PARANOIA_CB_READERR:
+        case PARANOIA_CB_CACHEERR:
+            ++stats->read_errors;
+            break;
+        default:
+            break;
+    }
+}
+
 auto live_create_reader = [](
     void* drive,
     CdRipRipModes mode,
@@ -104,22 +161,7 @@ auto live_create_reader = [](
         return false;
     }
 
-    const CdRipRipModes effective_mode = (mode == RIP_MODES_DEFAULT)
-        ? RIP_MODES_BEST
-        : mode;
-    int flags = PARANOIA_MODE_DISABLE;
-    switch (effective_mode) {
-        case RIP_MODES_FAST:
-            flags = PARANOIA_MODE_DISABLE;
-            break;
-        case RIP_MODES_BEST:
-            flags = PARANOIA_MODE_FULL;
-            break;
-        default:
-            flags = PARANOIA_MODE_FULL;
-            break;
-    }
-    paranoia_modeset(reader, flags);
+    paranoia_modeset(reader, paranoia_flags_for_mode(mode));
     out_reader = reader;
     return true;
 };
@@ -217,7 +259,9 @@ auto live_seek_reader = [](
 
 auto live_read_sector = [](
     void* reader,
+    int max_retries,
     const int16_t*& out_buffer,
+    CdRipReadStats& stats,
     std::string& err) {
 
     err.clear();
@@ -226,7 +270,11 @@ auto live_read_sector = [](
         err = "Reader handle is null";
         return false;
     }
-    out_buffer = paranoia_read(static_cast<cdrom_paranoia*>(reader), nullptr);
+    t_read_stats = &stats;
+    out_buffer = max_retries > 0
+        ? paranoia_read_limited(static_cast<cdrom_paranoia*>(reader), paranoia_event_callback, max_retries)
+        : paranoia_read(static_cast<cdrom_paranoia*>(reader), paranoia_event_callback);
+    t_read_stats = nullptr;
     if (!out_buffer) {
         err = "Failed to read audio sector";
         return false;
@@ -234,6 +282,20 @@ auto live_read_sector = [](
     return true;
 };
 
+auto live_set_reader_mode = [](
+    void* reader,
+    CdRipRipModes mode,
+    std::string& err) {
+
+    err.clear();
+    if (!reader) {
+        err = "Reader handle is null";
+        return false;
+    }
+    paranoia_modeset(static_cast<cdrom_paranoia*>(reader), paranoia_flags_for_mode(mode));
+    return true;
+};
+
 const DriveBackend kLiveDriveBackend{
     live_detect_drives,
     live_open_drive,
@@ -247,6 +309,7 @@ const DriveBackend kLiveDriveBackend{
     live_get_disc_last_sector,
     live_seek_reader,
     live_read_sector,
+    live_set_reader_mode,
 };
 
 const DriveBackend* g_override_drive_backend = nullptr;
@@ -269,4 +332,10 @@ void reset_drive_backend_for_tests() {
     g_override_drive_backend = nullptr;
 }
 
+const DriveBackend& drive_backend_for_device(
+    const std::string& device) {
+
+    return is_image_device(device) ? image_drive_backend() : current_drive_backend();
+}
+
 }  // namespace cdrip::detail
@@ -26,7 +26,9 @@ CdRip* cdrip_open(
     const std::string format = settings && settings->format
         ? settings->format : std::string{};
     const int compression_level = settings ? settings->compression_level : -1;
-    const DriveBackend& backend = current_drive_backend();
+    const int encoder_threads = settings ? settings->encoder_threads : 0;
+    const int read_offset = settings ? settings->read_offset : 0;
+    const DriveBackend& backend = drive_backend_for_device(device_str);
     void* raw = nullptr;
     std::string backend_err;
     if (!backend.open_drive(device_str, raw, backend_err)) {
@@ -48,7 +50,7 @@ CdRip* cdrip_open(
         set_error(error, backend_err);
         return nullptr;
     }
-    return new CdRip{&backend, raw, reader, effective_mode, device_str, format, compression_level, speed_fast};
+    return new CdRip{&backend, raw, reader, effective_mode, device_str, format, compression_level, speed_fast, encoder_threads, read_offset};
 }
 
 void cdrip_close(
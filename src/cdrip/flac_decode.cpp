@@ -0,0 +1,208 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <FLAC/stream_decoder.h>
+#include <gio/gio.h>
+#include <glib.h>
+
+#include "internal.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+// Files are pulled in large sequential chunks; libFLAC itself asks for a few KiB at a time.
+constexpr size_t kDecodeReadChunkBytes = 1024 * 1024;
+
+struct FlacDecodeState {
+    GInputStream* input{nullptr};
+    std::vector<FLAC__byte> chunk;
+    size_t chunk_pos{0};
+    size_t chunk_len{0};
+    bool eof{false};
+    const FlacPcmSink* sink{nullptr};
+    FlacDecodeResult* out{nullptr};
+    std::vector<FLAC__int32> interleaved;
+    std::string error;
+};
+
+static FLAC__StreamDecoderReadStatus decode_read_cb(
+    const FLAC__StreamDecoder* /*decoder*/,
+    FLAC__byte buffer[],
+    size_t* bytes,
+    void* client_data) {
+
+    auto* state = static_cast<FlacDecodeState*>(client_data);
+    const size_t wanted = *bytes;
+    size_t copied = 0;
+    while (copied < wanted) {
+        if (state->chunk_pos == state->chunk_len) {
+            if (state->eof) break;
+            gsize read = 0;
+            GError* gerr = nullptr;
+            if (!g_input_stream_read_all(
+                    state->input, state->chunk.data(), state->chunk.size(), &read, nullptr, &gerr)) {
+                state->error = std::string("Read failed: ") + (gerr && gerr->message ? gerr->message : "unknown error");
+                if (gerr) g_error_free(gerr);
+                *bytes = 0;
+                return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+            }
+            state->chunk_pos = 0;
+            state->chunk_len = read;
+            if (read < state->chunk.size()) state->eof = true;
+            if (read == 0) break;
+        }
+        const size_t n = std::min(wanted - copied, state->chunk_len - state->chunk_pos);
+        std::memcpy(buffer + copied, state->chunk.data() + state->chunk_pos, n);
+        state->chunk_pos += n;
+        copied += n;
+    }
+    *bytes = copied;
+    return copied == 0
+        ? FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM
+        : FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+}
+
+static FLAC__StreamDecoderWriteStatus decode_write_cb(
+    const FLAC__StreamDecoder* /*decoder*/,
+    const FLAC__Frame* frame,
+    const FLAC__int32* const buffer[],
+    void* client_data) {
+
+    auto* state = static_cast<FlacDecodeState*>(client_data);
+    const unsigned channels = frame->header.channels;
+    const size_t frames = frame->header.blocksize;
+    state->out->decoded_samples += frames;
+    if (!state->sink || !*state->sink) {
+        return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    }
+
+    state->interleaved.resize(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        for (unsigned ch = 0; ch < channels; ++ch) {
+            state->interleaved[i * channels + ch] = buffer[ch][i];
+        }
+    }
+    if (!(*state->sink)(state->interleaved.data(), frames, channels, frame->header.bits_per_sample)) {
+        if (state->error.empty()) state->error = "Decoding aborted";
+        return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+    }
+    return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+}
+
+static void decode_metadata_cb(
+    const FLAC__StreamDecoder* /*decoder*/,
+    const FLAC__StreamMetadata* metadata,
+    void* client_data) {
+
+    auto* state = static_cast<FlacDecodeState*>(client_data);
+    if (!metadata || metadata->type != FLAC__METADATA_TYPE_STREAMINFO) return;
+    const auto& info = metadata->data.stream_info;
+    state->out->sample_rate = info.sample_rate;
+    state->out->channels = info.channels;
+    state->out->bits_per_sample = info.bits_per_sample;
+    state->out->total_samples = info.total_samples;
+    // An all-zero signature means the encoder did not compute one.
+    state->out->has_md5 = std::any_of(
+        std::begin(info.md5sum), std::end(info.md5sum), [](FLAC__byte b) { return b != 0; });
+    std::memcpy(state->out->md5, info.md5sum, sizeof(state->out->md5));
+}
+
+static void decode_error_cb(
+    const FLAC__StreamDecoder* /*decoder*/,
+    FLAC__StreamDecoderErrorStatus status,
+    void* client_data) {
+
+    auto* state = static_cast<FlacDecodeState*>(client_data);
+    if (state->error.empty()) {
+        state->error = std::string("Decode error: ") + FLAC__StreamDecoderErrorStatusString[status];
+    }
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+bool decode_flac_file(
+    const std::string& path,
+    bool check_md5,
+    const FlacPcmSink& sink,
+    FlacDecodeResult& out,
+    std::string& err) {
+
+    err.clear();
+    out = FlacDecodeResult{};
+
+    GFile* file = is_uri(path)
+        ? g_file_new_for_uri(path.c_str())
+        : g_file_new_for_path(path.c_str());
+    GError* gerr = nullptr;
+    GFileInputStream* in = g_file_read(file, nullptr, &gerr);
+    g_object_unref(file);
+    if (!in) {
+        err = "Failed to open FLAC file: " + path;
+        if (gerr && gerr->message) err += std::string(": ") + gerr->message;
+        if (gerr) g_error_free(gerr);
+        return false;
+    }
+
+    FlacDecodeState state{};
+    state.input = G_INPUT_STREAM(in);
+    state.chunk.resize(kDecodeReadChunkBytes);
+    state.sink = &sink;
+    state.out = &out;
+
+    FLAC__StreamDecoder* decoder = FLAC__stream_decoder_new();
+    if (!decoder) {
+        g_object_unref(in);
+        err = "Failed to create FLAC decoder";
+        return false;
+    }
+    FLAC__stream_decoder_set_md5_checking(decoder, check_md5);
+    const FLAC__StreamDecoderInitStatus init_status = FLAC__stream_decoder_init_stream(
+        decoder,
+        decode_read_cb,
+        nullptr,
+        nullptr,
+        nullptr,
+        nullptr,
+        decode_write_cb,
+        decode_metadata_cb,
+        decode_error_cb,
+        &state);
+    if (init_status != FLAC__STREAM_DECODER_INIT_STATUS_OK) {
+        FLAC__stream_decoder_delete(decoder);
+        g_object_unref(in);
+        err = std::string("Failed to initialize FLAC decoder: ") + FLAC__StreamDecoderInitStatusString[init_status];
+        return false;
+    }
+
+    const bool processed = FLAC__stream_decoder_process_until_end_of_stream(decoder);
+    // finish() reports the MD5 comparison, so it runs even after a failed decode.
+    const bool md5_matched = FLAC__stream_decoder_finish(decoder);
+    FLAC__stream_decoder_delete(decoder);
+    g_input_stream_close(G_INPUT_STREAM(in), nullptr, nullptr);
+    g_object_unref(in);
+
+    if (!processed || !state.error.empty()) {
+        err = state.error.empty() ? "Failed to decode FLAC file: " + path : state.error + ": " + path;
+        return false;
+    }
+    if (out.total_samples > 0 && out.decoded_samples != out.total_samples) {
+        err = "Truncated FLAC stream (" + std::to_string(out.decoded_samples) + " of " +
+            std::to_string(out.total_samples) + " samples): " + path;
+        return false;
+    }
+    out.md5_checked = check_md5 && out.has_md5;
+    out.md5_ok = out.md5_checked && md5_matched;
+    return true;
+}
+
+}  // namespace cdrip::detail
@@ -0,0 +1,257 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+#include <gio/gio.h>
+#include <glib.h>
+
+#include "internal.h"
+
+using namespace cdrip::detail;
+
+namespace cdrip::detail {
+
+// GIO objects behind a metadata chain read from (and written back to) a URI.
+struct FlacGioStreams {
+    GFile* file{nullptr};
+    GFileIOStream* io{nullptr};
+    GFileInputStream* in{nullptr};
+    GFileOutputStream* out{nullptr};
+    GInputStream* input{nullptr};
+    GOutputStream* output{nullptr};
+    GSeekable* seekable{nullptr};
+    bool eof{false};
+    bool failed{false};
+
+    ~FlacGioStreams() {
+        if (io) {
+            g_io_stream_close(G_IO_STREAM(io), nullptr, nullptr);
+            g_object_unref(io);
+        }
+        if (in) {
+            g_input_stream_close(G_INPUT_STREAM(in), nullptr, nullptr);
+            g_object_unref(in);
+        }
+        if (out) {
+            g_output_stream_close(G_OUTPUT_STREAM(out), nullptr, nullptr);
+            g_object_unref(out);
+        }
+        if (file) g_object_unref(file);
+    }
+};
+
+}  // namespace cdrip::detail
+
+namespace {
+
+static size_t gio_flac_read(
+    void* ptr,
+    size_t size,
+    size_t nmemb,
+    FLAC__IOHandle handle) {
+
+    auto* streams = static_cast<FlacGioStreams*>(handle);
+    if (!streams->input || size == 0) return 0;
+    gsize bytes_read = 0;
+    if (!g_input_stream_read_all(streams->input, ptr, size * nmemb, &bytes_read, nullptr, nullptr)) {
+        streams->failed = true;
+        return 0;
+    }
+    if (bytes_read < size * nmemb) streams->eof = true;
+    return bytes_read / size;
+}
+
+static size_t gio_flac_write(
+    const void* ptr,
+    size_t size,
+    size_t nmemb,
+    FLAC__IOHandle handle) {
+
+    auto* streams = static_cast<FlacGioStreams*>(handle);
+    if (!streams->output || size == 0) return 0;
+    gsize bytes_written = 0;
+    if (!g_output_stream_write_all(streams->output, ptr, size * nmemb, &bytes_written, nullptr, nullptr)) {
+        streams->failed = true;
+    }
+    return bytes_written / size;
+}
+
+static int gio_flac_seek(
+    FLAC__IOHandle handle,
+    FLAC__int64 offset,
+    int whence) {
+
+    auto* streams = static_cast<FlacGioStreams*>(handle);
+    if (!streams->seekable) return -1;
+    GSeekType type = G_SEEK_SET;
+    if (whence == SEEK_CUR) type = G_SEEK_CUR;
+    if (whence == SEEK_END) type = G_SEEK_END;
+    if (!g_seekable_seek(streams->seekable, static_cast<goffset>(offset), type, nullptr, nullptr)) {
+        return -1;
+    }
+    streams->eof = false;
+    return 0;
+}
+
+static FLAC__int64 gio_flac_tell(
+    FLAC__IOHandle handle) {
+
+    auto* streams = static_cast<FlacGioStreams*>(handle);
+    if (!streams->seekable) return -1;
+    return static_cast<FLAC__int64>(g_seekable_tell(streams->seekable));
+}
+
+static int gio_flac_eof(
+    FLAC__IOHandle handle) {
+
+    return static_cast<FlacGioStreams*>(handle)->eof ? 1 : 0;
+}
+
+static FLAC__IOCallbacks gio_flac_callbacks() {
+    FLAC__IOCallbacks callbacks{};
+    callbacks.read = &gio_flac_read;
+    callbacks.write = &gio_flac_write;
+    callbacks.seek = &gio_flac_seek;
+    callbacks.tell = &gio_flac_tell;
+    callbacks.eof = &gio_flac_eof;
+    callbacks.close = nullptr;  // Streams are owned by FlacGioStreams.
+    return callbacks;
+}
+
+static std::string gio_error_message(
+    GError* gerr) {
+
+    return (gerr && gerr->message) ? gerr->message : "unknown";
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+FlacMetadataFile::FlacMetadataFile() = default;
+
+FlacMetadataFile::~FlacMetadataFile() {
+    if (chain_) FLAC__metadata_chain_delete(chain_);
+}
+
+bool FlacMetadataFile::open(
+    const std::string& path,
+    bool writable,
+    std::string& err) {
+
+    err.clear();
+    path_ = path;
+    chain_ = FLAC__metadata_chain_new();
+    if (!chain_) {
+        err = "Failed to create FLAC metadata chain";
+        return false;
+    }
+    if (!is_uri(path)) {
+        if (!FLAC__metadata_chain_read(chain_, path.c_str())) {
+            err = "Failed to read FLAC metadata: " + path;
+            return false;
+        }
+        return true;
+    }
+
+    // Remote file: libFLAC seeks over the stream and only reads the metadata blocks.
+    gio_ = std::make_unique<FlacGioStreams>();
+    gio_->file = g_file_new_for_uri(path.c_str());
+    GError* gerr = nullptr;
+    if (writable) {
+        gio_->io = g_file_open_readwrite(gio_->file, nullptr, &gerr);
+        if (gio_->io) {
+            gio_->input = g_io_stream_get_input_stream(G_IO_STREAM(gio_->io));
+            gio_->output = g_io_stream_get_output_stream(G_IO_STREAM(gio_->io));
+            gio_->seekable = G_SEEKABLE(gio_->io);
+        }
+        // Backends without read/write streams still allow a full rewrite.
+        g_clear_error(&gerr);
+    }
+    if (!gio_->io) {
+        gio_->in = g_file_read(gio_->file, nullptr, &gerr);
+        if (!gio_->in) {
+            err = "Failed to open " + path + ": " + gio_error_message(gerr);
+            g_clear_error(&gerr);
+            return false;
+        }
+        gio_->input = G_INPUT_STREAM(gio_->in);
+        gio_->seekable = G_SEEKABLE(gio_->in);
+    }
+    if (!FLAC__metadata_chain_read_with_callbacks(chain_, gio_.get(), gio_flac_callbacks())) {
+        err = "Failed to read FLAC metadata: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool FlacMetadataFile::write(
+    std::string& err) {
+
+    err.clear();
+    if (!chain_) {
+        err = "FLAC metadata is not open";
+        return false;
+    }
+    if (!gio_) {
+        if (!FLAC__metadata_chain_write(chain_, true, true)) {
+            err = "Failed to write FLAC metadata";
+            return false;
+        }
+        return true;
+    }
+
+    // In place when the new blocks fit the existing metadata region (padding).
+    if (gio_->output && !FLAC__metadata_chain_check_if_tempfile_needed(chain_, true)) {
+        if (!FLAC__metadata_chain_write_with_callbacks(chain_, true, gio_.get(), gio_flac_callbacks()) ||
+            gio_->failed ||
+            !g_output_stream_flush(gio_->output, nullptr, nullptr)) {
+            err = "Failed to write FLAC metadata: " + path_;
+            return false;
+        }
+        return true;
+    }
+
+    // Metadata grew past the padding: rebuild the file locally, then replace the remote copy.
+    GError* gerr = nullptr;
+    gchar* temp_path_c = nullptr;
+    const int temp_fd = g_file_open_tmp("cdripXXXXXX.flac", &temp_path_c, &gerr);
+    if (temp_fd == -1) {
+        err = "Failed to create temporary file: " + gio_error_message(gerr);
+        g_clear_error(&gerr);
+        return false;
+    }
+    close(temp_fd);
+    const std::string temp_path = temp_path_c ? temp_path_c : "";
+    g_free(temp_path_c);
+
+    bool ok = false;
+    {
+        FlacGioStreams temp{};
+        temp.file = g_file_new_for_path(temp_path.c_str());
+        temp.out = g_file_replace(temp.file, nullptr, FALSE, G_FILE_CREATE_NONE, nullptr, &gerr);
+        if (!temp.out) {
+            err = "Failed to open temporary file: " + gio_error_message(gerr);
+            g_clear_error(&gerr);
+        } else {
+            temp.output = G_OUTPUT_STREAM(temp.out);
+            ok = FLAC__metadata_chain_write_with_callbacks_and_tempfile(
+                     chain_, true, gio_.get(), gio_flac_callbacks(), &temp, gio_flac_callbacks()) &&
+                 !temp.failed && !gio_->failed;
+            if (!ok) err = "Failed to rewrite FLAC file: " + path_;
+        }
+    }
+    // Release the remote handle before replacing the file behind it.
+    gio_.reset();
+    if (ok) ok = publish_local_file_to_destination(temp_path, path_, err);
+    std::remove(temp_path.c_str());
+    return ok;
+}
+
+}  // namespace cdrip::detail
@@ -3,15 +3,25 @@
 // Under MIT.
 // https://github.com/kekyo/scheme-cd-ripper
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <filesystem>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include <cdio/cdio.h>
 #include <cdio/cd_types.h>
+#include <gio/gio.h>
 
 #include "internal.h"
 
@@ -20,6 +30,27 @@ using namespace cdrip::detail;
 /* ------------------------------------------------------------------- */
 /* Use static linkage for file local definitions */
 
+// Upper bound of threads walking directories and reading tags on a cold scan.
+static constexpr size_t kMaxScanThreads = 8;
+
+// Vorbis comments needed to rebuild a TOC; only these are kept in the scan index.
+static const char* const kScanTagKeys[] = {
+    "CDDB_DISCID",
+    "CDDB_OFFSETS",
+    "CDDB_TOTAL_SECONDS",
+    "TRACKTOTAL",
+    "TRACKNUMBER",
+    "MUSICBRAINZ_RELEASE",
+    "MUSICBRAINZ_MEDIUM",
+    "MUSICBRAINZ_DISCID",
+    "MUSICBRAINZ_LEADOUT",
+};
+
+static size_t scan_thread_count() {
+    const unsigned int hw = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(hw == 0 ? 2 : hw, 1, kMaxScanThreads);
+}
+
 static bool is_flac_file(
     const std::filesystem::path& path) {
 
@@ -27,18 +58,10 @@ static bool is_flac_file(
     return ext == ".flac";
 }
 
-static bool collect_vorbis_comments(
-    const std::string& path,
+static void vorbis_block_to_map(
+    const FLAC__StreamMetadata* tags,
     std::map<std::string, std::string>& out) {
 
-    FLAC__StreamMetadata* tags = nullptr;
-    if (!FLAC__metadata_get_tags(path.c_str(), &tags)) {
-        return false;
-    }
-    if (!tags || tags->type != FLAC__METADATA_TYPE_VORBIS_COMMENT) {
-        if (tags) FLAC__metadata_object_delete(tags);
-        return false;
-    }
     const auto& vc = tags->data.vorbis_comment;
     for (uint32_t i = 0; i < vc.num_comments; ++i) {
         const auto& entry = vc.comments[i];
@@ -53,10 +76,128 @@ static bool collect_vorbis_comments(
         if (name) free(name);
         if (value) free(value);
     }
+}
+
+static const FLAC__StreamMetadata* find_vorbis_block(
+    FLAC__Metadata_Chain* chain) {
+
+    const FLAC__StreamMetadata* found = nullptr;
+    FLAC__Metadata_Iterator* it = FLAC__metadata_iterator_new();
+    if (!it) return nullptr;
+    FLAC__metadata_iterator_init(it, chain);
+    do {
+        const FLAC__StreamMetadata* block = FLAC__metadata_iterator_get_block(it);
+        if (block && block->type == FLAC__METADATA_TYPE_VORBIS_COMMENT) {
+            found = block;
+            break;
+        }
+    } while (FLAC__metadata_iterator_next(it));
+    FLAC__metadata_iterator_delete(it);
+    return found;
+}
+
+static bool collect_vorbis_comments(
+    const std::string& path,
+    std::map<std::string, std::string>& out) {
+
+    if (is_uri(path)) {
+        FlacMetadataFile file;
+        std::string err;
+        if (!file.open(path, /*writable=*/false, err)) return false;
+        const FLAC__StreamMetadata* tags = find_vorbis_block(file.chain());
+        if (!tags) return false;
+        vorbis_block_to_map(tags, out);
+        return true;
+    }
+
+    FLAC__StreamMetadata* tags = nullptr;
+    if (!FLAC__metadata_get_tags(path.c_str(), &tags)) {
+        return false;
+    }
+    if (!tags || tags->type != FLAC__METADATA_TYPE_VORBIS_COMMENT) {
+        if (tags) FLAC__metadata_object_delete(tags);
+        return false;
+    }
+    vorbis_block_to_map(tags, out);
     FLAC__metadata_object_delete(tags);
     return true;
 }
 
+// Set tags on the existing Vorbis comment block, keeping every other comment as is.
+static bool merge_flac_tags(
+    const std::string& path,
+    const std::map<std::string, std::string>& tags,
+    std::string& err,
+    bool dry_run,
+    bool* out_changed) {
+
+    FlacMetadataFile file;
+    if (!file.open(path, /*writable=*/!dry_run, err)) {
+        return false;
+    }
+    FLAC__Metadata_Iterator* it = FLAC__metadata_iterator_new();
+    if (!it) {
+        err = "Failed to create FLAC metadata iterator";
+        return false;
+    }
+    FLAC__StreamMetadata* vorbis = nullptr;
+    FLAC__metadata_iterator_init(it, file.chain());
+    do {
+        FLAC__StreamMetadata* block = FLAC__metadata_iterator_get_block(it);
+        if (block && block->type == FLAC__METADATA_TYPE_VORBIS_COMMENT) {
+            vorbis = block;
+            break;
+        }
+    } while (FLAC__metadata_iterator_next(it));
+
+    std::map<std::string, std::string> existing;
+    if (vorbis) vorbis_block_to_map(vorbis, existing);
+    bool changed = false;
+    for (const auto& [key, value] : tags) {
+        if (key.empty() || value.empty()) continue;
+        const auto found = existing.find(to_upper(key));
+        if (found == existing.end() || found->second != value) {
+            changed = true;
+            break;
+        }
+    }
+    if (out_changed) *out_changed = changed;
+    if (!changed || dry_run) {
+        FLAC__metadata_iterator_delete(it);
+        return true;
+    }
+
+    if (!vorbis) {
+        vorbis = FLAC__metadata_object_new(FLAC__METADATA_TYPE_VORBIS_COMMENT);
+        while (FLAC__metadata_iterator_next(it)) {
+        }
+        if (!vorbis || !FLAC__metadata_iterator_insert_block_after(it, vorbis)) {
+            if (vorbis) FLAC__metadata_object_delete(vorbis);
+            FLAC__metadata_iterator_delete(it);
+            err = "Failed to insert Vorbis comment block";
+            return false;
+        }
+    }
+    FLAC__metadata_iterator_delete(it);
+
+    for (const auto& [key, value] : tags) {
+        if (key.empty() || value.empty()) continue;
+        FLAC__StreamMetadata_VorbisComment_Entry entry{};
+        if (!FLAC__metadata_object_vorbiscomment_entry_from_name_value_pair(
+                &entry, to_upper(key).c_str(), value.c_str())) {
+            err = "Failed to build Vorbis comment: " + key;
+            return false;
+        }
+        // The block takes ownership of the entry on success.
+        if (!FLAC__metadata_object_vorbiscomment_replace_comment(vorbis, entry, /*all=*/true, /*copy=*/false)) {
+            free(entry.entry);
+            err = "Failed to set Vorbis comment: " + key;
+            return false;
+        }
+    }
+    return file.write(err);
+}
+
 static std::vector<long> parse_offsets(
     const std::string& value,
     bool& ok) {
@@ -90,6 +231,36 @@ static std::vector<long> parse_offsets(
     return offsets;
 }
 
+static bool vorbis_comments_equal(
+    const FLAC__StreamMetadata* lhs,
+    const FLAC__StreamMetadata* rhs) {
+
+    const auto& a = lhs->data.vorbis_comment;
+    const auto& b = rhs->data.vorbis_comment;
+    if (a.num_comments != b.num_comments) return false;
+    for (uint32_t i = 0; i < a.num_comments; ++i) {
+        const auto& ea = a.comments[i];
+        const auto& eb = b.comments[i];
+        if (ea.length != eb.length) return false;
+        if (ea.length > 0 && std::memcmp(ea.entry, eb.entry, ea.length) != 0) return false;
+    }
+    return true;
+}
+
+static bool picture_blocks_equal(
+    const FLAC__StreamMetadata* lhs,
+    const FLAC__StreamMetadata* rhs) {
+
+    const auto& a = lhs->data.picture;
+    const auto& b = rhs->data.picture;
+    if (a.type != b.type || a.data_length != b.data_length) return false;
+    if (std::strcmp(a.mime_type ? a.mime_type : "", b.mime_type ? b.mime_type : "") != 0) return false;
+    const char* da = reinterpret_cast<const char*>(a.description);
+    const char* db = reinterpret_cast<const char*>(b.description);
+    if (std::strcmp(da ? da : "", db ? db : "") != 0) return false;
+    return a.data_length == 0 || std::memcmp(a.data, b.data, a.data_length) == 0;
+}
+
 static void set_invalid_tagged_toc(
     CdRipTaggedToc& item,
     const std::string& path,
@@ -103,11 +274,279 @@ static void set_invalid_tagged_toc(
     item.reason = make_cstr_copy(reason);
 }
 
+enum class ScanPathType {
+    Missing,
+    Directory,
+    File,
+};
+
+static ScanPathType query_scan_path_type(
+    const std::string& path) {
+
+    if (!is_uri(path)) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(path, ec)) return ScanPathType::Directory;
+        if (std::filesystem::is_regular_file(path, ec)) return ScanPathType::File;
+        return ScanPathType::Missing;
+    }
+    GFile* file = g_file_new_for_uri(path.c_str());
+    GFileInfo* info = g_file_query_info(
+        file, G_FILE_ATTRIBUTE_STANDARD_TYPE, G_FILE_QUERY_INFO_NONE, nullptr, nullptr);
+    ScanPathType type = ScanPathType::Missing;
+    if (info) {
+        const GFileType file_type = g_file_info_get_file_type(info);
+        if (file_type == G_FILE_TYPE_DIRECTORY) type = ScanPathType::Directory;
+        if (file_type == G_FILE_TYPE_REGULAR) type = ScanPathType::File;
+        g_object_unref(info);
+    }
+    g_object_unref(file);
+    return type;
+}
+
+// List one directory level of a local path or GIO URI.
+static void list_scan_directory(
+    const std::string& dir,
+    std::vector<std::string>& files,
+    std::vector<std::string>& subdirs) {
+
+    if (!is_uri(dir)) {
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code entry_ec;
+            // Like recursive_directory_iterator, do not follow directory symlinks.
+            if (it->is_symlink(entry_ec) && it->is_directory(entry_ec)) continue;
+            if (it->is_directory(entry_ec)) {
+                subdirs.push_back(it->path().string());
+            } else if (it->is_regular_file(entry_ec) && is_flac_file(it->path())) {
+                files.push_back(it->path().string());
+            }
+        }
+        return;
+    }
+
+    GFile* dir_file = g_file_new_for_uri(dir.c_str());
+    GFileEnumerator* enumerator = g_file_enumerate_children(
+        dir_file,
+        G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_TYPE,
+        G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+        nullptr,
+        nullptr);
+    if (enumerator) {
+        while (GFileInfo* info = g_file_enumerator_next_file(enumerator, nullptr, nullptr)) {
+            const GFileType type = g_file_info_get_file_type(info);
+            const std::string name = to_string_or_empty(g_file_info_get_name(info));
+            if (type == G_FILE_TYPE_DIRECTORY ||
+                (type == G_FILE_TYPE_REGULAR && is_flac_file(std::filesystem::path(name)))) {
+                GFile* child = g_file_get_child(dir_file, name.c_str());
+                char* child_uri = g_file_get_uri(child);
+                if (child_uri) {
+                    (type == G_FILE_TYPE_DIRECTORY ? subdirs : files).push_back(child_uri);
+                    g_free(child_uri);
+                }
+                g_object_unref(child);
+            }
+            g_object_unref(info);
+        }
+        g_file_enumerator_close(enumerator, nullptr, nullptr);
+        g_object_unref(enumerator);
+    }
+    g_object_unref(dir_file);
+}
+
+// Walk directories breadth-first on several threads; slow (network) mounts are
+// dominated by per-directory latency, not CPU.
+static void collect_flac_files_parallel(
+    const std::string& root,
+    std::vector<std::string>& out) {
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> pending{root};
+    size_t active = 0;
+
+    auto worker = [&]() {
+        std::vector<std::string> found;
+        while (true) {
+            std::string dir;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return !pending.empty() || active == 0; });
+                if (pending.empty()) break;
+                dir = std::move(pending.front());
+                pending.pop_front();
+                ++active;
+            }
+            std::vector<std::string> subdirs;
+            list_scan_directory(dir, found, subdirs);
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                for (auto& sub : subdirs) pending.push_back(std::move(sub));
+                --active;
+            }
+            cv.notify_all();
+        }
+        std::lock_guard<std::mutex> guard(mutex);
+        out.insert(out.end(), found.begin(), found.end());
+    };
+
+    std::vector<std::thread> threads;
+    const size_t count = scan_thread_count();
+    for (size_t i = 0; i < count; ++i) threads.emplace_back(worker);
+    for (auto& thread : threads) thread.join();
+    std::sort(out.begin(), out.end());
+}
+
+static std::map<std::string, std::string> pick_scan_tags(
+    const std::map<std::string, std::string>& tags) {
+
+    std::map<std::string, std::string> picked;
+    for (const char* key : kScanTagKeys) {
+        const auto it = tags.find(key);
+        if (it != tags.end()) picked.emplace(key, it->second);
+    }
+    return picked;
+}
+
+static CdRipTaggedToc build_tagged_toc(
+    const std::string& path_str,
+    const std::map<std::string, std::string>& tags) {
+
+    CdRipTaggedToc item{};
+    auto get_tag = [&](const std::string& key) -> std::string {
+        const auto it = tags.find(to_upper(key));
+        return it != tags.end() ? trim(it->second) : std::string{};
+    };
+
+    const std::string cddb_discid = get_tag("CDDB_DISCID");
+    const std::string offsets_raw = get_tag("CDDB_OFFSETS");
+    const std::string total_sec_raw = get_tag("CDDB_TOTAL_SECONDS");
+    const std::string tracktotal_raw = get_tag("TRACKTOTAL");
+    const std::string tracknumber_raw = get_tag("TRACKNUMBER");
+    const std::string mb_release_id = get_tag("MUSICBRAINZ_RELEASE");
+    const std::string mb_medium_id = get_tag("MUSICBRAINZ_MEDIUM");
+    const std::string mb_discid_tag = get_tag("MUSICBRAINZ_DISCID");
+    const std::string mb_leadout_tag = get_tag("MUSICBRAINZ_LEADOUT");
+    const bool has_mb_leadout_tag = !mb_leadout_tag.empty();
+
+    int track_total = 0;
+    parse_int(tracktotal_raw, track_total);
+    int track_number = 0;
+    parse_int(tracknumber_raw, track_number);
+    int total_seconds = 0;
+    parse_int(total_sec_raw, total_seconds);
+    bool offsets_ok = false;
+    std::vector<long> offsets = parse_offsets(offsets_raw, offsets_ok);
+
+    if (!offsets_ok) {
+        set_invalid_tagged_toc(item, path_str, "Invalid CDDB_OFFSETS", track_number);
+        return item;
+    }
+    if (track_total == 0) {
+        track_total = static_cast<int>(offsets.size());
+    }
+    if (cddb_discid.empty() || offsets.empty() || total_seconds <= 0 || track_total <= 0) {
+        set_invalid_tagged_toc(item, path_str, "Missing CDDB tags", track_number);
+        return item;
+    }
+    if (static_cast<size_t>(track_total) != offsets.size()) {
+        set_invalid_tagged_toc(item, path_str, "Offsets count mismatch with track total", track_number);
+        return item;
+    }
+
+    long disc_frames = static_cast<long>(total_seconds) * CDIO_CD_FRAMES_PER_SEC;
+    if (disc_frames <= 0) {
+        set_invalid_tagged_toc(item, path_str, "Invalid disc length", track_number);
+        return item;
+    }
+
+    bool offsets_sorted = true;
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        if (offsets[i] <= offsets[i - 1]) {
+            offsets_sorted = false;
+            break;
+        }
+    }
+    if (!offsets_sorted) {
+        set_invalid_tagged_toc(item, path_str, "Offsets are not strictly increasing", track_number);
+        return item;
+    }
+
+    CdRipDiscToc* toc = new CdRipDiscToc{};
+    toc->cddb_discid = make_cstr_copy(cddb_discid);
+    if (!mb_release_id.empty()) {
+        toc->mb_release_id = make_cstr_copy(mb_release_id);
+    }
+    if (!mb_medium_id.empty()) {
+        toc->mb_medium_id = make_cstr_copy(mb_medium_id);
+    }
+    if (!mb_discid_tag.empty()) {
+        toc->mb_discid = make_cstr_copy(mb_discid_tag);
+    }
+    if (!mb_leadout_tag.empty()) {
+        long mb_leadout = 0;
+        if (parse_long(mb_leadout_tag, mb_leadout) && mb_leadout > 150) {
+            toc->leadout_sector = mb_leadout - 150;
+        }
+    }
+
+    if (toc->leadout_sector <= 0) {
+        toc->leadout_sector = disc_frames;
+    }
+    toc->length_seconds = total_seconds;
+    toc->tracks_count = offsets.size();
+    toc->tracks = new CdRipTrackInfo[toc->tracks_count]{};
+    bool length_ok = true;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        CdRipTrackInfo info{};
+        info.number = static_cast<int>(i + 1);
+        info.start = offsets[i];
+        const long end = (i + 1 < offsets.size())
+            ? offsets[i + 1] - 1
+            : disc_frames - 1;
+        if (end < info.start) {
+            length_ok = false;
+            break;
+        }
+        info.end = end;
+        info.is_audio = 1;
+        toc->tracks[i] = info;
+    }
+    if (!length_ok) {
+        cdrip_release_disctoc(toc);
+        set_invalid_tagged_toc(item, path_str, "Offsets length inconsistency", track_number);
+        return item;
+    }
+
+    // Compute MusicBrainz disc id from reconstructed TOC for later queries.
+    if (!toc->mb_discid && has_mb_leadout_tag) {
+        std::string mb_discid;
+        long mb_leadout = 0;
+        if (compute_musicbrainz_discid(toc, mb_discid, mb_leadout)) {
+            toc->mb_discid = make_cstr_copy(mb_discid);
+        }
+    }
+
+    item.path = make_cstr_copy(path_str);
+    item.toc = toc;
+    item.track_number = track_number;
+    item.valid = 1;
+    item.reason = nullptr;
+    return item;
+}
+
 /* ------------------------------------------------------------------- */
 /* Exported API functions */
 
 namespace cdrip::detail {
 
+bool read_flac_vorbis_tags(
+    const std::string& path,
+    std::map<std::string, std::string>& out) {
+
+    out.clear();
+    return collect_vorbis_comments(path, out);
+}
+
 bool update_flac_tags(
     const std::string& path,
     const CdRipDiscToc* toc,
@@ -115,9 +554,15 @@ bool update_flac_tags(
     const CdRipCddbEntry* entry,
     const std::map<std::string, std::string>& extra_tags,
     bool preserve_replaygain_tags,
-    std::string& err) {
+    std::string& err,
+    bool dry_run,
+    bool* out_changed) {
 
     err.clear();
+    if (out_changed) *out_changed = false;
+    if (!entry && !path.empty()) {
+        return merge_flac_tags(path, extra_tags, err, dry_run, out_changed);
+    }
     if (!toc || !entry || path.empty()) {
         err = "Invalid arguments to update_flac_tags";
         return false;
@@ -148,14 +593,23 @@ bool update_flac_tags(
         track_name,
         safe_title);
 
-    if (preserve_replaygain_tags) {
-        std::map<std::string, std::string> existing_tags;
-        if (collect_vorbis_comments(path, existing_tags)) {
-            for (const auto& [key, value] : existing_tags) {
-                const std::string key_upper = to_upper(key);
-                if (is_replaygain_tag_key(key_upper) && !value.empty()) {
-                    tags[key_upper] = value;
-                }
+    // One metadata read serves both the ReplayGain carry-over and the rewrite.
+    FlacMetadataFile file;
+    if (!file.open(path, /*writable=*/!dry_run, err)) {
+        return false;
+    }
+    FLAC__Metadata_Chain* chain = file.chain();
+
+    // Tags measured from the audio survive a metadata refresh; ReplayGain only on request.
+    std::map<std::string, std::string> existing_tags;
+    if (const FLAC__StreamMetadata* existing = find_vorbis_block(chain)) {
+        vorbis_block_to_map(existing, existing_tags);
+        for (const auto& [key, value] : existing_tags) {
+            const std::string key_upper = to_upper(key);
+            if (value.empty()) continue;
+            if (is_measured_tag_key(key_upper) ||
+                (preserve_replaygain_tags && is_replaygain_tag_key(key_upper))) {
+                tags[key_upper] = value;
             }
         }
     }
@@ -169,22 +623,56 @@ bool update_flac_tags(
     drop_format_only_tags(tags);
 
     const bool replace_picture = has_cover_art_data(entry->cover_art);
-    FLAC__Metadata_Chain* chain = FLAC__metadata_chain_new();
-    if (!chain) {
-        err = "Failed to create FLAC metadata chain";
+    FLAC__Metadata_Iterator* it = FLAC__metadata_iterator_new();
+    if (!it) {
+        err = "Failed to create FLAC metadata iterator";
         return false;
     }
-    if (!FLAC__metadata_chain_read(chain, path.c_str())) {
-        err = "Failed to read FLAC metadata: " + path;
-        FLAC__metadata_chain_delete(chain);
+
+    FLAC__StreamMetadata* vorbis = build_vorbis_comments(tags);
+    if (!vorbis) {
+        err = "Failed to build Vorbis comments";
+        FLAC__metadata_iterator_delete(it);
         return false;
     }
+    // A null block means the embed mode keeps art out of tracks; stale
+    // PICTURE blocks are still dropped below.
+    FLAC__StreamMetadata* picture = nullptr;
+    if (replace_picture) {
+        std::string picture_err;
+        if (!build_track_picture_block(entry->cover_art, picture, picture_err)) {
+            FLAC__metadata_object_delete(vorbis);
+            err = picture_err;
+            FLAC__metadata_iterator_delete(it);
+            return false;
+        }
+    }
 
-    FLAC__Metadata_Iterator* it = FLAC__metadata_iterator_new();
-    if (!it) {
-        err = "Failed to create FLAC metadata iterator";
-        FLAC__metadata_chain_delete(chain);
-        return false;
+    // Skip the rewrite when the file already carries exactly these blocks, so
+    // re-running an update leaves mtimes (and backup deltas) alone.
+    std::vector<const FLAC__StreamMetadata*> existing_comments;
+    std::vector<const FLAC__StreamMetadata*> existing_pictures;
+    FLAC__metadata_iterator_init(it, chain);
+    do {
+        const FLAC__StreamMetadata* block = FLAC__metadata_iterator_get_block(it);
+        if (!block) continue;
+        if (block->type == FLAC__METADATA_TYPE_VORBIS_COMMENT) existing_comments.push_back(block);
+        if (block->type == FLAC__METADATA_TYPE_PICTURE) existing_pictures.push_back(block);
+    } while (FLAC__metadata_iterator_next(it));
+
+    bool changed = existing_comments.size() != 1 ||
+        !vorbis_comments_equal(existing_comments.front(), vorbis);
+    if (!changed && replace_picture) {
+        changed = picture
+            ? (existing_pictures.size() != 1 || !picture_blocks_equal(existing_pictures.front(), picture))
+            : !existing_pictures.empty();
+    }
+    if (out_changed) *out_changed = changed;
+    if (!changed || dry_run) {
+        FLAC__metadata_object_delete(vorbis);
+        if (picture) FLAC__metadata_object_delete(picture);
+        FLAC__metadata_iterator_delete(it);
+        return true;
     }
 
     FLAC__metadata_iterator_init(it, chain);
@@ -213,50 +701,23 @@ bool update_flac_tags(
     while (FLAC__metadata_iterator_next(it)) {
     }
 
-    FLAC__StreamMetadata* vorbis = build_vorbis_comments(tags);
-    if (!vorbis) {
-        err = "Failed to build Vorbis comments";
-        FLAC__metadata_iterator_delete(it);
-        FLAC__metadata_chain_delete(chain);
-        return false;
-    }
     if (!FLAC__metadata_iterator_insert_block_after(it, vorbis)) {
         FLAC__metadata_object_delete(vorbis);
+        if (picture) FLAC__metadata_object_delete(picture);
         err = "Failed to insert Vorbis comment block";
         FLAC__metadata_iterator_delete(it);
-        FLAC__metadata_chain_delete(chain);
         return false;
     }
 
-    if (replace_picture) {
-        FLAC__StreamMetadata* picture = build_picture_block(entry->cover_art);
-        if (!picture) {
-            FLAC__metadata_object_delete(vorbis);
-            err = "Failed to build picture block";
-            FLAC__metadata_iterator_delete(it);
-            FLAC__metadata_chain_delete(chain);
-            return false;
-        }
-        if (!FLAC__metadata_iterator_insert_block_after(it, picture)) {
-            FLAC__metadata_object_delete(vorbis);
-            FLAC__metadata_object_delete(picture);
-            err = "Failed to insert picture block";
-            FLAC__metadata_iterator_delete(it);
-            FLAC__metadata_chain_delete(chain);
-            return false;
-        }
-    }
-
-    if (!FLAC__metadata_chain_write(chain, true, true)) {
-        err = "Failed to write FLAC metadata";
+    if (picture && !FLAC__metadata_iterator_insert_block_after(it, picture)) {
+        FLAC__metadata_object_delete(picture);
+        err = "Failed to insert picture block";
         FLAC__metadata_iterator_delete(it);
-        FLAC__metadata_chain_delete(chain);
         return false;
     }
 
     FLAC__metadata_iterator_delete(it);
-    FLAC__metadata_chain_delete(chain);
-    return true;
+    return file.write(err);
 }
 
 }  // namespace cdrip::detail
@@ -274,166 +735,122 @@ CdRipTaggedTocList* cdrip_collect_cddb_queries_from_path(
         return list;
     }
 
-    const std::filesystem::path root(path);
+    const std::string root(path);
 
-    std::vector<std::filesystem::path> targets;
+    std::vector<std::string> targets;
     std::error_code ec;
 
+    const ScanPathType root_type = query_scan_path_type(root);
     // Is path directory?
-    if (std::filesystem::is_directory(root, ec)) {
-        for (auto it = std::filesystem::recursive_directory_iterator(root); it != std::filesystem::recursive_directory_iterator(); ++it) {
-            if (it->is_regular_file()) {
-                if (is_flac_file(it->path())) {
-                    targets.push_back(it->path());
-                }
-            }
-        }
+    if (root_type == ScanPathType::Directory) {
+        collect_flac_files_parallel(root, targets);
     }
     // Is path FLAC file?
-    else if (std::filesystem::is_regular_file(root, ec)) {
-        if (is_flac_file(root)) targets.push_back(root);
+    else if (root_type == ScanPathType::File) {
+        if (is_flac_file(std::filesystem::path(root))) targets.push_back(root);
     } else {
         set_error(error, "Path not found or unsupported: " + std::string(path));
         return list;
     }
 
-    std::vector<CdRipTaggedToc> items;
-    for (const auto& p : targets) {
-        CdRipTaggedToc item{};
-        const std::string path_str = p.string();
-        std::map<std::string, std::string> tags;
-        if (!collect_vorbis_comments(path_str, tags)) {
-            set_invalid_tagged_toc(item, path_str, "Failed to read Vorbis comments", 0);
-            items.push_back(item);
-            continue;
-        }
-
-        auto get_tag = [&](const std::string& key) -> std::string {
-            const auto it = tags.find(to_upper(key));
-            return it != tags.end() ? trim(it->second) : std::string{};
-        };
-
-        const std::string cddb_discid = get_tag("CDDB_DISCID");
-        const std::string offsets_raw = get_tag("CDDB_OFFSETS");
-        const std::string total_sec_raw = get_tag("CDDB_TOTAL_SECONDS");
-        const std::string tracktotal_raw = get_tag("TRACKTOTAL");
-        const std::string tracknumber_raw = get_tag("TRACKNUMBER");
-        const std::string mb_release_id = get_tag("MUSICBRAINZ_RELEASE");
-        const std::string mb_medium_id = get_tag("MUSICBRAINZ_MEDIUM");
-        const std::string mb_discid_tag = get_tag("MUSICBRAINZ_DISCID");
-        const std::string mb_leadout_tag = get_tag("MUSICBRAINZ_LEADOUT");
-        const bool has_mb_leadout_tag = !mb_leadout_tag.empty();
-
-        int track_total = 0;
-        parse_int(tracktotal_raw, track_total);
-        int track_number = 0;
-        parse_int(tracknumber_raw, track_number);
-        int total_seconds = 0;
-        parse_int(total_sec_raw, total_seconds);
-        bool offsets_ok = false;
-        std::vector<long> offsets = parse_offsets(offsets_raw, offsets_ok);
-
-        if (!offsets_ok) {
-            set_invalid_tagged_toc(item, path_str, "Invalid CDDB_OFFSETS", track_number);
-            items.push_back(item);
-            continue;
-        }
-        if (track_total == 0) {
-            track_total = static_cast<int>(offsets.size());
-        }
-        if (cddb_discid.empty() || offsets.empty() || total_seconds <= 0 || track_total <= 0) {
-            set_invalid_tagged_toc(item, path_str, "Missing CDDB tags", track_number);
-            items.push_back(item);
-            continue;
-        }
-        if (static_cast<size_t>(track_total) != offsets.size()) {
-            set_invalid_tagged_toc(item, path_str, "Offsets count mismatch with track total", track_number);
-            items.push_back(item);
-            continue;
-        }
+    const std::string index_path = get_scan_index_path();
+    ScanIndex index;
+    if (!index_path.empty()) {
+        load_scan_index(index_path, index);
+    }
 
-        long disc_frames = static_cast<long>(total_seconds) * CDIO_CD_FRAMES_PER_SEC;
-        if (disc_frames <= 0) {
-            set_invalid_tagged_toc(item, path_str, "Invalid disc length", track_number);
-            items.push_back(item);
-            continue;
+    // Reuse indexed tags for files whose identity did not change since the last scan.
+    std::vector<std::string> index_keys(targets.size());
+    std::vector<ScanIndexEntry> identities(targets.size());
+    std::vector<std::optional<std::map<std::string, std::string>>> scanned(targets.size());
+    std::vector<size_t> misses;
+    // URIs are already absolute; local paths are normalized so any working directory hits.
+    auto make_index_key = [&](const std::string& target) -> std::string {
+        if (is_uri(target)) return target;
+        const auto absolute = std::filesystem::absolute(target, ec);
+        std::string key = ec ? target : absolute.lexically_normal().string();
+        ec.clear();
+        return key;
+    };
+    for (size_t i = 0; i < targets.size(); ++i) {
+        index_keys[i] = make_index_key(targets[i]);
+        const bool has_identity = stat_scan_identity(targets[i], identities[i]);
+        const auto hit = index.find(index_keys[i]);
+        if (has_identity && hit != index.end() &&
+            hit->second.size == identities[i].size &&
+            hit->second.mtime_ns == identities[i].mtime_ns &&
+            hit->second.inode == identities[i].inode) {
+            scanned[i] = hit->second.tags;
+        } else {
+            misses.push_back(i);
         }
+    }
 
-        bool offsets_sorted = true;
-        for (size_t i = 1; i < offsets.size(); ++i) {
-            if (offsets[i] <= offsets[i - 1]) {
-                offsets_sorted = false;
-                break;
+    // Cold files: read Vorbis comments on several threads.
+    std::atomic<size_t> next_miss{0};
+    auto read_misses = [&]() {
+        while (true) {
+            const size_t m = next_miss.fetch_add(1);
+            if (m >= misses.size()) return;
+            const size_t i = misses[m];
+            std::map<std::string, std::string> tags;
+            if (collect_vorbis_comments(targets[i], tags)) {
+                scanned[i] = pick_scan_tags(tags);
             }
         }
-        if (!offsets_sorted) {
-            set_invalid_tagged_toc(item, path_str, "Offsets are not strictly increasing", track_number);
+    };
+    if (misses.size() > 1) {
+        std::vector<std::thread> readers;
+        const size_t count = std::min(scan_thread_count(), misses.size());
+        for (size_t t = 0; t < count; ++t) readers.emplace_back(read_misses);
+        for (auto& reader : readers) reader.join();
+    } else {
+        read_misses();
+    }
+
+    std::vector<CdRipTaggedToc> items;
+    items.reserve(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const std::string& path_str = targets[i];
+        if (!scanned[i]) {
+            CdRipTaggedToc item{};
+            set_invalid_tagged_toc(item, path_str, "Failed to read Vorbis comments", 0);
             items.push_back(item);
             continue;
         }
+        items.push_back(build_tagged_toc(path_str, *scanned[i]));
+    }
 
-        CdRipDiscToc* toc = new CdRipDiscToc{};
-        toc->cddb_discid = make_cstr_copy(cddb_discid);
-        if (!mb_release_id.empty()) {
-            toc->mb_release_id = make_cstr_copy(mb_release_id);
-        }
-        if (!mb_medium_id.empty()) {
-            toc->mb_medium_id = make_cstr_copy(mb_medium_id);
-        }
-        if (!mb_discid_tag.empty()) {
-            toc->mb_discid = make_cstr_copy(mb_discid_tag);
-        }
-        if (!mb_leadout_tag.empty()) {
-            long mb_leadout = 0;
-            if (parse_long(mb_leadout_tag, mb_leadout) && mb_leadout > 150) {
-                toc->leadout_sector = mb_leadout - 150;
-            }
-        }
-
-        if (toc->leadout_sector <= 0) {
-            toc->leadout_sector = disc_frames;
+    if (!index_path.empty()) {
+        bool index_changed = false;
+        for (const size_t i : misses) {
+            if (!scanned[i]) continue;
+            ScanIndexEntry entry = identities[i];
+            entry.tags = *scanned[i];
+            index[index_keys[i]] = std::move(entry);
+            index_changed = true;
         }
-        toc->length_seconds = total_seconds;
-        toc->tracks_count = offsets.size();
-        toc->tracks = new CdRipTrackInfo[toc->tracks_count]{};
-        bool length_ok = true;
-        for (size_t i = 0; i < offsets.size(); ++i) {
-            CdRipTrackInfo info{};
-            info.number = static_cast<int>(i + 1);
-            info.start = offsets[i];
-            const long end = (i + 1 < offsets.size())
-                ? offsets[i + 1] - 1
-                : disc_frames - 1;
-            if (end < info.start) {
-                length_ok = false;
-                break;
+        // Forget files that disappeared from the scanned directory.
+        if (root_type == ScanPathType::Directory) {
+            std::string prefix = make_index_key(root);
+            if (!prefix.empty()) {
+                if (prefix.back() != '/') prefix += '/';
+                const std::unordered_set<std::string> seen(index_keys.begin(), index_keys.end());
+                for (auto it = index.lower_bound(prefix);
+                     it != index.end() && it->first.compare(0, prefix.size(), prefix) == 0;) {
+                    if (seen.count(it->first) == 0) {
+                        it = index.erase(it);
+                        index_changed = true;
+                    } else {
+                        ++it;
+                    }
+                }
             }
-            info.end = end;
-            info.is_audio = 1;
-            toc->tracks[i] = info;
         }
-        if (!length_ok) {
-            cdrip_release_disctoc(toc);
-            set_invalid_tagged_toc(item, path_str, "Offsets length inconsistency", track_number);
-            items.push_back(item);
-            continue;
-        }
-
-        // Compute MusicBrainz disc id from reconstructed TOC for later queries.
-        if (!toc->mb_discid && has_mb_leadout_tag) {
-            std::string mb_discid;
-            long mb_leadout = 0;
-            if (compute_musicbrainz_discid(toc, mb_discid, mb_leadout)) {
-                toc->mb_discid = make_cstr_copy(mb_discid);
-            }
+        std::string index_err;
+        if (index_changed && !save_scan_index(index_path, index, index_err)) {
+            set_error(error, "Scan index notice: " + index_err);
         }
-
-        item.path = make_cstr_copy(path_str);
-        item.toc = toc;
-        item.track_number = track_number;
-        item.valid = 1;
-        item.reason = nullptr;
-        items.push_back(item);
     }
 
     if (!items.empty()) {
@@ -470,13 +887,24 @@ int cdrip_update_flac_with_cddb_entry(
     const CdRipCddbEntry* entry,
     const char** error) {
 
+    return cdrip_update_flac_with_cddb_entry_ex(tagged, entry, /*dry_run=*/0, error) !=
+        CDRIP_UPDATE_FAILED;
+}
+
+CdRipUpdateResults cdrip_update_flac_with_cddb_entry_ex(
+    const CdRipTaggedToc* tagged,
+    const CdRipCddbEntry* entry,
+    int dry_run,
+    const char** error) {
+
     clear_error(error);
     if (!tagged || !entry || !tagged->path || !tagged->toc) {
         set_error(error, "Invalid arguments to cdrip_update_flac_with_cddb_entry");
-        return 0;
+        return CDRIP_UPDATE_FAILED;
     }
 
     std::string err;
+    bool changed = false;
     if (!update_flac_tags(
             to_string_or_empty(tagged->path),
             tagged->toc,
@@ -484,11 +912,13 @@ int cdrip_update_flac_with_cddb_entry(
             entry,
             {},
             /*preserve_replaygain_tags=*/true,
-            err)) {
+            err,
+            dry_run != 0,
+            &changed)) {
         set_error(error, err);
-        return 0;
+        return CDRIP_UPDATE_FAILED;
     }
-    return 1;
+    return changed ? CDRIP_UPDATE_CHANGED : CDRIP_UPDATE_UNCHANGED;
 }
 
 };
@@ -0,0 +1,241 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <FLAC++/encoder.h>
+
+#include "internal.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+// Seek points of a rebuilt seek table, in seconds.
+constexpr unsigned kSeekPointSpacingSeconds = 10;
+
+struct MetadataBlockDeleter {
+    void operator()(FLAC__StreamMetadata* block) const {
+        if (block) FLAC__metadata_object_delete(block);
+    }
+};
+
+using MetadataBlockPtr = std::unique_ptr<FLAC__StreamMetadata, MetadataBlockDeleter>;
+
+// CRC-32 of decoded samples at any bit depth: each sample is hashed as its low and high
+// 16-bit halves, so the source can be compared even when STREAMINFO carries no MD5.
+static uint32_t update_decoded_crc32(
+    uint32_t crc,
+    const FLAC__int32* samples,
+    size_t count,
+    std::vector<int16_t>& scratch) {
+
+    scratch.resize(count * 2);
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t value = static_cast<uint32_t>(samples[i]);
+        scratch[i * 2] = static_cast<int16_t>(value & 0xFFFF);
+        scratch[i * 2 + 1] = static_cast<int16_t>(value >> 16);
+    }
+    return update_pcm_crc32(crc, scratch.data(), scratch.size());
+}
+
+// Copy every block but STREAMINFO, which the encoder writes itself. Seek tables point
+// into the old stream, so they are replaced by an empty template the encoder fills in.
+static bool clone_metadata_blocks(
+    const std::string& path,
+    std::vector<MetadataBlockPtr>& out,
+    bool& out_has_seektable,
+    std::string& err) {
+
+    out.clear();
+    out_has_seektable = false;
+    FlacMetadataFile file;
+    if (!file.open(path, /*writable=*/false, err)) return false;
+    FLAC__Metadata_Iterator* it = FLAC__metadata_iterator_new();
+    if (!it) {
+        err = "Failed to create FLAC metadata iterator";
+        return false;
+    }
+    FLAC__metadata_iterator_init(it, file.chain());
+    do {
+        const FLAC__StreamMetadata* block = FLAC__metadata_iterator_get_block(it);
+        if (!block || block->type == FLAC__METADATA_TYPE_STREAMINFO) continue;
+        if (block->type == FLAC__METADATA_TYPE_SEEKTABLE) {
+            out_has_seektable = true;
+            continue;
+        }
+        MetadataBlockPtr copy(FLAC__metadata_object_clone(block));
+        if (!copy) {
+            FLAC__metadata_iterator_delete(it);
+            err = "Failed to copy FLAC metadata block";
+            return false;
+        }
+        out.push_back(std::move(copy));
+    } while (FLAC__metadata_iterator_next(it));
+    FLAC__metadata_iterator_delete(it);
+    return true;
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+bool recompress_flac_file(
+    const std::string& path,
+    int compression_level,
+    bool exhaustive_model_search,
+    FlacRecompressResult& out,
+    std::string& err) {
+
+    err.clear();
+    out = FlacRecompressResult{};
+    if (compression_level < 0 || compression_level > 8) {
+        err = "Compression level must be between 0 and 8";
+        return false;
+    }
+
+    ScanIndexEntry identity{};
+    if (!stat_scan_identity(path, identity)) {
+        err = "Failed to stat FLAC file: " + path;
+        return false;
+    }
+    out.original_bytes = identity.size;
+
+    std::vector<MetadataBlockPtr> blocks;
+    bool has_seektable = false;
+    if (!clone_metadata_blocks(path, blocks, has_seektable, err)) {
+        return false;
+    }
+
+    std::string temp_path;
+    if (!create_local_temp_file(temp_path, err)) {
+        return false;
+    }
+
+    FLAC::Encoder::File encoder;
+    MetadataBlockPtr seektable;
+    std::vector<FLAC__StreamMetadata*> encoder_blocks;
+    bool encoder_ready = false;
+    std::string encode_err;
+    FlacDecodeResult source{};
+    uint32_t source_crc = 0;
+    std::vector<int16_t> crc_scratch;
+    const FlacPcmSink sink = [&](const FLAC__int32* samples, size_t frames, unsigned channels, unsigned bits_per_sample) {
+        source_crc = update_decoded_crc32(source_crc, samples, frames * channels, crc_scratch);
+        if (!encoder_ready) {
+            // STREAMINFO precedes the first frame, so the source format is known here.
+            encoder.set_verify(false);
+            encoder.set_compression_level(static_cast<unsigned>(compression_level));
+            encoder.set_do_exhaustive_model_search(exhaustive_model_search);
+            encoder.set_channels(channels);
+            encoder.set_bits_per_sample(bits_per_sample);
+            encoder.set_sample_rate(source.sample_rate);
+            encoder.set_total_samples_estimate(source.total_samples);
+            if (has_seektable && source.total_samples > 0) {
+                seektable.reset(FLAC__metadata_object_new(FLAC__METADATA_TYPE_SEEKTABLE));
+                if (!seektable ||
+                    !FLAC__metadata_object_seektable_template_append_spaced_points_by_samples(
+                        seektable.get(), kSeekPointSpacingSeconds * source.sample_rate, source.total_samples) ||
+                    !FLAC__metadata_object_seektable_template_sort(seektable.get(), true)) {
+                    encode_err = "Failed to build seek table";
+                    return false;
+                }
+                encoder_blocks.push_back(seektable.get());
+            }
+            for (const auto& block : blocks) {
+                encoder_blocks.push_back(block.get());
+            }
+            if (!encoder_blocks.empty()) {
+                encoder.set_metadata(encoder_blocks.data(), static_cast<unsigned>(encoder_blocks.size()));
+            }
+            const FLAC__StreamEncoderInitStatus init_status = encoder.init(temp_path.c_str());
+            if (init_status != FLAC__STREAM_ENCODER_INIT_STATUS_OK) {
+                encode_err = "Failed to init FLAC stream encoder: init status "
+                    + std::to_string(static_cast<int>(init_status));
+                return false;
+            }
+            encoder_ready = true;
+        }
+        if (!encoder.process_interleaved(samples, static_cast<unsigned>(frames))) {
+            encode_err = "FLAC encoding error";
+            return false;
+        }
+        return true;
+    };
+
+    const bool decoded = decode_flac_file(path, /*check_md5=*/true, sink, source, err);
+    const bool finished = encoder_ready && encoder.finish();
+    if (!decoded || !encode_err.empty() || !finished) {
+        if (!encode_err.empty()) err = encode_err + ": " + path;
+        if (err.empty()) err = "Failed to re-encode FLAC file: " + path;
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+    if (source.md5_checked && !source.md5_ok) {
+        // Never replace a file whose audio already disagrees with its own checksum.
+        err = "Source audio does not match its STREAMINFO MD5: " + path;
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+
+    // The new stream must decode cleanly to the same audio as the original. The CRC of
+    // the decoded source covers files without an MD5, which nothing else would check.
+    FlacDecodeResult recompressed{};
+    uint32_t recompressed_crc = 0;
+    const FlacPcmSink check_sink = [&](const FLAC__int32* samples, size_t frames, unsigned channels, unsigned) {
+        recompressed_crc = update_decoded_crc32(recompressed_crc, samples, frames * channels, crc_scratch);
+        return true;
+    };
+    if (!decode_flac_file(temp_path, /*check_md5=*/true, check_sink, recompressed, err)) {
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+    const bool same_audio = recompressed.md5_ok &&
+        recompressed.decoded_samples == source.decoded_samples &&
+        recompressed_crc == source_crc &&
+        (!source.has_md5 || std::memcmp(recompressed.md5, source.md5, sizeof(source.md5)) == 0);
+    if (!same_audio) {
+        err = "Re-encoded audio does not match the original: " + path;
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+
+    ScanIndexEntry temp_identity{};
+    if (!stat_scan_identity(temp_path, temp_identity)) {
+        err = "Failed to stat re-encoded file: " + temp_path;
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+    out.recompressed_bytes = temp_identity.size;
+    if (out.recompressed_bytes >= out.original_bytes) {
+        remove_local_file_quietly(temp_path);
+        return true;
+    }
+
+    // A tag update may have rewritten the source during the re-encode; publishing now would
+    // put the old contents back.
+    ScanIndexEntry current{};
+    if (!stat_scan_identity(path, current) ||
+        current.size != identity.size ||
+        current.mtime_ns != identity.mtime_ns ||
+        current.inode != identity.inode) {
+        remove_local_file_quietly(temp_path);
+        out.changed = true;
+        return true;
+    }
+
+    if (!publish_local_file_to_destination(temp_path, path, err)) {
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+    remove_local_file_quietly(temp_path);
+    out.replaced = true;
+    return true;
+}
+
+}  // namespace cdrip::detail
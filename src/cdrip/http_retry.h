@@ -96,11 +96,13 @@ static inline bool http_get_bytes_with_retry(
     const HttpRetryPolicy& policy,
     std::vector<uint8_t>& body,
     std::string& content_type,
-    std::string& err) {
+    std::string& err,
+    guint* out_status = nullptr) {
 
     body.clear();
     content_type.clear();
     err.clear();
+    if (out_status) *out_status = 0;
 
     SoupSession* session = soup_session_new();
     if (!session) {
@@ -135,6 +137,7 @@ static inline bool http_get_bytes_with_retry(
         GError* gerr = nullptr;
         GBytes* bytes = soup_session_send_and_read(session, msg, nullptr, &gerr);
         const guint status = soup_message_get_status(msg);
+        if (out_status) *out_status = status;
 
         if (SOUP_STATUS_IS_REDIRECTION(status)) {
             const char* loc = soup_message_headers_get_one(
@@ -0,0 +1,686 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cdio/cdio.h>
+
+#include "internal.h"
+
+namespace {
+
+using cdrip::detail::BackendDetectedDrive;
+using cdrip::detail::DriveBackend;
+
+constexpr long kAudioSectorBytes = CDIO_CD_FRAMESIZE_RAW;
+constexpr size_t kSectorValues = CDIO_CD_FRAMESIZE_RAW / sizeof(int16_t);
+constexpr long kFramesPerSecond = CDIO_CD_FRAMES_PER_SEC;
+
+// A file of the image, mapped read-only while the image is open.
+struct MappedFile {
+    std::string path{};
+    const uint8_t* data{nullptr};
+    size_t size{0};
+    // Audio payload within the file: the whole file, or the data chunk of a WAV.
+    size_t payload_offset{0};
+    size_t payload_size{0};
+    long sector_bytes{kAudioSectorBytes};
+    bool big_endian{false};
+
+    ~MappedFile() {
+        if (data) munmap(const_cast<uint8_t*>(data), size);
+    }
+};
+
+// A run of disc sectors stored in a file, or silence for a gap the image does not store.
+struct ImageExtent {
+    long first_sector{0};
+    long sectors{0};
+    int file{-1};
+    // First frame of the run within the file's payload.
+    long file_frame{0};
+};
+
+struct ImageDisc {
+    std::vector<std::unique_ptr<MappedFile>> files{};
+    std::vector<ImageExtent> extents{};
+    std::vector<CdRipTrackInfo> tracks{};
+    long last_sector{-1};
+};
+
+struct ImageReader {
+    const ImageDisc* disc{nullptr};
+    long sector{0};
+    // Last extent read; sequential reads stay inside it almost always.
+    size_t extent{0};
+    std::vector<int16_t> buffer = std::vector<int16_t>(kSectorValues);
+};
+
+struct CueTrack {
+    int number{0};
+    bool audio{true};
+    long sector_bytes{kAudioSectorBytes};
+    // FILE in effect at INDEX 01 and the frame of INDEX 01 within it.
+    int file{-1};
+    long index01{-1};
+    long pregap{0};
+    long postgap{0};
+};
+
+struct CueFile {
+    std::string path{};
+    std::string type{};
+};
+
+static bool host_is_little_endian() {
+    const uint16_t probe = 1;
+    uint8_t first = 0;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+static uint32_t read_le32(
+    const uint8_t* p) {
+
+    return static_cast<uint32_t>(p[0]) |
+        (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) |
+        (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint16_t read_le16(
+    const uint8_t* p) {
+
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// "mm:ss:ff" in CD frames.
+static bool parse_msf(
+    const std::string& text,
+    long& out_frames) {
+
+    int minutes = 0;
+    int seconds = 0;
+    int frames = 0;
+    char tail = 0;
+    if (std::sscanf(text.c_str(), "%d:%d:%d%c", &minutes, &seconds, &frames, &tail) != 3 ||
+        minutes < 0 || seconds < 0 || seconds >= 60 || frames < 0 || frames >= kFramesPerSecond) {
+        return false;
+    }
+    out_frames = (static_cast<long>(minutes) * 60 + seconds) * kFramesPerSecond + frames;
+    return true;
+}
+
+// Splits a cue sheet line into words; a double-quoted word may contain spaces.
+static std::vector<std::string> split_cue_line(
+    const std::string& line) {
+
+    std::vector<std::string> words;
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && std::isspace(static_cast<unsigned char>(line[i]))) ++i;
+        if (i >= line.size()) break;
+        std::string word;
+        if (line[i] == '"') {
+            const size_t end = line.find('"', i + 1);
+            word = line.substr(i + 1, end == std::string::npos ? std::string::npos : end - i - 1);
+            i = end == std::string::npos ? line.size() : end + 1;
+        } else {
+            const size_t start = i;
+            while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i]))) ++i;
+            word = line.substr(start, i - start);
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+static long sector_bytes_for_mode(
+    const std::string& mode) {
+
+    if (mode == "AUDIO") return kAudioSectorBytes;
+    if (mode == "CDG") return 2448;
+    const size_t slash = mode.find('/');
+    if (slash == std::string::npos) return 0;
+    return std::strtol(mode.c_str() + slash + 1, nullptr, 10);
+}
+
+static bool parse_cue_sheet(
+    const std::string& cue_path,
+    std::vector<CueFile>& out_files,
+    std::vector<CueTrack>& out_tracks,
+    std::string& err) {
+
+    std::ifstream in(cue_path);
+    if (!in) {
+        err = "Could not open cue sheet " + cue_path;
+        return false;
+    }
+    const std::filesystem::path base = std::filesystem::path(cue_path).parent_path();
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line_number == 1 && line.rfind("\xEF\xBB\xBF", 0) == 0) line.erase(0, 3);
+        const auto words = split_cue_line(line);
+        if (words.empty()) continue;
+        const std::string keyword = cdrip::detail::to_upper(words[0]);
+        const std::string where = cue_path + ":" + std::to_string(line_number);
+        if (keyword == "FILE") {
+            if (words.size() < 3) {
+                err = where + ": FILE needs a name and a type";
+                return false;
+            }
+            CueFile file{};
+            const std::filesystem::path name(words[1]);
+            file.path = (name.is_absolute() ? name : base / name).string();
+            file.type = cdrip::detail::to_upper(words.back());
+            out_files.push_back(std::move(file));
+        } else if (keyword == "TRACK") {
+            if (words.size() < 3 || out_files.empty()) {
+                err = where + ": TRACK needs a number, a mode and a FILE before it";
+                return false;
+            }
+            CueTrack track{};
+            track.number = std::atoi(words[1].c_str());
+            const std::string mode = cdrip::detail::to_upper(words[2]);
+            track.audio = mode == "AUDIO";
+            track.sector_bytes = sector_bytes_for_mode(mode);
+            if (track.number <= 0 || track.sector_bytes <= 0) {
+                err = where + ": unsupported TRACK " + words[1] + " " + words[2];
+                return false;
+            }
+            // The TOC is looked up by track number, so numbers have to run 1, 2, 3, ...
+            if (track.number != static_cast<int>(out_tracks.size()) + 1) {
+                err = where + ": TRACK " + words[1] + " is out of sequence (expected " +
+                    std::to_string(out_tracks.size() + 1) + ")";
+                return false;
+            }
+            out_tracks.push_back(track);
+        } else if (keyword == "INDEX" || keyword == "PREGAP" || keyword == "POSTGAP") {
+            const bool index = keyword == "INDEX";
+            long frames = 0;
+            if (out_tracks.empty() || words.size() < (index ? 3u : 2u) || !parse_msf(words.back(), frames)) {
+                err = where + ": malformed " + keyword;
+                return false;
+            }
+            CueTrack& track = out_tracks.back();
+            if (keyword == "PREGAP") {
+                track.pregap = frames;
+            } else if (keyword == "POSTGAP") {
+                track.postgap = frames;
+            } else if (std::atoi(words[1].c_str()) == 1) {
+                // INDEX 00 only marks a pause; the TOC knows where INDEX 01 starts.
+                track.file = static_cast<int>(out_files.size()) - 1;
+                track.index01 = frames;
+            }
+        }
+        // CATALOG, TITLE, PERFORMER, REM, FLAGS, ISRC and the rest carry no layout.
+    }
+    if (out_tracks.empty()) {
+        err = "Cue sheet " + cue_path + " has no tracks";
+        return false;
+    }
+    for (const auto& track : out_tracks) {
+        if (track.index01 < 0) {
+            err = "Cue sheet " + cue_path + ": TRACK " + std::to_string(track.number) + " has no INDEX 01";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Finds the data chunk of a 16-bit stereo 44.1 kHz PCM WAV.
+static bool locate_wav_payload(
+    MappedFile& file,
+    std::string& err) {
+
+    const uint8_t* p = file.data;
+    if (file.size < 12 || std::memcmp(p, "RIFF", 4) != 0 || std::memcmp(p + 8, "WAVE", 4) != 0) {
+        err = file.path + " is not a RIFF WAVE file";
+        return false;
+    }
+    bool format_ok = false;
+    size_t pos = 12;
+    while (pos + 8 <= file.size) {
+        const uint32_t chunk_size = read_le32(p + pos + 4);
+        const size_t body = pos + 8;
+        if (std::memcmp(p + pos, "fmt ", 4) == 0 && chunk_size >= 16 && body + 16 <= file.size) {
+            const uint16_t format = read_le16(p + body);
+            format_ok = (format == 1 || format == 0xFFFE) &&
+                read_le16(p + body + 2) == 2 &&
+                read_le32(p + body + 4) == 44100 &&
+                read_le16(p + body + 14) == 16;
+        } else if (std::memcmp(p + pos, "data", 4) == 0) {
+            if (!format_ok) {
+                err = file.path + " is not 16-bit stereo 44.1 kHz PCM";
+                return false;
+            }
+            file.payload_offset = body;
+            file.payload_size = std::min<size_t>(chunk_size, file.size - body);
+            return true;
+        }
+        pos = body + chunk_size + (chunk_size & 1);
+    }
+    err = file.path + " has no data chunk";
+    return false;
+}
+
+static bool map_image_file(
+    const CueFile& cue_file,
+    std::unique_ptr<MappedFile>& out,
+    std::string& err) {
+
+    auto file = std::make_unique<MappedFile>();
+    file->path = cue_file.path;
+    if (cue_file.type != "BINARY" && cue_file.type != "MOTOROLA" && cue_file.type != "WAVE") {
+        err = "Unsupported FILE type " + cue_file.type + " for " + cue_file.path + " (BINARY, MOTOROLA or WAVE)";
+        return false;
+    }
+    const int fd = ::open(file->path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        err = "Could not open image file " + file->path;
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        err = "Image file " + file->path + " is empty or unreadable";
+        return false;
+    }
+    void* mapped = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        err = "Could not map image file " + file->path;
+        return false;
+    }
+    file->data = static_cast<const uint8_t*>(mapped);
+    file->size = static_cast<size_t>(st.st_size);
+    // Images are read front to back, so let the kernel read ahead aggressively.
+    ::madvise(mapped, file->size, MADV_SEQUENTIAL);
+
+    if (cue_file.type == "WAVE") {
+        if (!locate_wav_payload(*file, err)) return false;
+    } else {
+        file->payload_offset = 0;
+        file->payload_size = file->size;
+        file->big_endian = cue_file.type == "MOTOROLA";
+    }
+    out = std::move(file);
+    return true;
+}
+
+// Lays the files out on one sector timeline, with PREGAP and POSTGAP as silence,
+// and derives the TOC from where each INDEX 01 lands.
+static bool load_cue_image(
+    const std::string& cue_path,
+    ImageDisc& disc,
+    std::string& err) {
+
+    std::vector<CueFile> cue_files;
+    std::vector<CueTrack> cue_tracks;
+    if (!parse_cue_sheet(cue_path, cue_files, cue_tracks, err)) return false;
+
+    long lba = 0;
+    for (size_t f = 0; f < cue_files.size(); ++f) {
+        std::unique_ptr<MappedFile> file;
+        if (!map_image_file(cue_files[f], file, err)) return false;
+
+        std::vector<const CueTrack*> starting;
+        for (const auto& track : cue_tracks) {
+            if (track.file == static_cast<int>(f)) starting.push_back(&track);
+        }
+        // Frame positions only work out with one sector size per file.
+        for (const auto* track : starting) {
+            if (track->sector_bytes != starting.front()->sector_bytes) {
+                err = "Image file " + file->path + " mixes sector sizes";
+                return false;
+            }
+        }
+        if (!starting.empty()) file->sector_bytes = starting.front()->sector_bytes;
+        const long file_frames = static_cast<long>(
+            (file->payload_size + static_cast<size_t>(file->sector_bytes) - 1) / static_cast<size_t>(file->sector_bytes));
+
+        const int file_index = static_cast<int>(disc.files.size());
+        disc.files.push_back(std::move(file));
+        long cursor = 0;
+        auto add_data = [&](long until) {
+            if (until <= cursor) return;
+            disc.extents.push_back(ImageExtent{lba, until - cursor, file_index, cursor});
+            lba += until - cursor;
+            cursor = until;
+        };
+        auto add_silence = [&](long sectors) {
+            if (sectors <= 0) return;
+            disc.extents.push_back(ImageExtent{lba, sectors, -1, 0});
+            lba += sectors;
+        };
+        for (const auto* track : starting) {
+            if (track->index01 > file_frames) {
+                err = "TRACK " + std::to_string(track->number) + " starts past the end of " + cue_files[f].path;
+                return false;
+            }
+            add_data(track->index01);
+            add_silence(track->pregap);
+        }
+        add_data(file_frames);
+        for (const auto* track : starting) add_silence(track->postgap);
+    }
+    if (lba <= 0) {
+        err = "Disc image " + cue_path + " holds no sectors";
+        return false;
+    }
+
+    // INDEX 01 of a track with a PREGAP lands right after its silence.
+    auto lba_of = [&](const CueTrack& track) {
+        for (const auto& extent : disc.extents) {
+            if (extent.file == track.file &&
+                track.index01 >= extent.file_frame &&
+                track.index01 < extent.file_frame + extent.sectors) {
+                return extent.first_sector + (track.index01 - extent.file_frame);
+            }
+        }
+        return lba;
+    };
+    for (const auto& track : cue_tracks) {
+        CdRipTrackInfo info{};
+        info.number = track.number;
+        info.start = lba_of(track);
+        info.is_audio = track.audio ? 1 : 0;
+        disc.tracks.push_back(info);
+    }
+    for (size_t i = 0; i < disc.tracks.size(); ++i) {
+        disc.tracks[i].end = i + 1 < disc.tracks.size() ? disc.tracks[i + 1].start - 1 : lba - 1;
+        if (disc.tracks[i].end < disc.tracks[i].start) {
+            err = "Cue sheet " + cue_path + ": TRACK " + std::to_string(disc.tracks[i].number) + " is empty or out of order";
+            return false;
+        }
+    }
+    disc.last_sector = lba - 1;
+    return true;
+}
+
+static bool load_image(
+    const std::string& path,
+    ImageDisc& disc,
+    std::string& err) {
+
+    const std::string ext = cdrip::detail::to_lower(std::filesystem::path(path).extension().string());
+    if (ext == ".cue") return load_cue_image(path, disc, err);
+
+    // A bare WAV or BIN is one audio track.
+    CueFile bare{};
+    bare.path = path;
+    bare.type = ext == ".wav" ? "WAVE" : "BINARY";
+    std::unique_ptr<MappedFile> file;
+    if (!map_image_file(bare, file, err)) return false;
+    const long sectors = static_cast<long>(
+        (file->payload_size + static_cast<size_t>(kAudioSectorBytes) - 1) / static_cast<size_t>(kAudioSectorBytes));
+    disc.files.push_back(std::move(file));
+    disc.extents.push_back(ImageExtent{0, sectors, 0, 0});
+    disc.tracks.push_back(CdRipTrackInfo{1, 0, sectors - 1, 1});
+    disc.last_sector = sectors - 1;
+    return true;
+}
+
+auto image_detect_drives = []() {
+    // Images are named explicitly; there is nothing to detect.
+    return std::vector<BackendDetectedDrive>{};
+};
+
+auto image_open_drive = [](
+    const std::string& device,
+    void*& out_drive,
+    std::string& err) {
+
+    err.clear();
+    out_drive = nullptr;
+    const std::string path = device.substr(std::strlen(cdrip::detail::kImageDevicePrefix));
+    if (path.empty()) {
+        err = "Disc image device needs a path: image:///path/disc.cue";
+        return false;
+    }
+    auto disc = std::make_unique<ImageDisc>();
+    if (!load_image(path, *disc, err)) return false;
+    out_drive = disc.release();
+    return true;
+};
+
+auto image_close_drive = [](
+    void* drive) {
+
+    delete static_cast<ImageDisc*>(drive);
+};
+
+auto image_set_drive_speed = [](
+    void* drive,
+    bool,
+    std::string& err) {
+
+    err.clear();
+    if (!drive) {
+        err = "Drive handle is null";
+        return false;
+    }
+    return true;
+};
+
+auto image_create_reader = [](
+    void* drive,
+    CdRipRipModes,
+    void*& out_reader,
+    std::string& err) {
+
+    err.clear();
+    out_reader = nullptr;
+    if (!drive) {
+        err = "Drive handle is null";
+        return false;
+    }
+    auto* reader = new ImageReader{};
+    reader->disc = static_cast<const ImageDisc*>(drive);
+    out_reader = reader;
+    return true;
+};
+
+auto image_destroy_reader = [](
+    void* reader) {
+
+    delete static_cast<ImageReader*>(reader);
+};
+
+auto image_eject_drive = [](
+    const std::string&,
+    std::string& err) {
+
+    err.clear();
+    return true;
+};
+
+auto image_get_track_count = [](
+    void* drive,
+    int& out_track_count,
+    std::string& err) {
+
+    err.clear();
+    out_track_count = 0;
+    if (!drive) {
+        err = "Drive handle is null";
+        return false;
+    }
+    out_track_count = static_cast<int>(static_cast<const ImageDisc*>(drive)->tracks.size());
+    return true;
+};
+
+auto image_get_track_info = [](
+    void* drive,
+    int track_number,
+    CdRipTrackInfo& out_track,
+    std::string& err) {
+
+    err.clear();
+    out_track = CdRipTrackInfo{};
+    if (!drive) {
+        err = "Drive handle is null";
+        return false;
+    }
+    // parse_cue_sheet only accepts tracks numbered from 1 without gaps.
+    const auto& tracks = static_cast<const ImageDisc*>(drive)->tracks;
+    if (track_number < 1 || static_cast<size_t>(track_number) > tracks.size()) {
+        err = "Track " + std::to_string(track_number) + " is not in the disc image";
+        return false;
+    }
+    out_track = tracks[static_cast<size_t>(track_number - 1)];
+    return true;
+};
+
+auto image_get_disc_last_sector = [](
+    void* drive,
+    long& out_last_sector,
+    std::string& err) {
+
+    err.clear();
+    out_last_sector = 0;
+    if (!drive) {
+        err = "Drive handle is null";
+        return false;
+    }
+    out_last_sector = static_cast<const ImageDisc*>(drive)->last_sector;
+    return true;
+};
+
+auto image_seek_reader = [](
+    void* reader,
+    long sector,
+    std::string& err) {
+
+    err.clear();
+    if (!reader) {
+        err = "Reader handle is null";
+        return false;
+    }
+    static_cast<ImageReader*>(reader)->sector = sector;
+    return true;
+};
+
+auto image_read_sector = [](
+    void* reader,
+    int,
+    const int16_t*& out_buffer,
+    CdRipReadStats&,
+    std::string& err) {
+
+    err.clear();
+    out_buffer = nullptr;
+    if (!reader) {
+        err = "Reader handle is null";
+        return false;
+    }
+    ImageReader& r = *static_cast<ImageReader*>(reader);
+    const ImageDisc& disc = *r.disc;
+    const long sector = r.sector++;
+    if (sector < 0 || sector > disc.last_sector) {
+        err = "Sector " + std::to_string(sector) + " is outside the disc image";
+        return false;
+    }
+    auto contains = [sector](const ImageExtent& extent) {
+        return sector >= extent.first_sector && sector < extent.first_sector + extent.sectors;
+    };
+    if (r.extent >= disc.extents.size() || !contains(disc.extents[r.extent])) {
+        const auto it = std::upper_bound(
+            disc.extents.begin(),
+            disc.extents.end(),
+            sector,
+            [](long value, const ImageExtent& extent) { return value < extent.first_sector; });
+        r.extent = static_cast<size_t>(std::distance(disc.extents.begin(), it)) - 1;
+    }
+    const ImageExtent& extent = disc.extents[r.extent];
+    if (extent.file < 0) {
+        std::fill(r.buffer.begin(), r.buffer.end(), 0);
+        out_buffer = r.buffer.data();
+        return true;
+    }
+
+    const MappedFile& file = *disc.files[static_cast<size_t>(extent.file)];
+    const size_t payload_pos =
+        static_cast<size_t>(extent.file_frame + (sector - extent.first_sector)) * static_cast<size_t>(file.sector_bytes);
+    const size_t available = payload_pos < file.payload_size ? file.payload_size - payload_pos : 0;
+    const uint8_t* bytes = file.data + file.payload_offset + payload_pos;
+    static const bool little_endian_host = host_is_little_endian();
+    // Zero copy when the stored samples already are native int16 at an aligned address.
+    if (available >= static_cast<size_t>(kAudioSectorBytes) &&
+        file.big_endian != little_endian_host &&
+        reinterpret_cast<uintptr_t>(bytes) % alignof(int16_t) == 0) {
+        out_buffer = reinterpret_cast<const int16_t*>(bytes);
+        return true;
+    }
+    // The last sector of a WAV may be partial; the rest of it is silence.
+    const size_t values = std::min(available / sizeof(int16_t), kSectorValues);
+    for (size_t i = 0; i < values; ++i) {
+        const uint8_t* p = bytes + i * 2;
+        r.buffer[i] = static_cast<int16_t>(file.big_endian ? ((p[0] << 8) | p[1]) : (p[0] | (p[1] << 8)));
+    }
+    std::fill(r.buffer.begin() + static_cast<std::ptrdiff_t>(values), r.buffer.end(), 0);
+    out_buffer = r.buffer.data();
+    return true;
+};
+
+auto image_set_reader_mode = [](
+    void* reader,
+    CdRipRipModes,
+    std::string& err) {
+
+    err.clear();
+    if (!reader) {
+        err = "Reader handle is null";
+        return false;
+    }
+    return true;
+};
+
+const DriveBackend kImageDriveBackend{
+    image_detect_drives,
+    image_open_drive,
+    image_close_drive,
+    image_set_drive_speed,
+    image_create_reader,
+    image_destroy_reader,
+    image_eject_drive,
+    image_get_track_count,
+    image_get_track_info,
+    image_get_disc_last_sector,
+    image_seek_reader,
+    image_read_sector,
+    image_set_reader_mode,
+};
+
+}  // namespace
+
+namespace cdrip::detail {
+
+bool is_image_device(
+    const std::string& device) {
+
+    return device.rfind(kImageDevicePrefix, 0) == 0;
+}
+
+const DriveBackend& image_drive_backend() {
+    return kImageDriveBackend;
+}
+
+}  // namespace cdrip::detail
@@ -12,8 +12,11 @@
 #include <cctype>
 #include <cstring>
 #include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <limits>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -28,6 +31,15 @@
 namespace cdrip::detail {
 struct BackendDetectedDrive;
 struct DriveBackend;
+struct SalvageSpool;
+struct SequentialReadState;
+
+/** Extra output of every track; see cdrip_add_output. */
+struct OutputSinkConfig {
+    CdRipOutputKinds kind{CDRIP_OUTPUT_FLAC};
+    std::string format{};
+    int compression_level{5};
+};
 }
 
 struct CdRip {
@@ -39,6 +51,28 @@ struct CdRip {
     std::string format;
     int compression_level{-1};
     bool speed_fast{false};
+    int encoder_threads{0};
+    int read_offset{0};
+    /** Level for the next track in adaptive mode (<0 => not measured yet). */
+    int adaptive_compression_level{-1};
+    bool read_telemetry{false};
+    CdRipDiagnosticObserver telemetry_observer{};
+    /** Telemetry of the tracks ripped from telemetry_discid, for the read report. */
+    std::string telemetry_discid{};
+    std::vector<CdRipReadTelemetry> telemetry_tracks{};
+    /** Read time budgets in seconds (<=0 => unlimited); see cdrip_set_read_budget. */
+    double sector_budget_sec{0.0};
+    double track_budget_sec{0.0};
+    CdRipDiagnosticObserver budget_observer{};
+    /** The reader was left at lowered integrity checks by an exhausted budget. */
+    bool reader_degraded{false};
+    /** Audio of the disc read ahead by salvage mode (null until cdrip_salvage_disc, and again once every track was encoded). */
+    std::shared_ptr<cdrip::detail::SalvageSpool> salvage{};
+    /** Continue adjacent tracks from one reader without seeking; see cdrip_set_sequential_read. */
+    bool sequential_read{false};
+    std::shared_ptr<cdrip::detail::SequentialReadState> sequential{};
+    /** Outputs fed from the same reads as the main FLAC; see cdrip_add_output. */
+    std::vector<cdrip::detail::OutputSinkConfig> outputs{};
 };
 
 /* ------------------------------------------------------------------- */
@@ -89,17 +123,55 @@ struct DriveBackend {
         void* reader,
         long sector,
         std::string& err);
+    // Paranoia events of the read are added to stats; max_retries <= 0 keeps the backend default.
     bool (*read_sector)(
         void* reader,
+        int max_retries,
         const int16_t*& out_buffer,
+        CdRipReadStats& stats,
+        std::string& err);
+    // Change the integrity checks of an existing reader; reads continue at its position.
+    bool (*set_reader_mode)(
+        void* reader,
+        CdRipRipModes mode,
         std::string& err);
 };
 
+// Paranoia events that mean the drive did not return the same data when read again.
+static inline long count_read_error_events(const CdRipReadStats& stats) {
+    return stats.fixups + stats.scratches + stats.skips + stats.drifts + stats.read_errors;
+}
+
 const DriveBackend& current_drive_backend();
 void set_drive_backend_for_tests(
     const DriveBackend* backend);
 void reset_drive_backend_for_tests();
 
+// Devices named image:///path/disc.cue (or .wav/.bin) are served from a stored disc image.
+constexpr const char* kImageDevicePrefix = "image://";
+
+/**
+ * Whether a device name refers to a disc image rather than a drive.
+ * @param device Device name as given to cdrip_open.
+ * @return true when the name starts with image://.
+ */
+bool is_image_device(
+    const std::string& device);
+
+/**
+ * Backend that reads BIN/CUE and WAV disc images through mmap.
+ * @return Backend serving TOC, track info and sectors from the image.
+ */
+const DriveBackend& image_drive_backend();
+
+/**
+ * Backend for a device: the image backend for image:// names, the current backend otherwise.
+ * @param device Device name as given to cdrip_open.
+ * @return Backend to open the device with.
+ */
+const DriveBackend& drive_backend_for_device(
+    const std::string& device);
+
 // Helpers were previously static in the monolithic TU; keep internal linkage by
 // providing inline definitions scoped to this header.
 static inline const char* make_cstr_copy(const std::string& s) {
@@ -141,6 +213,9 @@ static inline void drop_format_only_tags(std::map<std::string, std::string>& tag
     tags.erase("MUSICBRAINZ_MEDIUMTITLE_RAW");
 }
 
+/** Vorbis comment holding the CRC-32 of a track's 16-bit PCM, written while ripping. */
+static constexpr const char* kPcmCrc32TagKey = "PCM_CRC32";
+
 static inline bool is_replaygain_tag_key(
     const std::string& key_upper) {
 
@@ -457,6 +532,8 @@ struct RipTrackWriteOptions {
     const char* display_path{nullptr};
     ebur128_state* track_replaygain_state{nullptr};
     ebur128_state* album_replaygain_state{nullptr};
+    // One FLAC for the whole disc, with image tags, CUESHEET and SEEKTABLE.
+    bool disc_image{false};
 };
 
 static inline std::string build_cddb_offsets_tag(
@@ -527,12 +604,78 @@ std::map<std::string, std::string> build_track_vorbis_tags(
     std::string& track_name_out,
     std::string& safe_title_out);
 
+/**
+ * Describe a whole-disc image as one track spanning the first to the last audio track.
+ * @param toc Disc TOC.
+ * @param out Output image track (numbered like the first audio track).
+ * @param err Output error text on failure (no audio, or a data track between audio tracks).
+ * @return true on success.
+ */
+bool build_disc_image_track(
+    const CdRipDiscToc* toc,
+    CdRipTrackInfo& out,
+    std::string& err);
+
+/**
+ * Build Vorbis tags of a disc image: album tags, TITLE from the album,
+ * and CUE_TRACKnn_<KEY> for every per-track value.
+ * @param meta Album metadata.
+ * @param toc Disc TOC.
+ * @param title_out Output image title.
+ * @param track_name_out Output display name.
+ * @param safe_title_out Output file-name-safe title.
+ * @return Tags of the image file.
+ */
+std::map<std::string, std::string> build_disc_image_vorbis_tags(
+    const CdRipCddbEntry* meta,
+    const CdRipDiscToc* toc,
+    std::string& title_out,
+    std::string& track_name_out,
+    std::string& safe_title_out);
+
+/**
+ * Build the CD-DA CUESHEET block of a disc image.
+ * @param toc Disc TOC.
+ * @param image_track Image track from build_disc_image_track.
+ * @param err Output error text on failure.
+ * @return Metadata block owned by the caller, or nullptr on failure.
+ */
+FLAC__StreamMetadata* build_disc_image_cuesheet(
+    const CdRipDiscToc* toc,
+    const CdRipTrackInfo& image_track,
+    std::string& err);
+
+/**
+ * Build the SEEKTABLE template of a disc image: one point per second and one per track start.
+ * @param toc Disc TOC.
+ * @param image_track Image track from build_disc_image_track.
+ * @return Metadata block owned by the caller, or nullptr on failure.
+ */
+FLAC__StreamMetadata* build_disc_image_seektable(
+    const CdRipDiscToc* toc,
+    const CdRipTrackInfo& image_track);
+
 bool resolve_track_output_path(
     const std::string& format,
     const std::map<std::string, std::string>& tags,
     std::string& out_path,
     std::string& err);
 
+/**
+ * Create an empty local temporary file.
+ * @param out_path Output file path.
+ * @param err Output error text on failure.
+ * @param name_template g_file_open_tmp template.
+ * @return True on success.
+ */
+bool create_local_temp_file(
+    std::string& out_path,
+    std::string& err,
+    const char* name_template = "cdripXXXXXX.flac");
+
+void remove_local_file_quietly(
+    const std::string& path);
+
 bool publish_local_file_to_destination(
     const std::string& local_path,
     const std::string& destination_path,
@@ -547,6 +690,691 @@ std::map<std::string, std::string> build_replaygain_tags(
     const ReplayGainScanResult& track,
     const ReplayGainScanResult& album);
 
+/**
+ * Decode FLAC files of one album and measure their ReplayGain loudness.
+ * @param track_paths Track file paths or URIs, in album order.
+ * @param out_tracks Output per-track results, parallel to track_paths.
+ * @param out_album Output album result.
+ * @param err Output error text on failure.
+ * @return True on success.
+ */
+bool scan_album_replaygain(
+    const std::vector<std::string>& track_paths,
+    std::vector<ReplayGainScanResult>& out_tracks,
+    ReplayGainScanResult& out_album,
+    std::string& err);
+
+/**
+ * Select front cover image URLs from a Cover Art Archive JSON index.
+ * @param index_json Raw CAA release/release-group index JSON.
+ * @param max_width_px Target cover width; the smallest thumbnail covering it is preferred.
+ * @param out_urls Output URLs in download order (sized thumbnail, then original).
+ * @param err Output error text on failure.
+ * @return True if at least one URL was selected.
+ */
+bool select_caa_front_image_urls(
+    const std::string& index_json,
+    int max_width_px,
+    std::vector<std::string>& out_urls,
+    std::string& err);
+
+/**
+ * Select the primary image URL from a Discogs release JSON payload.
+ * @param release_json Raw Discogs release JSON.
+ * @param max_width_px Target cover width; the 150px variant is used when it suffices.
+ * @param out_url Output image URL.
+ * @param err Output error text on failure.
+ * @return True if an image URL was selected.
+ */
+bool select_discogs_front_image_url(
+    const std::string& release_json,
+    int max_width_px,
+    std::string& out_url,
+    std::string& err);
+
+/**
+ * Allocate immutable cover art bytes that can be shared between entries.
+ * @param bytes Source image bytes.
+ * @param size Number of bytes.
+ * @return New buffer (one reference), or null when empty.
+ */
+const uint8_t* make_shared_cover_art_data(
+    const uint8_t* bytes,
+    size_t size);
+
+/**
+ * Add a reference to cover art bytes instead of copying them.
+ * The count is kept beside the buffer, which stays a plain new[] allocation.
+ * @param data Cover art bytes allocated with new[].
+ * @return The same pointer.
+ */
+const uint8_t* retain_cover_art_data(
+    const uint8_t* data);
+
+/**
+ * Drop a reference to cover art bytes; the last reference frees them with delete[].
+ * @param data Cover art bytes allocated with new[].
+ */
+void release_cover_art_data(
+    const uint8_t* data);
+
+/**
+ * Build the PICTURE block embedded into each track for the current embed mode.
+ * @param art Album cover art (normalized PNG).
+ * @param out_block Output block; null when nothing should be embedded.
+ * @param err Output error text on failure.
+ * @return True on success (including "nothing to embed").
+ */
+bool build_track_picture_block(
+    const CdRipCoverArt& art,
+    FLAC__StreamMetadata*& out_block,
+    std::string& err);
+
+/**
+ * Resolve the album cover file path that sits next to a track file.
+ * @param track_path Track path or URI.
+ * @return Path or URI of "cover.png" in the same directory.
+ */
+std::string resolve_album_cover_path(
+    const std::string& track_path);
+
+/**
+ * Publish album cover art as a standalone image file (atomic replace).
+ * @param art Album cover art (normalized PNG).
+ * @param destination_path Destination path or URI.
+ * @param err Output error text on failure.
+ * @return True on success.
+ */
+bool publish_album_cover_file(
+    const CdRipCoverArt& art,
+    const std::string& destination_path,
+    std::string& err);
+
+/**
+ * Load a normalized cover art PNG from the on-disk cache.
+ * @param source Cover art source label (e.g. "caa-release", "discogs").
+ * @param id Source specific release identifier.
+ * @param max_width_px Max width the image was normalized for.
+ * @param out_png Output PNG bytes.
+ * @return True on cache hit.
+ */
+bool load_cached_cover_art(
+    const std::string& source,
+    const std::string& id,
+    int max_width_px,
+    std::vector<uint8_t>& out_png);
+
+/**
+ * Store a normalized cover art PNG into the on-disk cache (no-op when disabled).
+ * @param source Cover art source label.
+ * @param id Source specific release identifier.
+ * @param max_width_px Max width the image was normalized for.
+ * @param png Normalized PNG bytes.
+ */
+void store_cached_cover_art(
+    const std::string& source,
+    const std::string& id,
+    int max_width_px,
+    const std::vector<uint8_t>& png);
+
+static inline bool is_uri(
+    const std::string& path) {
+
+    return path.find("://") != std::string::npos;
+}
+
+// Index files are tab separated; escape the separators so any path or tag value survives.
+static inline std::string escape_index_field(
+    const std::string& value) {
+
+    std::string out;
+    out.reserve(value.size());
+    for (const char ch : value) {
+        switch (ch) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += ch; break;
+        }
+    }
+    return out;
+}
+
+static inline std::string unescape_index_field(
+    const std::string& value) {
+
+    std::string out;
+    out.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        const char ch = value[i];
+        if (ch != '\\' || i + 1 >= value.size()) {
+            out += ch;
+            continue;
+        }
+        const char next = value[++i];
+        switch (next) {
+            case 't': out += '\t'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            default: out += next; break;
+        }
+    }
+    return out;
+}
+
+static inline std::vector<std::string> split_index_fields(
+    const std::string& line) {
+
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        const size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+        if (tab == std::string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+struct FlacGioStreams;
+
+/**
+ * FLAC metadata chain of a local file or a GIO URI.
+ * URIs are read through ranged stream reads, so audio frames are never fetched;
+ * writes go in place when the padding suffices.
+ */
+class FlacMetadataFile {
+public:
+    FlacMetadataFile();
+    ~FlacMetadataFile();
+    FlacMetadataFile(const FlacMetadataFile&) = delete;
+    FlacMetadataFile& operator=(const FlacMetadataFile&) = delete;
+
+    /**
+     * Read the metadata chain.
+     * @param path Local path or GIO URI.
+     * @param writable True when write() will be called.
+     * @param err Output error text on failure.
+     * @return True on success.
+     */
+    bool open(
+        const std::string& path,
+        bool writable,
+        std::string& err);
+
+    /** Metadata chain (valid after a successful open). */
+    FLAC__Metadata_Chain* chain() const { return chain_; }
+
+    /**
+     * Write the (modified) chain back.
+     * @param err Output error text on failure.
+     * @return True on success.
+     */
+    bool write(
+        std::string& err);
+
+private:
+    std::string path_;
+    FLAC__Metadata_Chain* chain_{nullptr};
+    std::unique_ptr<FlacGioStreams> gio_;
+};
+
+/**
+ * Continue a CRC-32 over 16-bit PCM samples (little-endian byte order).
+ * @param crc Previous value (0 to start).
+ * @param samples Interleaved samples.
+ * @param count Number of samples (not frames).
+ * @return Updated CRC.
+ */
+uint32_t update_pcm_crc32(
+    uint32_t crc,
+    const int16_t* samples,
+    size_t count);
+
+/**
+ * Format a PCM CRC-32 as the tag value.
+ * @param crc CRC value.
+ * @return Eight upper-case hex digits.
+ */
+std::string format_pcm_crc32(
+    uint32_t crc);
+
+/** Vorbis comments holding a track's AccurateRip checksums and database result. */
+static constexpr const char* kAccurateRipV1TagKey = "ACCURATERIP_CRC_V1";
+static constexpr const char* kAccurateRipV2TagKey = "ACCURATERIP_CRC_V2";
+static constexpr const char* kAccurateRipResultTagKey = "ACCURATERIP_RESULT";
+static constexpr const char* kAccurateRipOffsetTagKey = "ACCURATERIP_READ_OFFSET";
+
+static inline bool is_accuraterip_tag_key(
+    const std::string& key_upper) {
+
+    return key_upper == kAccurateRipV1TagKey
+        || key_upper == kAccurateRipV2TagKey
+        || key_upper == kAccurateRipResultTagKey
+        || key_upper == kAccurateRipOffsetTagKey;
+}
+
+/** Running AccurateRip v1/v2 checksums of one track. */
+struct AccurateRipChecksum {
+    uint64_t position{0};
+    uint64_t check_from{0};
+    uint64_t check_to{0};
+    uint32_t v1{0};
+    uint32_t v2{0};
+};
+
+/**
+ * Start AccurateRip checksums for a track.
+ * The first track skips its first five sectors and the last track its last five, as AccurateRip does.
+ * @param state Checksum state to reset.
+ * @param total_frames Stereo frames in the track.
+ * @param first_track True for the first audio track of the disc.
+ * @param last_track True for the last audio track of the disc.
+ */
+void begin_accuraterip_checksum(
+    AccurateRipChecksum& state,
+    uint64_t total_frames,
+    bool first_track,
+    bool last_track);
+
+/**
+ * Continue AccurateRip checksums over interleaved 16-bit stereo PCM.
+ * @param state Checksum state.
+ * @param samples Interleaved samples.
+ * @param frames Number of stereo frames.
+ */
+void update_accuraterip_checksum(
+    AccurateRipChecksum& state,
+    const int16_t* samples,
+    size_t frames);
+
+/** AccurateRip disc identifiers (also the database file name). */
+struct AccurateRipDiscIds {
+    unsigned track_count{0};
+    uint32_t id1{0};
+    uint32_t id2{0};
+    uint32_t cddb{0};
+};
+
+/**
+ * Compute the AccurateRip identifiers of a disc.
+ * @param toc Disc TOC (audio tracks only).
+ * @param out Output identifiers.
+ * @return False when the TOC is unusable.
+ */
+bool compute_accuraterip_disc_ids(
+    const CdRipDiscToc* toc,
+    AccurateRipDiscIds& out);
+
+/**
+ * Database path of a disc relative to the AccurateRip root, e.g. "a/b/c/dBAR-012-....bin".
+ * @param ids Disc identifiers.
+ * @return Relative path.
+ */
+std::string accuraterip_db_relative_path(
+    const AccurateRipDiscIds& ids);
+
+/** One submission for a track in an AccurateRip database file. */
+struct AccurateRipDbEntry {
+    unsigned confidence{0};
+    uint32_t crc{0};
+};
+
+/**
+ * Parse an AccurateRip database file; every pressing matching the disc is collected.
+ * @param data File contents.
+ * @param ids Disc identifiers to match.
+ * @param out_tracks Output entries per track (index 0 = first audio track).
+ * @param err Output error text on failure.
+ * @return True on success.
+ */
+bool parse_accuraterip_db(
+    const std::vector<uint8_t>& data,
+    const AccurateRipDiscIds& ids,
+    std::vector<std::vector<AccurateRipDbEntry>>& out_tracks,
+    std::string& err);
+
+/**
+ * Check a track's checksums against the configured AccurateRip database.
+ * The database of the last disc is cached, so it is fetched once per disc.
+ * @param toc Disc TOC.
+ * @param track_index Index of the track within the TOC.
+ * @param checksum Final checksums of the track.
+ * @param out_result Output result text for the tag (empty when no database is configured).
+ * @return False when no database is configured.
+ */
+bool check_accuraterip(
+    const CdRipDiscToc* toc,
+    size_t track_index,
+    const AccurateRipChecksum& checksum,
+    std::string& out_result);
+
+/** Vorbis comment key listing disc sectors (LBA ranges) that exhausted the read budget or never read cleanly. */
+static constexpr const char* kDamagedSectorsTagKey = "CDRIP_DAMAGED_SECTORS";
+
+/** A track read ahead by salvage mode. */
+struct SalvageTrack {
+    int number{0};
+    long start{0};
+    long sectors{0};
+    /** Position of the track's first sector in the spool file. */
+    long spool_sector{0};
+    CdRipReadStats stats{};
+    /** Sectors read again by the retry passes. */
+    long retried_sectors{0};
+    /** Ranges (first sector relative to the track, sector count) that never read cleanly. */
+    std::vector<std::pair<long, long>> damaged{};
+    /** Set once the track was encoded from the spool. */
+    bool encoded{false};
+};
+
+/** Offset-corrected audio of a whole disc, in a temporary file removed with the spool. */
+struct SalvageSpool {
+    std::string discid{};
+    std::string path{};
+    std::fstream file{};
+    std::vector<SalvageTrack> tracks{};
+
+    ~SalvageSpool() {
+        file.close();
+        remove_local_file_quietly(path);
+    }
+};
+
+bool salvage_disc(
+    CdRip* rip,
+    const CdRipDiscToc* toc,
+    const CdRipDiagnosticObserver* observer,
+    CdRipProgressCallback progress,
+    std::string& err);
+
+/**
+ * One extra output of a track. Chunks are handed over through a bounded queue to a worker thread
+ * that encodes them into a local temporary file; the file is published once every output of the
+ * track was finished.
+ * An output that was not published is removed on destruction.
+ */
+class OutputSink {
+public:
+    OutputSink(
+        const OutputSinkConfig& config,
+        std::string destination);
+    ~OutputSink();
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    /**
+     * Create the temporary file, write its header or FLAC metadata and start the worker.
+     * @param tags Vorbis tags of the track (FLAC only).
+     * @param cover_art Cover art to embed (FLAC only).
+     * @param toc Disc TOC, for the CUESHEET and SEEKTABLE of a disc image.
+     * @param track Track to write (the image track for a disc image).
+     * @param disc_image Write a disc image.
+     * @param err Output error text on failure.
+     * @return true on success.
+     */
+    bool start(
+        const std::map<std::string, std::string>& tags,
+        const CdRipCoverArt& cover_art,
+        const CdRipDiscToc* toc,
+        const CdRipTrackInfo& track,
+        bool disc_image,
+        std::string& err);
+
+    /**
+     * Queue interleaved 16-bit stereo frames; blocks while the queue is full.
+     * @param pcm Interleaved samples.
+     * @param frames Stereo frames.
+     * @param err Output error text when the worker failed.
+     * @return true on success.
+     */
+    bool push(
+        const int16_t* pcm,
+        size_t frames,
+        std::string& err);
+
+    /**
+     * Drain the queue, finish the temporary file and merge the measured tags (FLAC only).
+     * A WAV/AIFF header is rewritten when the frames written differ from the track length.
+     * @param measured_tags Tags measured from the audio.
+     * @param err Output error text on failure.
+     * @return true on success.
+     */
+    bool finish(
+        const std::map<std::string, std::string>& measured_tags,
+        std::string& err);
+
+    /**
+     * Move the finished file to its destination.
+     * @param err Output error text on failure.
+     * @return true on success.
+     */
+    bool publish(
+        std::string& err);
+
+    const std::string& destination() const;
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+/** Vorbis comment key holding the read quality summary of a track (read telemetry only). */
+static constexpr const char* kReadQualityTagKey = "CDRIP_READ_QUALITY";
+
+/** Tags measured from the audio while ripping; a metadata refresh keeps them. */
+static inline bool is_measured_tag_key(
+    const std::string& key_upper) {
+
+    return key_upper == kPcmCrc32TagKey
+        || key_upper == kReadQualityTagKey
+        || key_upper == kDamagedSectorsTagKey
+        || is_accuraterip_tag_key(key_upper);
+}
+
+/** Upper bounds (seconds) of the sector read time buckets; the last bucket is open. */
+static constexpr double kReadTimeBucketBounds[CDRIP_READ_TIME_BUCKETS - 1] = {
+    0.001, 0.002, 0.005, 0.02, 0.1, 0.5, 2.0,
+};
+
+/** Add one sector read to the telemetry; runs on the read thread only, so no locking. */
+static inline void record_sector_read(
+    CdRipReadTelemetry& telemetry,
+    double seconds) {
+
+    int bucket = 0;
+    while (bucket < CDRIP_READ_TIME_BUCKETS - 1 && seconds >= kReadTimeBucketBounds[bucket]) ++bucket;
+    ++telemetry.sector_time_histogram[bucket];
+    ++telemetry.sectors_read;
+    telemetry.read_seconds += seconds;
+    if (seconds > telemetry.slowest_sector_sec) telemetry.slowest_sector_sec = seconds;
+}
+
+/**
+ * Format telemetry as the CDRIP_READ_QUALITY tag value.
+ * @param telemetry Track telemetry.
+ * @return Space separated key=value summary.
+ */
+std::string format_read_quality_tag(
+    const CdRipReadTelemetry& telemetry);
+
+/**
+ * Build the JSON read report of a disc.
+ * @param toc Disc TOC (nullable).
+ * @param device Drive the disc was read from.
+ * @param tracks Telemetry per ripped track.
+ * @return JSON text.
+ */
+std::string build_read_report_json(
+    const CdRipDiscToc* toc,
+    const std::string& device,
+    const std::vector<CdRipReadTelemetry>& tracks);
+
+/**
+ * Resolve the read report location for a track file (same directory).
+ * @param track_path Track file path or URI.
+ * @return Report path or URI.
+ */
+std::string resolve_read_report_path(
+    const std::string& track_path);
+
+/**
+ * Keep the telemetry of a finished track for the read report and summarize it to the observer.
+ * @param rip Ripper handle.
+ * @param toc Disc TOC the track belongs to.
+ * @param telemetry Final telemetry of the track.
+ */
+void finish_track_read_telemetry(
+    CdRip* rip,
+    const CdRipDiscToc* toc,
+    const CdRipReadTelemetry& telemetry);
+
+/** Stream properties and checks of a decoded FLAC file. */
+struct FlacDecodeResult {
+    unsigned sample_rate{0};
+    unsigned channels{0};
+    unsigned bits_per_sample{0};
+    uint64_t total_samples{0};
+    uint64_t decoded_samples{0};
+    bool has_md5{false};
+    bool md5_checked{false};
+    bool md5_ok{false};
+    uint8_t md5[16]{};
+};
+
+/**
+ * Receives decoded PCM: interleaved samples, frame count, channels and bits per sample.
+ * Returning false aborts decoding.
+ */
+using FlacPcmSink = std::function<bool(const FLAC__int32*, size_t, unsigned, unsigned)>;
+
+/**
+ * Decode a FLAC file or URI from start to end with large sequential reads.
+ * A STREAMINFO MD5 mismatch is reported through out.md5_ok, not as a failure.
+ * @param path File path or URI.
+ * @param check_md5 Compare decoded audio against the STREAMINFO MD5.
+ * @param sink PCM receiver (may be empty to only decode).
+ * @param out Output stream properties and check results.
+ * @param err Output error text on failure.
+ * @return True when the whole stream decoded.
+ */
+bool decode_flac_file(
+    const std::string& path,
+    bool check_md5,
+    const FlacPcmSink& sink,
+    FlacDecodeResult& out,
+    std::string& err);
+
+/** Outcome of recompressing one FLAC file. */
+struct FlacRecompressResult {
+    uint64_t original_bytes{0};
+    uint64_t recompressed_bytes{0};
+    bool replaced{false};
+    /** The source was modified while it was re-encoded, so it was left alone. */
+    bool changed{false};
+};
+
+/**
+ * Re-encode a FLAC file at a higher compression level and replace it when smaller.
+ * Every metadata block is kept; the new stream must decode to the original MD5 before it is published.
+ * @param path File path or URI.
+ * @param compression_level FLAC compression level (0-8).
+ * @param exhaustive_model_search Enable the encoder's exhaustive model search.
+ * @param out Output sizes and whether the file was replaced.
+ * @param err Output error text on failure.
+ * @return True on success (including when the file was kept because it did not shrink or changed meanwhile).
+ */
+bool recompress_flac_file(
+    const std::string& path,
+    int compression_level,
+    bool exhaustive_model_search,
+    FlacRecompressResult& out,
+    std::string& err);
+
+/**
+ * Read the Vorbis comments of a FLAC file or URI.
+ * @param path File path or URI.
+ * @param out Output tags keyed by upper-case name.
+ * @return True when a comment block was read.
+ */
+bool read_flac_vorbis_tags(
+    const std::string& path,
+    std::map<std::string, std::string>& out);
+
+/** Tag subset of one FLAC file remembered by the scan index. */
+struct ScanIndexEntry {
+    uint64_t size{0};
+    int64_t mtime_ns{0};
+    uint64_t inode{0};
+    std::map<std::string, std::string> tags;
+};
+
+/** Scan index keyed by absolute file path. */
+using ScanIndex = std::map<std::string, ScanIndexEntry>;
+
+/**
+ * Get the scan index path configured by cdrip_set_scan_index.
+ * @return Index file path, or empty when disabled.
+ */
+std::string get_scan_index_path();
+
+/**
+ * Read size, mtime and inode of a file.
+ * @param path File path.
+ * @param out Entry receiving the identity fields (tags untouched).
+ * @return True on success.
+ */
+bool stat_scan_identity(
+    const std::string& path,
+    ScanIndexEntry& out);
+
+/**
+ * Load the scan index; a missing or unreadable index yields an empty one.
+ * @param index_path Index file path.
+ * @param out Output index.
+ * @return True when an index file was loaded.
+ */
+bool load_scan_index(
+    const std::string& index_path,
+    ScanIndex& out);
+
+/**
+ * Save the scan index atomically.
+ * @param index_path Index file path.
+ * @param index Index to save.
+ * @param err Output error text on failure.
+ * @return True on success.
+ */
+bool save_scan_index(
+    const std::string& index_path,
+    const ScanIndex& index,
+    std::string& err);
+
+/**
+ * Build archive index keys of a disc; the same disc yields the same keys whether
+ * the TOC was read from the drive or rebuilt from the requery seed tags.
+ * @param toc Disc TOC.
+ * @return Keys (MusicBrainz disc id first), empty when the TOC has no identifiers.
+ */
+std::vector<std::string> build_archive_keys(
+    const CdRipDiscToc* toc);
+
+/**
+ * Rewrite the tags of a FLAC file from CDDB metadata.
+ * Without an entry, only extra_tags are set on the existing comments and everything else is kept.
+ * @param path File path or URI.
+ * @param toc Disc TOC (may be null without an entry).
+ * @param track_number Track number (1-based).
+ * @param entry Metadata entry (nullable).
+ * @param extra_tags Tags overriding the generated ones.
+ * @param preserve_replaygain_tags Keep existing REPLAYGAIN_* tags.
+ * @param err Output error text on failure.
+ * @param dry_run Only compute whether the file would change.
+ * @param out_changed Optional output: whether the tags differ.
+ * @return True on success.
+ */
 bool update_flac_tags(
     const std::string& path,
     const CdRipDiscToc* toc,
@@ -554,7 +1382,33 @@ bool update_flac_tags(
     const CdRipCddbEntry* entry,
     const std::map<std::string, std::string>& extra_tags,
     bool preserve_replaygain_tags,
-    std::string& err);
+    std::string& err,
+    bool dry_run = false,
+    bool* out_changed = nullptr);
+
+/**
+ * Choose the compression level for the next track in adaptive mode.
+ * Compares the encoder time of the last track with the time the drive took to deliver its sectors.
+ * @param current_level Level used for the last track (0-8).
+ * @param encode_cpu_sec Encoder seconds spent on the last track (thread CPU time, or wall time
+ *        inside the encoder when it runs on several threads).
+ * @param read_wall_sec Wall-clock seconds spent reading the last track's sectors.
+ * @return Level for the next track (0-8).
+ */
+int next_adaptive_compression_level(
+    int current_level,
+    double encode_cpu_sec,
+    double read_wall_sec);
+
+/**
+ * Resolve the FLAC encoder thread count for a track.
+ * @param requested Requested threads (<=0 => auto).
+ * @param speed_fast Drive runs at maximum speed.
+ * @return Threads to use; always 1 when libFLAC was built without multithreading support.
+ */
+unsigned resolve_encoder_threads(
+    int requested,
+    bool speed_fast);
 
 bool rip_track_with_options(
     CdRip* rip,
@@ -0,0 +1,445 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cdio/cdio.h>
+#include <FLAC++/encoder.h>
+
+#include "internal.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr int kBitsPerSample = 16;
+constexpr int kSampleRate = 44100;
+constexpr int kSamplesPerSector = CDIO_CD_FRAMESIZE_RAW / (kChannels * sizeof(int16_t));
+constexpr uint32_t kBytesPerFrame = kChannels * sizeof(int16_t);
+
+// Chunks waiting per output; a slow encoder holds the reader back instead of buffering the track.
+constexpr size_t kSinkQueueChunks = 4;
+
+static void put_le16(
+    std::string& out,
+    uint16_t value) {
+
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+static void put_le32(
+    std::string& out,
+    uint32_t value) {
+
+    put_le16(out, static_cast<uint16_t>(value & 0xFFFF));
+    put_le16(out, static_cast<uint16_t>(value >> 16));
+}
+
+static void put_be16(
+    std::string& out,
+    uint16_t value) {
+
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+    out.push_back(static_cast<char>(value & 0xFF));
+}
+
+static void put_be32(
+    std::string& out,
+    uint32_t value) {
+
+    put_be16(out, static_cast<uint16_t>(value >> 16));
+    put_be16(out, static_cast<uint16_t>(value & 0xFFFF));
+}
+
+static std::string wav_header(
+    uint32_t frames) {
+
+    const uint32_t data_bytes = frames * kBytesPerFrame;
+    std::string out = "RIFF";
+    put_le32(out, 36 + data_bytes);
+    out += "WAVEfmt ";
+    put_le32(out, 16);
+    put_le16(out, 1);  // PCM
+    put_le16(out, kChannels);
+    put_le32(out, kSampleRate);
+    put_le32(out, kSampleRate * kBytesPerFrame);
+    put_le16(out, static_cast<uint16_t>(kBytesPerFrame));
+    put_le16(out, kBitsPerSample);
+    out += "data";
+    put_le32(out, data_bytes);
+    return out;
+}
+
+static std::string aiff_header(
+    uint32_t frames) {
+
+    const uint32_t data_bytes = frames * kBytesPerFrame;
+    std::string out = "FORM";
+    put_be32(out, 4 + (8 + 18) + (8 + 8 + data_bytes));
+    out += "AIFFCOMM";
+    put_be32(out, 18);
+    put_be16(out, kChannels);
+    put_be32(out, frames);
+    put_be16(out, kBitsPerSample);
+    // 44100 as an 80-bit IEEE extended float.
+    static const unsigned char kRate[10] = {0x40, 0x0E, 0xAC, 0x44, 0, 0, 0, 0, 0, 0};
+    out.append(reinterpret_cast<const char*>(kRate), sizeof(kRate));
+    out += "SSND";
+    put_be32(out, 8 + data_bytes);
+    put_be32(out, 0);  // offset
+    put_be32(out, 0);  // block size
+    return out;
+}
+
+static const char* temp_name_template(
+    CdRipOutputKinds kind) {
+
+    switch (kind) {
+        case CDRIP_OUTPUT_WAV:
+            return "cdripXXXXXX.wav";
+        case CDRIP_OUTPUT_AIFF:
+            return "cdripXXXXXX.aiff";
+        case CDRIP_OUTPUT_RAW:
+            return "cdripXXXXXX.pcm";
+        case CDRIP_OUTPUT_FLAC:
+        default:
+            return "cdripXXXXXX.flac";
+    }
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+struct OutputSink::State {
+    OutputSinkConfig config{};
+    std::string destination{};
+    std::string temp_path{};
+
+    std::unique_ptr<FLAC::Encoder::File> encoder{};
+    std::vector<FLAC__StreamMetadata*> blocks{};
+    std::vector<FLAC__int32> left{};
+    std::vector<FLAC__int32> right{};
+    std::ofstream file{};
+    std::string bytes{};
+    // Frames the header was written for, and frames actually handed to the worker.
+    uint64_t header_frames{0};
+    uint64_t written_frames{0};
+
+    std::mutex mutex{};
+    std::condition_variable cv{};
+    std::deque<std::vector<int16_t>> queue{};
+    bool closing{false};
+    std::string error{};
+    std::thread worker{};
+    bool published{false};
+
+    bool write(
+        const std::vector<int16_t>& pcm,
+        std::string& err) {
+
+        const size_t frames = pcm.size() / kChannels;
+        written_frames += frames;
+        if (encoder) {
+            left.resize(frames);
+            right.resize(frames);
+            for (size_t i = 0; i < frames; ++i) {
+                left[i] = pcm[i * 2];
+                right[i] = pcm[i * 2 + 1];
+            }
+            const FLAC__int32* channels[] = {left.data(), right.data()};
+            if (!encoder->process(channels, static_cast<uint32_t>(frames))) {
+                err = "FLAC encoding error on output " + destination;
+                return false;
+            }
+            return true;
+        }
+        // Sample bytes are spelled out so the output does not depend on the host byte order.
+        bytes.clear();
+        for (const int16_t sample : pcm) {
+            const uint16_t value = static_cast<uint16_t>(sample);
+            if (config.kind == CDRIP_OUTPUT_AIFF) {
+                put_be16(bytes, value);
+            } else {
+                put_le16(bytes, value);
+            }
+        }
+        if (!file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+            err = "Failed to write output " + destination;
+            return false;
+        }
+        return true;
+    }
+
+    void run() {
+        while (true) {
+            std::vector<int16_t> chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this]() { return !queue.empty() || closing; });
+                if (queue.empty()) return;
+                chunk = std::move(queue.front());
+                queue.pop_front();
+            }
+            cv.notify_all();
+            std::string err;
+            if (!write(chunk, err)) {
+                std::lock_guard<std::mutex> guard(mutex);
+                error = err;
+                queue.clear();
+                cv.notify_all();
+                return;
+            }
+        }
+    }
+
+    void stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            closing = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    void release() {
+        // The encoder still refers to its metadata blocks until it is gone.
+        encoder.reset();
+        for (auto* block : blocks) FLAC__metadata_object_delete(block);
+        blocks.clear();
+        if (file.is_open()) file.close();
+    }
+};
+
+OutputSink::OutputSink(
+    const OutputSinkConfig& config,
+    std::string destination)
+    : state_(std::make_unique<State>()) {
+
+    state_->config = config;
+    state_->destination = std::move(destination);
+}
+
+OutputSink::~OutputSink() {
+    {
+        std::lock_guard<std::mutex> guard(state_->mutex);
+        state_->queue.clear();
+    }
+    state_->stop();
+    state_->release();
+    if (!state_->published && !state_->temp_path.empty()) {
+        remove_local_file_quietly(state_->temp_path);
+    }
+}
+
+const std::string& OutputSink::destination() const {
+    return state_->destination;
+}
+
+bool OutputSink::start(
+    const std::map<std::string, std::string>& tags,
+    const CdRipCoverArt& cover_art,
+    const CdRipDiscToc* toc,
+    const CdRipTrackInfo& track,
+    bool disc_image,
+    std::string& err) {
+
+    err.clear();
+    State& state = *state_;
+    if (!create_local_temp_file(state.temp_path, err, temp_name_template(state.config.kind))) {
+        return false;
+    }
+    const uint64_t frames = static_cast<uint64_t>(track.end - track.start + 1) * kSamplesPerSector;
+
+    if (state.config.kind == CDRIP_OUTPUT_FLAC) {
+        std::map<std::string, std::string> vorbis_tags = tags;
+        drop_format_only_tags(vorbis_tags);
+        vorbis_tags[kPcmCrc32TagKey] = format_pcm_crc32(0);
+        FLAC__StreamMetadata* vorbis = build_vorbis_comments(vorbis_tags);
+        if (!vorbis) {
+            err = "Failed to create vorbis comment metadata";
+            return false;
+        }
+        state.blocks.push_back(vorbis);
+        if (disc_image) {
+            // The encoder fills in the seek points, so every output needs its own table.
+            FLAC__StreamMetadata* seektable = build_disc_image_seektable(toc, track);
+            if (!seektable) {
+                err = "Failed to create FLAC seek table";
+                return false;
+            }
+            state.blocks.push_back(seektable);
+            FLAC__StreamMetadata* cuesheet = build_disc_image_cuesheet(toc, track, err);
+            if (!cuesheet) return false;
+            state.blocks.push_back(cuesheet);
+        }
+        FLAC__StreamMetadata* picture = nullptr;
+        if (!build_track_picture_block(cover_art, picture, err)) return false;
+        if (picture) state.blocks.push_back(picture);
+
+        state.encoder = std::make_unique<FLAC::Encoder::File>();
+        state.encoder->set_verify(false);
+        state.encoder->set_compression_level(static_cast<uint32_t>(state.config.compression_level));
+        state.encoder->set_channels(kChannels);
+        state.encoder->set_bits_per_sample(kBitsPerSample);
+        state.encoder->set_sample_rate(kSampleRate);
+        state.encoder->set_total_samples_estimate(frames);
+        state.encoder->set_metadata(state.blocks.data(), static_cast<unsigned>(state.blocks.size()));
+        const FLAC__StreamEncoderInitStatus init_status = state.encoder->init(state.temp_path.c_str());
+        if (init_status != FLAC__STREAM_ENCODER_INIT_STATUS_OK) {
+            err = "Failed to init FLAC stream encoder for output " + state.destination +
+                ": init status " + std::to_string(static_cast<int>(init_status));
+            return false;
+        }
+    } else {
+        state.file.open(state.temp_path, std::ios::binary | std::ios::trunc);
+        std::string header;
+        if (state.config.kind == CDRIP_OUTPUT_WAV) {
+            header = wav_header(static_cast<uint32_t>(frames));
+        } else if (state.config.kind == CDRIP_OUTPUT_AIFF) {
+            header = aiff_header(static_cast<uint32_t>(frames));
+        }
+        if (!state.file || !state.file.write(header.data(), static_cast<std::streamsize>(header.size()))) {
+            err = "Failed to open output " + state.temp_path;
+            return false;
+        }
+    }
+
+    state.header_frames = frames;
+    state.worker = std::thread([&state]() { state.run(); });
+    return true;
+}
+
+bool OutputSink::push(
+    const int16_t* pcm,
+    size_t frames,
+    std::string& err) {
+
+    State& state = *state_;
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.cv.wait(lock, [&state]() {
+        return state.queue.size() < kSinkQueueChunks || !state.error.empty();
+    });
+    if (!state.error.empty()) {
+        err = state.error;
+        return false;
+    }
+    state.queue.emplace_back(pcm, pcm + frames * kChannels);
+    lock.unlock();
+    state.cv.notify_all();
+    return true;
+}
+
+bool OutputSink::finish(
+    const std::map<std::string, std::string>& measured_tags,
+    std::string& err) {
+
+    err.clear();
+    State& state = *state_;
+    state.stop();
+    if (!state.error.empty()) {
+        err = state.error;
+        return false;
+    }
+    const bool flac = state.encoder != nullptr;
+    if (flac && !state.encoder->finish()) {
+        err = "Failed to finish FLAC output " + state.destination;
+        return false;
+    }
+    if (!flac && state.written_frames != state.header_frames && state.config.kind != CDRIP_OUTPUT_RAW) {
+        // The header was written from the TOC before any audio; rewrite it for what was written.
+        if (state.written_frames * kBytesPerFrame > 0xFFFFFFFFull - 64) {
+            err = "Output " + state.destination + " is too large for its header";
+            return false;
+        }
+        const uint32_t frames = static_cast<uint32_t>(state.written_frames);
+        const std::string header = state.config.kind == CDRIP_OUTPUT_WAV ? wav_header(frames) : aiff_header(frames);
+        state.file.seekp(0);
+        state.file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+    if (!flac && !state.file.flush()) {
+        err = "Failed to write output " + state.destination;
+        return false;
+    }
+    state.release();
+    if (flac &&
+        !update_flac_tags(
+            state.temp_path,
+            nullptr,
+            0,
+            nullptr,
+            measured_tags,
+            /*preserve_replaygain_tags=*/false,
+            err)) {
+        return false;
+    }
+    return true;
+}
+
+bool OutputSink::publish(
+    std::string& err) {
+
+    err.clear();
+    State& state = *state_;
+    if (!publish_local_file_to_destination(state.temp_path, state.destination, err)) {
+        return false;
+    }
+    remove_local_file_quietly(state.temp_path);
+    state.published = true;
+    return true;
+}
+
+}  // namespace cdrip::detail
+
+/* ------------------------------------------------------------------- */
+/* Exported API functions */
+
+extern "C" {
+
+int cdrip_add_output(
+    CdRip* cdrip,
+    CdRipOutputKinds kind,
+    const char* format,
+    int compression_level,
+    const char** error) {
+
+    clear_error(error);
+    if (!cdrip || !format || !format[0]) {
+        set_error(error, "Output needs a ripper handle and a format");
+        return 0;
+    }
+    if (kind < CDRIP_OUTPUT_FLAC || kind > CDRIP_OUTPUT_RAW) {
+        set_error(error, "Unknown output kind");
+        return 0;
+    }
+    if (kind == CDRIP_OUTPUT_FLAC && (compression_level < 0 || compression_level > 8)) {
+        set_error(error, "FLAC output compression level must be 0-8");
+        return 0;
+    }
+    OutputSinkConfig config{};
+    config.kind = kind;
+    config.format = format;
+    config.compression_level = compression_level;
+    cdrip->outputs.push_back(std::move(config));
+    return 1;
+}
+
+void cdrip_clear_outputs(
+    CdRip* cdrip) {
+
+    if (!cdrip) return;
+    cdrip->outputs.clear();
+}
+
+};
@@ -0,0 +1,94 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "internal.h"
+
+namespace {
+
+// CRC-32 (IEEE 802.3, reflected), the same checksum EAC reports as "Copy CRC".
+static std::array<uint32_t, 256> build_crc32_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < table.size(); ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (0xEDB88320u ^ (crc >> 1)) : (crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+const std::array<uint32_t, 256> kCrc32Table = build_crc32_table();
+
+static inline uint32_t crc32_byte(
+    uint32_t crc,
+    uint8_t byte) {
+
+    return kCrc32Table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+uint32_t update_pcm_crc32(
+    uint32_t crc,
+    const int16_t* samples,
+    size_t count) {
+
+    // Hashed as little-endian bytes, the order CD audio is read in.
+    crc = ~crc;
+    for (size_t i = 0; i < count; ++i) {
+        const uint16_t sample = static_cast<uint16_t>(samples[i]);
+        crc = crc32_byte(crc, static_cast<uint8_t>(sample & 0xFF));
+        crc = crc32_byte(crc, static_cast<uint8_t>(sample >> 8));
+    }
+    return ~crc;
+}
+
+std::string format_pcm_crc32(
+    uint32_t crc) {
+
+    char buf[9];
+    std::snprintf(buf, sizeof(buf), "%08X", static_cast<unsigned int>(crc));
+    return std::string{buf};
+}
+
+void begin_accuraterip_checksum(
+    AccurateRipChecksum& state,
+    uint64_t total_frames,
+    bool first_track,
+    bool last_track) {
+
+    constexpr uint64_t kSkipFrames = 5 * 588;
+    state = AccurateRipChecksum{};
+    state.check_from = first_track ? kSkipFrames : 1;
+    state.check_to = (last_track && total_frames > kSkipFrames) ? total_frames - kSkipFrames : total_frames;
+}
+
+void update_accuraterip_checksum(
+    AccurateRipChecksum& state,
+    const int16_t* samples,
+    size_t frames) {
+
+    for (size_t i = 0; i < frames; ++i) {
+        // Positions are 1-based; a frame is left | right << 16 as read from the disc.
+        const uint64_t position = ++state.position;
+        if (position < state.check_from || position > state.check_to) continue;
+        const uint32_t frame =
+            static_cast<uint32_t>(static_cast<uint16_t>(samples[i * 2])) |
+            (static_cast<uint32_t>(static_cast<uint16_t>(samples[i * 2 + 1])) << 16);
+        const uint64_t product = static_cast<uint64_t>(frame) * position;
+        state.v1 += static_cast<uint32_t>(product);
+        state.v2 += static_cast<uint32_t>(product) + static_cast<uint32_t>(product >> 32);
+    }
+}
+
+}  // namespace cdrip::detail
@@ -0,0 +1,251 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <json-glib/json-glib.h>
+
+#include "internal.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+static long milliseconds(
+    double seconds) {
+
+    return static_cast<long>(seconds * 1000.0 + 0.5);
+}
+
+static void add_int_member(
+    JsonBuilder* builder,
+    const char* name,
+    gint64 value) {
+
+    json_builder_set_member_name(builder, name);
+    json_builder_add_int_value(builder, value);
+}
+
+static void add_telemetry_members(
+    JsonBuilder* builder,
+    const CdRipReadTelemetry& telemetry) {
+
+    const CdRipReadStats& stats = telemetry.stats;
+    add_int_member(builder, "sectors_read", telemetry.sectors_read);
+    add_int_member(builder, "reread_sectors", telemetry.reread_sectors);
+    add_int_member(builder, "read_ms", milliseconds(telemetry.read_seconds));
+    add_int_member(builder, "slowest_sector_ms", milliseconds(telemetry.slowest_sector_sec));
+    json_builder_set_member_name(builder, "events");
+    json_builder_begin_object(builder);
+    add_int_member(builder, "verified", stats.verified);
+    add_int_member(builder, "fixups", stats.fixups);
+    add_int_member(builder, "scratches", stats.scratches);
+    add_int_member(builder, "skips", stats.skips);
+    add_int_member(builder, "drifts", stats.drifts);
+    add_int_member(builder, "read_errors", stats.read_errors);
+    json_builder_end_object(builder);
+    add_int_member(builder, "escalations", stats.escalations);
+    add_int_member(builder, "escalated_sectors", stats.escalated_sectors);
+    json_builder_set_member_name(builder, "sector_time_histogram");
+    json_builder_begin_array(builder);
+    for (int i = 0; i < CDRIP_READ_TIME_BUCKETS; ++i) {
+        json_builder_add_int_value(builder, telemetry.sector_time_histogram[i]);
+    }
+    json_builder_end_array(builder);
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+std::string format_read_quality_tag(
+    const CdRipReadTelemetry& telemetry) {
+
+    const CdRipReadStats& stats = telemetry.stats;
+    std::ostringstream oss;
+    oss << "sectors=" << telemetry.sectors_read
+        << " rereads=" << telemetry.reread_sectors
+        << " fixups=" << stats.fixups
+        << " scratches=" << stats.scratches
+        << " skips=" << stats.skips
+        << " drifts=" << stats.drifts
+        << " read_errors=" << stats.read_errors
+        << " slowest_ms=" << milliseconds(telemetry.slowest_sector_sec);
+    return oss.str();
+}
+
+std::string build_read_report_json(
+    const CdRipDiscToc* toc,
+    const std::string& device,
+    const std::vector<CdRipReadTelemetry>& tracks) {
+
+    CdRipReadTelemetry total{};
+    for (const auto& track : tracks) {
+        total.sectors_read += track.sectors_read;
+        total.reread_sectors += track.reread_sectors;
+        total.read_seconds += track.read_seconds;
+        total.slowest_sector_sec = std::max(total.slowest_sector_sec, track.slowest_sector_sec);
+        total.stats.verified += track.stats.verified;
+        total.stats.fixups += track.stats.fixups;
+        total.stats.scratches += track.stats.scratches;
+        total.stats.skips += track.stats.skips;
+        total.stats.drifts += track.stats.drifts;
+        total.stats.read_errors += track.stats.read_errors;
+        total.stats.escalations += track.stats.escalations;
+        total.stats.escalated_sectors += track.stats.escalated_sectors;
+        for (int i = 0; i < CDRIP_READ_TIME_BUCKETS; ++i) {
+            total.sector_time_histogram[i] += track.sector_time_histogram[i];
+        }
+    }
+
+    char* generated_at = cdrip_current_timestamp_iso();
+    JsonBuilder* builder = json_builder_new();
+    json_builder_begin_object(builder);
+    json_builder_set_member_name(builder, "cddb_discid");
+    json_builder_add_string_value(builder, toc ? to_string_or_empty(toc->cddb_discid).c_str() : "");
+    json_builder_set_member_name(builder, "device");
+    json_builder_add_string_value(builder, device.c_str());
+    json_builder_set_member_name(builder, "generated_at");
+    json_builder_add_string_value(builder, to_string_or_empty(generated_at).c_str());
+    cdrip_release_timestamp(generated_at);
+    json_builder_set_member_name(builder, "sector_time_bounds_ms");
+    json_builder_begin_array(builder);
+    for (int i = 0; i + 1 < CDRIP_READ_TIME_BUCKETS; ++i) {
+        json_builder_add_int_value(builder, milliseconds(kReadTimeBucketBounds[i]));
+    }
+    json_builder_end_array(builder);
+    json_builder_set_member_name(builder, "tracks");
+    json_builder_begin_array(builder);
+    for (const auto& track : tracks) {
+        json_builder_begin_object(builder);
+        add_int_member(builder, "track", track.track_number);
+        add_telemetry_members(builder, track);
+        json_builder_end_object(builder);
+    }
+    json_builder_end_array(builder);
+    json_builder_set_member_name(builder, "total");
+    json_builder_begin_object(builder);
+    add_telemetry_members(builder, total);
+    json_builder_end_object(builder);
+    json_builder_end_object(builder);
+
+    JsonNode* root = json_builder_get_root(builder);
+    JsonGenerator* generator = json_generator_new();
+    json_generator_set_root(generator, root);
+    json_generator_set_pretty(generator, TRUE);
+    json_generator_set_indent(generator, 2);
+    gchar* data = json_generator_to_data(generator, nullptr);
+    std::string json = data ? std::string{data} + "\n" : std::string{};
+    g_free(data);
+    g_object_unref(generator);
+    json_node_unref(root);
+    g_object_unref(builder);
+    return json;
+}
+
+std::string resolve_read_report_path(
+    const std::string& track_path) {
+
+    // Same directory as the album's tracks, like cover.png.
+    const auto slash = track_path.find_last_of('/');
+    if (slash == std::string::npos) return "read_report.json";
+    return track_path.substr(0, slash + 1) + "read_report.json";
+}
+
+void finish_track_read_telemetry(
+    CdRip* rip,
+    const CdRipDiscToc* toc,
+    const CdRipReadTelemetry& telemetry) {
+
+    const std::string discid = toc ? to_string_or_empty(toc->cddb_discid) : std::string{};
+    if (rip->telemetry_discid != discid) {
+        rip->telemetry_discid = discid;
+        rip->telemetry_tracks.clear();
+    }
+    // A track ripped again replaces its earlier telemetry.
+    auto it = std::find_if(
+        rip->telemetry_tracks.begin(),
+        rip->telemetry_tracks.end(),
+        [&](const CdRipReadTelemetry& entry) { return entry.track_number == telemetry.track_number; });
+    if (it != rip->telemetry_tracks.end()) {
+        *it = telemetry;
+    } else {
+        rip->telemetry_tracks.push_back(telemetry);
+    }
+
+    if (!has_diagnostic_observer(&rip->telemetry_observer)) return;
+    const long errors = count_read_error_events(telemetry.stats);
+    const std::string message =
+        "Track " + std::to_string(telemetry.track_number) + " read quality: " + format_read_quality_tag(telemetry);
+    CdRipDiagnosticInfo info{};
+    info.severity = errors > 0 ? CDRIP_DIAGNOSTIC_SEVERITY_WARNING : CDRIP_DIAGNOSTIC_SEVERITY_INFO;
+    info.source_label = "read";
+    info.message = message.c_str();
+    notify_diagnostic(&rip->telemetry_observer, nullptr, info);
+}
+
+}  // namespace cdrip::detail
+
+/* ------------------------------------------------------------------- */
+/* Exported API functions */
+
+extern "C" {
+
+void cdrip_set_read_telemetry(
+    CdRip* cdrip,
+    bool enabled,
+    const CdRipDiagnosticObserver* observer) {
+
+    if (!cdrip) return;
+    cdrip->read_telemetry = enabled;
+    cdrip->telemetry_observer = observer ? *observer : CdRipDiagnosticObserver{};
+}
+
+int cdrip_write_read_report(
+    CdRip* cdrip,
+    const CdRipDiscToc* toc,
+    const char* path,
+    const char** error) {
+
+    clear_error(error);
+    if (!cdrip || !path || !path[0]) {
+        set_error(error, "Read report needs a ripper handle and a path");
+        return 0;
+    }
+    const std::string discid = toc ? to_string_or_empty(toc->cddb_discid) : std::string{};
+    std::vector<CdRipReadTelemetry> tracks;
+    if (cdrip->telemetry_discid == discid) tracks = cdrip->telemetry_tracks;
+    std::sort(tracks.begin(), tracks.end(), [](const CdRipReadTelemetry& lhs, const CdRipReadTelemetry& rhs) {
+        return lhs.track_number < rhs.track_number;
+    });
+    const std::string json = build_read_report_json(toc, cdrip->device, tracks);
+
+    std::string err;
+    std::string temp_path;
+    if (!create_local_temp_file(temp_path, err, "cdripXXXXXX.json")) {
+        set_error(error, err);
+        return 0;
+    }
+    GError* gerr = nullptr;
+    if (!g_file_set_contents(temp_path.c_str(), json.data(), static_cast<gssize>(json.size()), &gerr)) {
+        set_error(error, std::string("Failed to write read report: ") + (gerr ? gerr->message : "unknown"));
+        g_clear_error(&gerr);
+        remove_local_file_quietly(temp_path);
+        return 0;
+    }
+    if (!publish_local_file_to_destination(temp_path, path, err)) {
+        set_error(error, err);
+        remove_local_file_quietly(temp_path);
+        return 0;
+    }
+    remove_local_file_quietly(temp_path);
+    return 1;
+}
+
+};
@@ -7,8 +7,10 @@
 #include <cmath>
 #include <iomanip>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "internal.h"
 
@@ -24,6 +26,14 @@ std::string format_gain_db(
     return oss.str();
 }
 
+struct Ebur128StateDeleter {
+    void operator()(ebur128_state* state) const {
+        if (state) ebur128_destroy(&state);
+    }
+};
+
+using Ebur128StatePtr = std::unique_ptr<ebur128_state, Ebur128StateDeleter>;
+
 std::string format_peak_value(
     double peak) {
 
@@ -94,4 +104,76 @@ std::map<std::string, std::string> build_replaygain_tags(
     return tags;
 }
 
+bool scan_album_replaygain(
+    const std::vector<std::string>& track_paths,
+    std::vector<ReplayGainScanResult>& out_tracks,
+    ReplayGainScanResult& out_album,
+    std::string& err) {
+
+    err.clear();
+    out_tracks.clear();
+    out_album = ReplayGainScanResult{};
+    if (track_paths.empty()) {
+        err = "No tracks to scan";
+        return false;
+    }
+
+    Ebur128StatePtr album_state;
+    std::vector<int> scaled;
+    for (const auto& path : track_paths) {
+        Ebur128StatePtr track_state;
+        FlacDecodeResult decoded{};
+        std::string sink_err;
+        const FlacPcmSink sink = [&](const FLAC__int32* samples, size_t frames, unsigned channels, unsigned bits_per_sample) {
+            if (!track_state) {
+                // STREAMINFO precedes the first frame, so the format is known here.
+                if (album_state &&
+                    (album_state->channels != channels || album_state->samplerate != decoded.sample_rate)) {
+                    sink_err = "Album tracks differ in sample rate or channel count";
+                    return false;
+                }
+                track_state.reset(ebur128_init(channels, decoded.sample_rate, EBUR128_MODE_I | EBUR128_MODE_SAMPLE_PEAK));
+                if (!album_state) {
+                    album_state.reset(ebur128_init(channels, decoded.sample_rate, EBUR128_MODE_I | EBUR128_MODE_SAMPLE_PEAK));
+                }
+                if (!track_state || !album_state) {
+                    sink_err = "Failed to create ReplayGain state";
+                    return false;
+                }
+            }
+            if (bits_per_sample == 0 || bits_per_sample > 32) {
+                sink_err = "Unsupported bits per sample";
+                return false;
+            }
+            const unsigned shift = 32 - bits_per_sample;
+            scaled.resize(frames * channels);
+            for (size_t i = 0; i < scaled.size(); ++i) {
+                scaled[i] = static_cast<int>(static_cast<uint32_t>(samples[i]) << shift);
+            }
+            if (ebur128_add_frames_int(track_state.get(), scaled.data(), frames) != EBUR128_SUCCESS ||
+                ebur128_add_frames_int(album_state.get(), scaled.data(), frames) != EBUR128_SUCCESS) {
+                sink_err = "Failed to feed ReplayGain state";
+                return false;
+            }
+            return true;
+        };
+
+        if (!decode_flac_file(path, /*check_md5=*/false, sink, decoded, err)) {
+            if (!sink_err.empty()) err = sink_err + ": " + path;
+            return false;
+        }
+        if (!track_state) {
+            err = "No audio samples: " + path;
+            return false;
+        }
+        ReplayGainScanResult track_result;
+        if (!finalize_replaygain_scan(track_state.get(), track_result, err)) {
+            err += ": " + path;
+            return false;
+        }
+        out_tracks.push_back(track_result);
+    }
+    return finalize_replaygain_scan(album_state.get(), out_album, err);
+}
+
 }
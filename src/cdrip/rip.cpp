@@ -4,10 +4,18 @@
 // https://github.com/kekyo/scheme-cd-ripper
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <ctime>
 #include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
@@ -28,20 +36,396 @@ constexpr int kBitsPerSample = 16;
 constexpr int kSampleRate = 44100;
 constexpr int kSamplesPerSector = CDIO_CD_FRAMESIZE_RAW / (kChannels * sizeof(int16_t));
 
-bool is_uri(
-    const std::string& path) {
+// Adaptive compression: encoder CPU time as a share of the drive's read time.
+// Above the high mark the encoder starts to hold the drive back; below the low mark a
+// higher level (roughly 1.5-2x the work) still leaves headroom.
+constexpr double kAdaptiveEncodeShareHigh = 0.5;
+constexpr double kAdaptiveEncodeShareLow = 0.2;
+// Tracks shorter than this give too noisy a measurement to act on.
+constexpr double kAdaptiveMinReadSec = 2.0;
+
+// Hybrid mode returns to light checks after this many clean ranges (128 sectors each) in full mode.
+constexpr int kHybridDeescalateCleanChunks = 2;
+
+// Read budget steps: the configured checks, overlap checks only, then no checks at all.
+constexpr int kReadDegradeOverlap = 1;
+constexpr int kReadDegradeNone = 2;
+// Retries per sector once a budget is exhausted, instead of paranoia's default of 20.
+constexpr int kDegradedMaxRetries = 3;
+
+// Salvage mode records and retries damage in ranges of this many sectors (~0.4 s of audio).
+constexpr long kSalvageRangeSectors = 32;
+// The first salvage pass gives up on a sector quickly; its ranges are retried later anyway.
+constexpr int kSalvageFastMaxRetries = 1;
+
+// Retry passes of salvage mode, each slower and more thorough than the one before.
+struct SalvagePass {
+    const char* label;
+    CdRipRipModes mode;
+    bool speed_fast;
+    int max_retries;
+};
+constexpr SalvagePass kSalvageRetryPasses[] = {
+    {"overlap checks", RIP_MODES_HYBRID, false, 5},
+    {"full checks", RIP_MODES_BEST, false, 0},
+};
+
+// Beyond this libFLAC's frame pipeline gains little for 44.1 kHz stereo.
+constexpr unsigned kMaxAutoEncoderThreads = 8;
+constexpr unsigned kMaxEncoderThreads = 64;
+
+static double cpu_seconds(
+    clockid_t clock) {
+
+    timespec ts{};
+    if (clock_gettime(clock, &ts) != 0) return 0.0;
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+static double steady_seconds() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Owns a reader that is only needed for part of a track.
+struct ScopedReader {
+    explicit ScopedReader(
+        const DriveBackend& backend)
+        : backend(backend) {}
+
+    ~ScopedReader() {
+        if (reader) backend.destroy_reader(reader);
+    }
+
+    ScopedReader(const ScopedReader&) = delete;
+    ScopedReader& operator=(const ScopedReader&) = delete;
+
+    const DriveBackend& backend;
+    void* reader{nullptr};
+};
+
+// How readers of a track treat failing sectors; shared by all readers of the track.
+struct SectorReadPolicy {
+    // Passed to the backend per read (<=0 => backend default).
+    int max_retries{0};
+    // Unreadable sectors become silence and are recorded instead of failing the track.
+    bool tolerate_errors{false};
+    // Track sectors before the read offset, the base of the TOC.
+    std::vector<long> damaged_sectors{};
+};
+
+// Reports reads that block past the sector budget. A blocked read cannot be interrupted,
+// so this only makes the stall visible; the budget takes effect once the read returns.
+class ReadWatchdog {
+public:
+    ReadWatchdog(
+        double budget_sec,
+        const CdRipDiagnosticObserver* observer,
+        int track_number)
+        : budget_sec_(budget_sec),
+          observer_(observer),
+          track_number_(track_number) {
+
+        if (budget_sec_ > 0.0 && has_diagnostic_observer(observer_)) {
+            thread_ = std::thread([this]() { run(); });
+        }
+    }
+
+    ~ReadWatchdog() {
+        if (!thread_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    ReadWatchdog(const ReadWatchdog&) = delete;
+    ReadWatchdog& operator=(const ReadWatchdog&) = delete;
+
+    void begin(
+        double now) {
+
+        read_started_.store(now, std::memory_order_relaxed);
+        read_sequence_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void end() {
+        read_started_.store(0.0, std::memory_order_relaxed);
+    }
+
+private:
+    void run() {
+        uint64_t reported_sequence = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, std::chrono::milliseconds(500), [this]() { return stopping_; })) {
+            const double started = read_started_.load(std::memory_order_relaxed);
+            const uint64_t sequence = read_sequence_.load(std::memory_order_relaxed);
+            if (started <= 0.0 || sequence == reported_sequence) continue;
+            const double blocked = steady_seconds() - started;
+            if (blocked <= budget_sec_) continue;
+            reported_sequence = sequence;
+            const std::string message = "Track " + std::to_string(track_number_) +
+                ": a sector read has been blocking for " + std::to_string(static_cast<long>(blocked)) +
+                " s (budget " + std::to_string(static_cast<long>(budget_sec_)) + " s)";
+            CdRipDiagnosticInfo info{};
+            info.severity = CDRIP_DIAGNOSTIC_SEVERITY_WARNING;
+            info.source_label = "read";
+            info.message = message.c_str();
+            notify_diagnostic(observer_, nullptr, info);
+        }
+    }
+
+    const double budget_sec_;
+    const CdRipDiagnosticObserver* observer_;
+    const int track_number_;
+    std::atomic<double> read_started_{0.0};
+    std::atomic<uint64_t> read_sequence_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{false};
+    std::thread thread_;
+};
+
+// Formats sorted disc sectors as LBA ranges ("100-103,250").
+static std::string format_sector_ranges(
+    std::vector<long> sectors) {
+
+    std::sort(sectors.begin(), sectors.end());
+    sectors.erase(std::unique(sectors.begin(), sectors.end()), sectors.end());
+    std::ostringstream oss;
+    for (size_t i = 0; i < sectors.size();) {
+        size_t j = i;
+        while (j + 1 < sectors.size() && sectors[j + 1] == sectors[j] + 1) ++j;
+        if (i > 0) oss << ",";
+        oss << sectors[i];
+        if (j > i) oss << "-" << sectors[j];
+        i = j + 1;
+    }
+    return oss.str();
+}
+
+// Delivers the sectors of a track shifted by the drive read offset, so every track starts
+// at its true first sample. Sectors outside the disc cannot be read and count as silence.
+class OffsetSectorReader {
+public:
+    OffsetSectorReader(
+        const DriveBackend& backend,
+        void* reader,
+        long first_sector,
+        long leadout_sector,
+        int offset_samples,
+        CdRipReadStats& stats)
+        : backend_(backend),
+          reader_(reader),
+          stats_(&stats),
+          // Without an offset nothing is read outside the track, so no clamping is needed.
+          leadout_(offset_samples != 0 && leadout_sector > 0 ? leadout_sector : std::numeric_limits<long>::max()) {
+
+        long shift = offset_samples / kSamplesPerSector;
+        int skip = offset_samples % kSamplesPerSector;
+        if (skip < 0) {
+            skip += kSamplesPerSector;
+            --shift;
+        }
+        shift_ = shift;
+        next_sector_ = first_sector + shift;
+        skip_ = skip;
+        if (skip_ > 0) {
+            current_.resize(kSamplesPerSector * kChannels);
+            following_.resize(kSamplesPerSector * kChannels);
+            shifted_.resize(kSamplesPerSector * kChannels);
+        }
+    }
+
+    bool start(
+        std::string& err) {
+
+        const long seek_sector = std::max(0L, next_sector_);
+        if (seek_sector < leadout_ && !backend_.seek_reader(reader_, seek_sector, err)) return false;
+        return skip_ == 0 || read_copy(current_, err);
+    }
+
+    // Continue from another sector of the track, e.g. to read a range again after a mode change.
+    bool restart(
+        long first_sector,
+        std::string& err) {
+
+        next_sector_ = first_sector + shift_;
+        return start(err);
+    }
+
+    void set_policy(
+        SectorReadPolicy* policy) {
+
+        policy_ = policy;
+    }
+
+    // Disc sector of the latest read from the drive, before the read offset.
+    long last_sector() const {
+        return next_sector_ - 1 - shift_;
+    }
+
+    // Track-relative position of the next delivered sector, as a disc sector.
+    long next_output_sector() const {
+        return next_sector_ - shift_ - (skip_ > 0 ? 1 : 0);
+    }
+
+    // Counts further reads into another track's statistics.
+    void set_stats(
+        CdRipReadStats& stats) {
+
+        stats_ = &stats;
+    }
+
+    bool next(
+        const int16_t*& out_buffer,
+        std::string& err) {
+
+        if (skip_ == 0) return read_raw(out_buffer, err);
+        if (!read_copy(following_, err)) return false;
+        const size_t head = static_cast<size_t>(skip_) * kChannels;
+        std::copy(current_.begin() + head, current_.end(), shifted_.begin());
+        std::copy(following_.begin(), following_.begin() + head, shifted_.end() - head);
+        std::swap(current_, following_);
+        out_buffer = shifted_.data();
+        return true;
+    }
+
+private:
+    bool read_raw(
+        const int16_t*& out_buffer,
+        std::string& err) {
+
+        const long sector = next_sector_++;
+        if (sector < 0 || sector >= leadout_) {
+            out_buffer = silence_.data();
+            return true;
+        }
+        if (backend_.read_sector(reader_, policy_ ? policy_->max_retries : 0, out_buffer, *stats_, err)) {
+            return true;
+        }
+        if (!policy_ || !policy_->tolerate_errors) return false;
+        policy_->damaged_sectors.push_back(sector - shift_);
+        out_buffer = silence_.data();
+        err.clear();
+        return true;
+    }
+
+    bool read_copy(
+        std::vector<int16_t>& out,
+        std::string& err) {
+
+        const int16_t* buffer = nullptr;
+        if (!read_raw(buffer, err)) return false;
+        std::copy(buffer, buffer + out.size(), out.begin());
+        return true;
+    }
+
+    const DriveBackend& backend_;
+    void* reader_;
+    CdRipReadStats* stats_;
+    SectorReadPolicy* policy_{nullptr};
+    long leadout_;
+    long shift_{0};
+    long next_sector_{0};
+    int skip_{0};
+    std::vector<int16_t> current_;
+    std::vector<int16_t> following_;
+    std::vector<int16_t> shifted_;
+    std::vector<int16_t> silence_ = std::vector<int16_t>(kSamplesPerSector * kChannels, 0);
+};
+
+static bool write_salvage_spool(
+    SalvageSpool& spool,
+    long spool_sector,
+    const std::vector<int16_t>& pcm,
+    long sectors) {
+
+    spool.file.seekp(static_cast<std::streamoff>(spool_sector) * kSamplesPerSector * kChannels * sizeof(int16_t));
+    spool.file.write(
+        reinterpret_cast<const char*>(pcm.data()),
+        static_cast<std::streamsize>(sectors * kSamplesPerSector * kChannels * sizeof(int16_t)));
+    return static_cast<bool>(spool.file);
+}
+
+static bool read_salvage_spool(
+    SalvageSpool& spool,
+    long spool_sector,
+    std::vector<int16_t>& pcm,
+    long sectors) {
+
+    spool.file.seekg(static_cast<std::streamoff>(spool_sector) * kSamplesPerSector * kChannels * sizeof(int16_t));
+    spool.file.read(
+        reinterpret_cast<char*>(pcm.data()),
+        static_cast<std::streamsize>(sectors * kSamplesPerSector * kChannels * sizeof(int16_t)));
+    return static_cast<bool>(spool.file);
+}
+
+static void notify_salvage(
+    const CdRipDiagnosticObserver* observer,
+    CdRipDiagnosticSeverities severity,
+    const std::string& message) {
+
+    CdRipDiagnosticInfo info{};
+    info.severity = severity;
+    info.source_label = "salvage";
+    info.message = message.c_str();
+    notify_diagnostic(observer, nullptr, info);
+}
+
+// Reports a salvage pass through the rip progress callback; the pass stands in for the track name.
+static void report_salvage_progress(
+    CdRipProgressCallback progress,
+    const SalvageTrack& entry,
+    int total_tracks,
+    const std::string& pass_label,
+    long done_sectors,
+    long total_sectors,
+    long damaged_sectors,
+    std::chrono::steady_clock::time_point pass_start) {
 
-    return path.find("://") != std::string::npos;
+    if (!progress) return;
+    const double done_fraction = total_sectors > 0 ? static_cast<double>(done_sectors) / total_sectors : 1.0;
+    const double wall_elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - pass_start).count();
+    CdRipProgressInfo info{};
+    info.track_number = entry.number;
+    info.total_tracks = total_tracks;
+    info.percent = done_fraction * 100.0;
+    info.elapsed_total_sec = static_cast<double>(done_sectors) * kSamplesPerSector / kSampleRate;
+    info.total_album_sec = static_cast<double>(total_sectors) * kSamplesPerSector / kSampleRate;
+    info.wall_elapsed_sec = wall_elapsed;
+    info.wall_total_sec = done_fraction > 0.0 ? wall_elapsed / done_fraction : 0.0;
+    info.title = pass_label.c_str();
+    info.track_name = pass_label.c_str();
+    info.safe_title = pass_label.c_str();
+    info.compression_level = -1;
+    info.read_stats = &entry.stats;
+    info.damaged_sectors = damaged_sectors;
+    progress(&info);
 }
 
+}
+
+namespace cdrip::detail {
+
+// Reader kept between the tracks of a sequential rip, so an adjacent track continues the same stream.
+struct SequentialReadState {
+    std::string discid{};
+    std::unique_ptr<OffsetSectorReader> reader{};
+};
+
 bool create_local_temp_file(
     std::string& out_path,
-    std::string& err) {
+    std::string& err,
+    const char* name_template) {
 
     err.clear();
     GError* gerr = nullptr;
     gchar* temp_path_c = nullptr;
-    const int temp_fd = g_file_open_tmp("cdripXXXXXX.flac", &temp_path_c, &gerr);
+    const int temp_fd = g_file_open_tmp(name_template, &temp_path_c, &gerr);
     if (temp_fd == -1) {
         err = std::string("Failed to create temporary file: ") +
             (gerr ? gerr->message : "unknown");
@@ -66,10 +450,6 @@ void remove_local_file_quietly(
     std::filesystem::remove(path, ec);
 }
 
-}
-
-namespace cdrip::detail {
-
 bool publish_local_file_to_destination(
     const std::string& local_path,
     const std::string& destination_path,
@@ -160,6 +540,258 @@ bool publish_local_file_to_destination(
     return true;
 }
 
+std::string resolve_album_cover_path(
+    const std::string& track_path) {
+
+    // Works for both local paths and URIs: both use '/' as the separator.
+    const auto slash = track_path.find_last_of('/');
+    if (slash == std::string::npos) return "cover.png";
+    return track_path.substr(0, slash + 1) + "cover.png";
+}
+
+bool publish_album_cover_file(
+    const CdRipCoverArt& art,
+    const std::string& destination_path,
+    std::string& err) {
+
+    err.clear();
+    if (!has_cover_art_data(art)) {
+        err = "No cover art to write";
+        return false;
+    }
+
+    std::string temp_path;
+    if (!create_local_temp_file(temp_path, err, "cdripXXXXXX.png")) {
+        return false;
+    }
+    GError* gerr = nullptr;
+    if (!g_file_set_contents(
+            temp_path.c_str(),
+            reinterpret_cast<const gchar*>(art.data),
+            static_cast<gssize>(art.size),
+            &gerr)) {
+        err = std::string("Failed to write cover art: ") +
+            (gerr ? gerr->message : "unknown");
+        g_clear_error(&gerr);
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+    const bool published = publish_local_file_to_destination(temp_path, destination_path, err);
+    remove_local_file_quietly(temp_path);
+    return published;
+}
+
+unsigned resolve_encoder_threads(
+    int requested,
+    bool speed_fast) {
+
+#ifdef CDRIP_HAVE_FLAC_NUM_THREADS
+    if (requested > 0) return std::min<unsigned>(static_cast<unsigned>(requested), kMaxEncoderThreads);
+    // At 1x the encoder is never the bottleneck, so extra threads would only burn CPU.
+    if (!speed_fast) return 1;
+    const unsigned hw = std::thread::hardware_concurrency();
+    return std::clamp<unsigned>(hw, 1, kMaxAutoEncoderThreads);
+#else
+    (void)requested;
+    (void)speed_fast;
+    return 1;
+#endif
+}
+
+int next_adaptive_compression_level(
+    int current_level,
+    double encode_cpu_sec,
+    double read_wall_sec) {
+
+    const int level = std::clamp(current_level, 0, 8);
+    if (read_wall_sec < kAdaptiveMinReadSec || encode_cpu_sec < 0.0) return level;
+    const double share = encode_cpu_sec / read_wall_sec;
+    if (share > kAdaptiveEncodeShareHigh) {
+        // Well past the mark: step down twice so the next track catches up quickly.
+        return std::max(0, level - (share > 2 * kAdaptiveEncodeShareHigh ? 2 : 1));
+    }
+    if (share < kAdaptiveEncodeShareLow) return std::min(8, level + 1);
+    return level;
+}
+
+bool salvage_disc(
+    CdRip* rip,
+    const CdRipDiscToc* toc,
+    const CdRipDiagnosticObserver* observer,
+    CdRipProgressCallback progress,
+    std::string& err) {
+
+    err.clear();
+    if (!rip || !toc || !toc->tracks) {
+        err = "Invalid arguments to cdrip_salvage_disc";
+        return false;
+    }
+    const DriveBackend& backend =
+        rip->backend ? *rip->backend : current_drive_backend();
+
+    // The passes below move the reader, so a kept sequential stream is no longer where it says.
+    if (rip->sequential) rip->sequential->reader.reset();
+
+    auto spool = std::make_shared<SalvageSpool>();
+    spool->discid = to_string_or_empty(toc->cddb_discid);
+    if (!create_local_temp_file(spool->path, err, "cdripXXXXXX.pcm")) return false;
+    spool->file.open(spool->path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!spool->file) {
+        err = "Failed to open salvage spool " + spool->path;
+        return false;
+    }
+    long spool_sectors = 0;
+    for (size_t i = 0; i < toc->tracks_count; ++i) {
+        const auto& track = toc->tracks[i];
+        if (!track.is_audio || track.end < track.start) continue;
+        SalvageTrack entry{};
+        entry.number = track.number;
+        entry.start = track.start;
+        entry.sectors = track.end - track.start + 1;
+        entry.spool_sector = spool_sectors;
+        spool_sectors += entry.sectors;
+        spool->tracks.push_back(entry);
+    }
+
+    std::vector<int16_t> pcm(static_cast<size_t>(kSalvageRangeSectors) * kSamplesPerSector * kChannels);
+    // Reads a range through a reader; reports whether every sector came back without paranoia events.
+    auto read_range = [&](OffsetSectorReader& reader, SalvageTrack& entry, SectorReadPolicy& policy, long count, bool& clean) {
+        const long errors_before = count_read_error_events(entry.stats);
+        const size_t damaged_before = policy.damaged_sectors.size();
+        for (long c = 0; c < count; ++c) {
+            const int16_t* buffer = nullptr;
+            if (!reader.next(buffer, err)) return false;
+            std::copy(
+                buffer,
+                buffer + kSamplesPerSector * kChannels,
+                pcm.begin() + static_cast<size_t>(c) * kSamplesPerSector * kChannels);
+        }
+        clean = count_read_error_events(entry.stats) == errors_before &&
+            policy.damaged_sectors.size() == damaged_before;
+        return true;
+    };
+
+    // Pass 1: the whole disc at full speed with overlap checks only, which are cheap but still
+    // report the events that mark a range as damaged; only those ranges are remembered.
+    std::string backend_err;
+    if (!backend.set_drive_speed(rip->drive, true, backend_err) ||
+        !backend.set_reader_mode(rip->reader, RIP_MODES_HYBRID, backend_err)) {
+        err = backend_err;
+        return false;
+    }
+    const int total_tracks = static_cast<int>(spool->tracks.size());
+    const std::string fast_label = "Salvage pass 1 (fast)";
+    auto pass_start = std::chrono::steady_clock::now();
+    long damaged_total = 0;
+    long pass_done = 0;
+    for (auto& entry : spool->tracks) {
+        SectorReadPolicy policy{};
+        policy.max_retries = kSalvageFastMaxRetries;
+        policy.tolerate_errors = true;
+        OffsetSectorReader reader(backend, rip->reader, entry.start, toc->leadout_sector, rip->read_offset, entry.stats);
+        reader.set_policy(&policy);
+        if (!reader.start(err)) return false;
+        for (long first = 0; first < entry.sectors; first += kSalvageRangeSectors) {
+            const long count = std::min(kSalvageRangeSectors, entry.sectors - first);
+            bool clean = false;
+            if (!read_range(reader, entry, policy, count, clean)) return false;
+            if (!write_salvage_spool(*spool, entry.spool_sector + first, pcm, count)) {
+                err = "Failed to write salvage spool " + spool->path;
+                return false;
+            }
+            pass_done += count;
+            if (!clean) damaged_total += count;
+            report_salvage_progress(
+                progress, entry, total_tracks, fast_label, pass_done, spool_sectors, damaged_total, pass_start);
+            if (clean) continue;
+            if (!entry.damaged.empty() && entry.damaged.back().first + entry.damaged.back().second == first) {
+                entry.damaged.back().second += count;
+            } else {
+                entry.damaged.emplace_back(first, count);
+            }
+        }
+    }
+    notify_salvage(
+        observer,
+        damaged_total > 0 ? CDRIP_DIAGNOSTIC_SEVERITY_WARNING : CDRIP_DIAGNOSTIC_SEVERITY_INFO,
+        "Salvage pass 1 (fast): " + std::to_string(spool_sectors) + " sectors read, " +
+            std::to_string(damaged_total) + " sectors to retry");
+
+    // Later passes: only the damaged ranges, slower and with more checks each time.
+    int pass_number = 1;
+    for (const auto& pass : kSalvageRetryPasses) {
+        if (damaged_total == 0) break;
+        ++pass_number;
+        if (!backend.set_drive_speed(rip->drive, pass.speed_fast, backend_err) ||
+            !backend.set_reader_mode(rip->reader, pass.mode, backend_err)) {
+            err = backend_err;
+            return false;
+        }
+        const bool last_pass = &pass == &kSalvageRetryPasses[std::size(kSalvageRetryPasses) - 1];
+        const std::string pass_label = "Salvage pass " + std::to_string(pass_number) + " (" + pass.label + ")";
+        const long pass_total = damaged_total;
+        pass_start = std::chrono::steady_clock::now();
+        pass_done = 0;
+        long recovered = 0;
+        for (auto& entry : spool->tracks) {
+            if (entry.damaged.empty()) continue;
+            SectorReadPolicy policy{};
+            policy.max_retries = pass.max_retries;
+            policy.tolerate_errors = true;
+            OffsetSectorReader reader(backend, rip->reader, entry.start, toc->leadout_sector, rip->read_offset, entry.stats);
+            reader.set_policy(&policy);
+            std::vector<std::pair<long, long>> still_damaged;
+            for (const auto& range : entry.damaged) {
+                for (long first = range.first; first < range.first + range.second; first += kSalvageRangeSectors) {
+                    const long count = std::min(kSalvageRangeSectors, range.first + range.second - first);
+                    const size_t failed_before = policy.damaged_sectors.size();
+                    bool clean = false;
+                    if (!reader.restart(entry.start + first, err) ||
+                        !read_range(reader, entry, policy, count, clean)) {
+                        return false;
+                    }
+                    entry.retried_sectors += count;
+                    // A careful read beats the fast one even with events, unless sectors were unreadable.
+                    if (clean || (last_pass && policy.damaged_sectors.size() == failed_before)) {
+                        if (!write_salvage_spool(*spool, entry.spool_sector + first, pcm, count)) {
+                            err = "Failed to write salvage spool " + spool->path;
+                            return false;
+                        }
+                    }
+                    pass_done += count;
+                    report_salvage_progress(
+                        progress, entry, total_tracks, pass_label, pass_done, pass_total,
+                        pass_total - recovered - (clean ? count : 0), pass_start);
+                    if (clean) {
+                        recovered += count;
+                    } else if (!still_damaged.empty() &&
+                        still_damaged.back().first + still_damaged.back().second == first) {
+                        still_damaged.back().second += count;
+                    } else {
+                        still_damaged.emplace_back(first, count);
+                    }
+                }
+            }
+            entry.damaged.swap(still_damaged);
+        }
+        damaged_total -= recovered;
+        notify_salvage(
+            observer,
+            damaged_total > 0 ? CDRIP_DIAGNOSTIC_SEVERITY_WARNING : CDRIP_DIAGNOSTIC_SEVERITY_INFO,
+            "Salvage pass " + std::to_string(pass_number) + " (" + pass.label + ", " +
+                (pass.speed_fast ? "fast" : "slow") + "): " + std::to_string(recovered) +
+                " sectors recovered, " + std::to_string(damaged_total) + " sectors still damaged");
+    }
+
+    if (!backend.set_drive_speed(rip->drive, rip->speed_fast, backend_err)) {
+        err = backend_err;
+        return false;
+    }
+    spool->file.flush();
+    rip->salvage = std::move(spool);
+    return true;
+}
+
 bool rip_track_with_options(
     CdRip* rip,
     const CdRipTrackInfo* track,
@@ -200,14 +832,17 @@ bool rip_track_with_options(
     std::string title;
     std::string track_name;
     std::string safe_title;
-    std::map<std::string, std::string> tags = build_track_vorbis_tags(
-        track,
-        meta,
-        toc,
-        total_tracks,
-        title,
-        track_name,
-        safe_title);
+    const bool disc_image = options && options->disc_image;
+    std::map<std::string, std::string> tags = disc_image
+        ? build_disc_image_vorbis_tags(meta, toc, title, track_name, safe_title)
+        : build_track_vorbis_tags(
+            track,
+            meta,
+            toc,
+            total_tracks,
+            title,
+            track_name,
+            safe_title);
 
     std::string output_path;
     if (options && options->output_path && options->output_path[0]) {
@@ -221,16 +856,48 @@ bool rip_track_with_options(
             ? std::string{options->display_path}
             : output_path;
 
+    // Extra outputs take every chunk of this one read; each encodes on its own thread.
+    std::vector<std::unique_ptr<OutputSink>> sinks;
+    for (const auto& config : rip->outputs) {
+        std::string sink_path;
+        if (!resolve_track_output_path(config.format, tags, sink_path, err)) {
+            return false;
+        }
+        sinks.push_back(std::make_unique<OutputSink>(config, sink_path));
+    }
+
     std::string temp_path;
     if (!create_local_temp_file(temp_path, err)) {
         return false;
     }
 
+    const bool adaptive = rip->compression_level == CDRIP_COMPRESSION_ADAPTIVE;
     int compression_level = rip->compression_level;
-    if (compression_level < 0) {
+    if (adaptive && rip->adaptive_compression_level >= 0) {
+        // Only ever changed between tracks, never within one.
+        compression_level = rip->adaptive_compression_level;
+    } else if (compression_level < 0) {
         compression_level = (rip->mode == RIP_MODES_FAST) ? 1 : 5;
     }
 
+    // Salvage mode encodes from audio read ahead for the whole disc.
+    SalvageTrack* salvaged = nullptr;
+    if (rip->mode == RIP_MODES_SALVAGE) {
+        if ((!rip->salvage || rip->salvage->discid != to_string_or_empty(toc->cddb_discid)) &&
+            !salvage_disc(rip, toc, nullptr, progress, err)) {
+            remove_local_file_quietly(temp_path);
+            return false;
+        }
+        for (auto& entry : rip->salvage->tracks) {
+            if (entry.number == track->number && entry.sectors == sectors) salvaged = &entry;
+        }
+        if (!salvaged) {
+            err = "Track " + std::to_string(track->number) + " was not read by salvage mode";
+            remove_local_file_quietly(temp_path);
+            return false;
+        }
+    }
+
     const DriveBackend& backend =
         rip->backend ? *rip->backend : current_drive_backend();
     std::string backend_err;
@@ -248,9 +915,32 @@ bool rip_track_with_options(
     encoder.set_sample_rate(kSampleRate);
     encoder.set_total_samples_estimate(
         static_cast<uint64_t>(sectors) * kSamplesPerSector);
+    unsigned encoder_threads = resolve_encoder_threads(rip->encoder_threads, rip->speed_fast);
+#ifdef CDRIP_HAVE_FLAC_NUM_THREADS
+    // libFLAC may be built without thread support; it then simply stays single-threaded.
+    if (encoder_threads > 1 &&
+        encoder.set_num_threads(encoder_threads) != FLAC__STREAM_ENCODER_SET_NUM_THREADS_OK) {
+        encoder_threads = 1;
+    }
+#endif
+    // Encoder worker threads do not show up in this thread's CPU clock, and the process
+    // clock would also count tag writers, cover art and output sinks. With several threads,
+    // measure the wall time the rip thread spends inside the encoder instead.
+    const bool encode_wall_clock = encoder_threads > 1;
+    auto encode_seconds = [encode_wall_clock]() {
+        return encode_wall_clock ? steady_seconds() : cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+    };
 
     std::map<std::string, std::string> vorbis_tags = tags;
     drop_format_only_tags(vorbis_tags);
+    // Placeholder of the final width, so the real CRC is patched in without moving audio.
+    vorbis_tags[kPcmCrc32TagKey] = format_pcm_crc32(0);
+    // AccurateRip checksums are per track, so an image carries none.
+    if (!disc_image) {
+        vorbis_tags[kAccurateRipV1TagKey] = format_pcm_crc32(0);
+        vorbis_tags[kAccurateRipV2TagKey] = format_pcm_crc32(0);
+        vorbis_tags[kAccurateRipOffsetTagKey] = std::to_string(rip->read_offset);
+    }
     FLAC__StreamMetadata* vorbis = build_vorbis_comments(vorbis_tags);
     FLAC__StreamMetadata* picture = nullptr;
     if (!vorbis) {
@@ -258,23 +948,37 @@ bool rip_track_with_options(
         remove_local_file_quietly(temp_path);
         return false;
     }
-    if (has_cover_art_data(meta->cover_art)) {
-        picture = build_picture_block(meta->cover_art);
-        if (!picture) {
-            err = "Failed to build picture metadata";
+    if (!build_track_picture_block(meta->cover_art, picture, err)) {
+        FLAC__metadata_object_delete(vorbis);
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+    FLAC__StreamMetadata* seektable = nullptr;
+    FLAC__StreamMetadata* cuesheet = nullptr;
+    if (disc_image) {
+        seektable = build_disc_image_seektable(toc, *track);
+        cuesheet = seektable ? build_disc_image_cuesheet(toc, *track, err) : nullptr;
+        if (!cuesheet) {
+            if (err.empty()) err = "Failed to create FLAC seek table";
             FLAC__metadata_object_delete(vorbis);
+            if (picture) FLAC__metadata_object_delete(picture);
+            if (seektable) FLAC__metadata_object_delete(seektable);
             remove_local_file_quietly(temp_path);
             return false;
         }
     }
     std::vector<FLAC__StreamMetadata*> meta_blocks;
     meta_blocks.push_back(vorbis);
+    if (seektable) meta_blocks.push_back(seektable);
+    if (cuesheet) meta_blocks.push_back(cuesheet);
     if (picture) meta_blocks.push_back(picture);
     encoder.set_metadata(meta_blocks.data(), static_cast<unsigned>(meta_blocks.size()));
 
     auto cleanup_encoder_state = [&]() {
         FLAC__metadata_object_delete(vorbis);
         if (picture) FLAC__metadata_object_delete(picture);
+        if (seektable) FLAC__metadata_object_delete(seektable);
+        if (cuesheet) FLAC__metadata_object_delete(cuesheet);
     };
 
     FLAC__StreamEncoderInitStatus init_status = encoder.init(temp_path.c_str());
@@ -285,16 +989,29 @@ bool rip_track_with_options(
         remove_local_file_quietly(temp_path);
         return false;
     }
+    for (auto& sink : sinks) {
+        if (!sink->start(tags, meta->cover_art, toc, *track, disc_image, err)) {
+            encoder.finish();
+            cleanup_encoder_state();
+            remove_local_file_quietly(temp_path);
+            return false;
+        }
+    }
 
-    if (!backend.seek_reader(rip->reader, track->start, backend_err)) {
-        err = backend_err;
-        encoder.finish();
-        cleanup_encoder_state();
-        remove_local_file_quietly(temp_path);
-        return false;
+    size_t track_index = 0;
+    while (track_index + 1 < toc->tracks_count && toc->tracks[track_index].number != track->number) {
+        ++track_index;
     }
+    AccurateRipChecksum accuraterip{};
+    begin_accuraterip_checksum(
+        accuraterip,
+        static_cast<uint64_t>(sectors) * kSamplesPerSector,
+        track_index == 0,
+        track_index + 1 == toc->tracks_count);
+    std::string accuraterip_result;
 
     constexpr int kChunkSectors = 128;
+    std::vector<int16_t> chunk_pcm(kChunkSectors * kSamplesPerSector * kChannels);
     std::vector<FLAC__int32> left(kChunkSectors * kSamplesPerSector);
     std::vector<FLAC__int32> right(kChunkSectors * kSamplesPerSector);
 
@@ -304,52 +1021,350 @@ bool rip_track_with_options(
             .count() / 1000.0
         - wall_start_sec;
 
-    long processed = 0;
-    while (processed < sectors) {
-        const int chunk = static_cast<int>(
-            std::min<long>(kChunkSectors, sectors - processed));
-        int read_sectors = 0;
+    // Verify mode reads the track twice, so each pass covers half of the track's progress.
+    const bool verify_mode = rip->mode == RIP_MODES_VERIFY;
+    long verify_reread_sectors = 0;
+    const bool hybrid_mode = rip->mode == RIP_MODES_HYBRID;
+    CdRipReadStats read_stats = salvaged ? salvaged->stats : CdRipReadStats{};
+    // Plain locals: only this thread reads and reports, and nothing is timed when disabled.
+    const bool collect_telemetry = rip->read_telemetry;
+    CdRipReadTelemetry telemetry{};
+    telemetry.track_number = track->number;
+    if (salvaged) telemetry.reread_sectors = salvaged->retried_sectors;
+    double read_wall_sec = 0.0;
+    double encode_sec = 0.0;
+
+    // Read budget: every reader of the track shares one policy, so damaged sectors are collected once.
+    const bool read_budget = rip->sector_budget_sec > 0.0 || rip->track_budget_sec > 0.0;
+    SectorReadPolicy read_policy{};
+    int degrade_level = (rip->mode == RIP_MODES_FAST || verify_mode)
+        ? kReadDegradeNone
+        : (hybrid_mode ? kReadDegradeOverlap : 0);
+    // Unreadable sectors are only tolerated once the ladder is at its lowest step.
+    read_policy.tolerate_errors = read_budget && degrade_level >= kReadDegradeNone;
+    bool degraded = false;
+    bool track_budget_spent = false;
+    bool escalated = false;
+    if (salvaged) {
+        for (const auto& range : salvaged->damaged) {
+            for (long c = 0; c < range.second; ++c) read_policy.damaged_sectors.push_back(track->start + range.first + c);
+        }
+    }
+    ReadWatchdog watchdog(rip->sector_budget_sec, &rip->budget_observer, track->number);
 
+    auto report_progress = [&](double done_fraction) {
+        if (!progress) return;
+        const double track_total_sec = static_cast<double>(sectors) * kSamplesPerSector / kSampleRate;
+        const double elapsed_track = done_fraction * track_total_sec;
+        const double wall_now =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count() / 1000.0;
+        const double wall_elapsed = wall_now - wall_start_sec;
+        const double wall_track_elapsed = wall_now - wall_start_sec - wall_track_start;
+
+        CdRipProgressInfo info{};
+        info.track_number = track->number;
+        info.total_tracks = total_tracks;
+        info.percent = done_fraction * 100.0;
+        info.elapsed_track_sec = elapsed_track;
+        info.track_total_sec = track_total_sec;
+        info.elapsed_total_sec = completed_before_sec + elapsed_track;
+        info.total_album_sec = total_album_sec;
+        info.track_name = track_name.c_str();
+        info.safe_title = safe_title.c_str();
+        info.title = title.c_str();
+        info.path = display_path.c_str();
+        info.compression_level = compression_level;
+        info.compression_adaptive = adaptive ? 1 : 0;
+        info.accuraterip = accuraterip_result.empty() ? nullptr : accuraterip_result.c_str();
+        info.verify_reread_sectors = verify_reread_sectors;
+        info.read_stats = &read_stats;
+        info.damaged_sectors = static_cast<long>(read_policy.damaged_sectors.size());
+        info.read_degrade_level = degraded ? degrade_level : 0;
+        if (collect_telemetry) {
+            telemetry.stats = read_stats;
+            info.telemetry = &telemetry;
+        }
+
+        const double audio_done = info.elapsed_total_sec;
+        const double audio_remain = std::max(0.0, total_album_sec - audio_done);
+        const double throughput = (wall_elapsed > 0.0 && audio_done > 0.0)
+            ? (audio_done / wall_elapsed)
+            : 0.0;
+        info.wall_elapsed_sec = wall_elapsed;
+
+        if (throughput > 0.0) {
+            info.wall_total_sec = wall_elapsed + audio_remain / throughput;
+            info.wall_track_total_sec = info.track_total_sec / throughput;
+        } else {
+            info.wall_total_sec = 0.0;
+            info.wall_track_total_sec = 0.0;
+        }
+        info.wall_track_elapsed_sec = wall_track_elapsed;
+        progress(&info);
+    };
+
+    // Lowers the integrity checks once a read went over budget; at the lowest step slow sectors
+    // are only flagged. A blocked read cannot be cut short, so this acts after the read returns.
+    auto enforce_read_budget = [&](const OffsetSectorReader& reader, double read_sec) {
+        const bool slow_sector = rip->sector_budget_sec > 0.0 && read_sec > rip->sector_budget_sec;
+        const bool over_track = rip->track_budget_sec > 0.0 && read_wall_sec > rip->track_budget_sec;
+        if (!slow_sector && !over_track) return true;
+        read_policy.max_retries = kDegradedMaxRetries;
+        if (over_track) track_budget_spent = true;
+        if (degrade_level >= kReadDegradeNone) {
+            if (slow_sector) read_policy.damaged_sectors.push_back(reader.last_sector());
+            degraded = true;
+            return true;
+        }
+        const int next_level = over_track ? kReadDegradeNone : degrade_level + 1;
+        const CdRipRipModes next_mode = next_level >= kReadDegradeNone ? RIP_MODES_FAST : RIP_MODES_HYBRID;
+        if (!backend.set_reader_mode(rip->reader, next_mode, backend_err)) return false;
+        degrade_level = next_level;
+        degraded = true;
+        escalated = false;
+        if (degrade_level >= kReadDegradeNone) read_policy.tolerate_errors = true;
+        rip->reader_degraded = true;
+
+        const std::string message = "Track " + std::to_string(track->number) +
+            (over_track ? ": track read budget exhausted" : ": sector read over budget") +
+            (next_level >= kReadDegradeNone ? ", integrity checks disabled" : ", overlap checks only");
+        CdRipDiagnosticInfo info{};
+        info.severity = CDRIP_DIAGNOSTIC_SEVERITY_WARNING;
+        info.source_label = "read";
+        info.message = message.c_str();
+        notify_diagnostic(&rip->budget_observer, nullptr, info);
+        return true;
+    };
+
+    // Fills chunk_pcm with the next sectors of a reader.
+    auto read_chunk = [&](OffsetSectorReader& reader, int chunk) {
+        reader.set_policy(&read_policy);
         for (int c = 0; c < chunk; ++c) {
             const int16_t* buffer = nullptr;
-            if (!backend.read_sector(rip->reader, buffer, backend_err)) {
+            const double read_start = steady_seconds();
+            if (read_budget) watchdog.begin(read_start);
+            const bool read_ok = reader.next(buffer, backend_err);
+            const double read_sec = steady_seconds() - read_start;
+            if (read_budget) watchdog.end();
+            read_wall_sec += read_sec;
+            if (collect_telemetry) record_sector_read(telemetry, read_sec);
+            if (!read_ok) return false;
+            if (read_budget && !enforce_read_budget(reader, read_sec)) return false;
+            std::copy(
+                buffer,
+                buffer + kSamplesPerSector * kChannels,
+                chunk_pcm.begin() + static_cast<size_t>(c) * kSamplesPerSector * kChannels);
+        }
+        return true;
+    };
+
+    // Test pass: only the CRC of every chunk is kept, to be compared with the copy pass.
+    std::vector<uint32_t> test_crcs;
+    if (verify_mode) {
+        OffsetSectorReader test_reader(backend, rip->reader, track->start, toc->leadout_sector, rip->read_offset, read_stats);
+        if (!test_reader.start(backend_err)) {
+            err = backend_err;
+            encoder.finish();
+            cleanup_encoder_state();
+            remove_local_file_quietly(temp_path);
+            return false;
+        }
+        for (long tested = 0; tested < sectors;) {
+            const int chunk = static_cast<int>(
+                std::min<long>(kChunkSectors, sectors - tested));
+            if (!read_chunk(test_reader, chunk)) {
                 err = "Read error on track " + std::to_string(track->number);
                 encoder.finish();
                 cleanup_encoder_state();
                 remove_local_file_quietly(temp_path);
                 return false;
             }
+            test_crcs.push_back(update_pcm_crc32(
+                0, chunk_pcm.data(), static_cast<size_t>(chunk) * kSamplesPerSector * kChannels));
+            tested += chunk;
+            report_progress(static_cast<double>(tested) / static_cast<double>(sectors) * 0.5);
+        }
+    }
+
+    // A previous track may have ended while escalated or degraded by the read budget.
+    if ((hybrid_mode || rip->reader_degraded) && !backend.set_reader_mode(rip->reader, rip->mode, backend_err)) {
+        err = backend_err;
+        encoder.finish();
+        cleanup_encoder_state();
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
+    rip->reader_degraded = false;
+    // Sequential reads pick up the previous track's reader when this track starts where it stopped:
+    // no seek, no paranoia cache flush, and the read offset carries over the boundary sample-exact.
+    const bool sequential = rip->sequential_read && !verify_mode && !salvaged;
+    const std::string discid = to_string_or_empty(toc->cddb_discid);
+    std::unique_ptr<OffsetSectorReader> sector_reader_owner;
+    if (rip->sequential) {
+        if (sequential &&
+            rip->sequential->reader &&
+            rip->sequential->discid == discid &&
+            rip->sequential->reader->next_output_sector() == track->start) {
+            sector_reader_owner = std::move(rip->sequential->reader);
+            sector_reader_owner->set_stats(read_stats);
+        }
+        rip->sequential->reader.reset();
+    }
+    if (!sector_reader_owner) {
+        sector_reader_owner = std::make_unique<OffsetSectorReader>(
+            backend, rip->reader, track->start, toc->leadout_sector, rip->read_offset, read_stats);
+        if (!salvaged && !sector_reader_owner->start(backend_err)) {
+            err = backend_err;
+            encoder.finish();
+            cleanup_encoder_state();
+            remove_local_file_quietly(temp_path);
+            return false;
+        }
+    }
+    OffsetSectorReader& sector_reader = *sector_reader_owner;
+    // Full integrity reader for ranges whose two reads differ; created on the first mismatch.
+    ScopedReader full_reader(backend);
+
+    // Hybrid mode: full checks from the first range that reports errors until enough clean ranges follow.
+    int clean_escalated_chunks = 0;
+
+    long processed = 0;
+    size_t chunk_index = 0;
+    uint32_t pcm_crc = 0;
+    while (processed < sectors) {
+        const int chunk = static_cast<int>(
+            std::min<long>(kChunkSectors, sectors - processed));
+        const size_t chunk_values = static_cast<size_t>(chunk) * kSamplesPerSector * kChannels;
+        const long errors_before = count_read_error_events(read_stats);
+        if (salvaged) {
+            if (!read_salvage_spool(*rip->salvage, salvaged->spool_sector + processed, chunk_pcm, chunk)) {
+                err = "Failed to read salvage spool for track " + std::to_string(track->number);
+                encoder.finish();
+                cleanup_encoder_state();
+                remove_local_file_quietly(temp_path);
+                return false;
+            }
+        } else if (!read_chunk(sector_reader, chunk)) {
+            err = "Read error on track " + std::to_string(track->number);
+            encoder.finish();
+            cleanup_encoder_state();
+            remove_local_file_quietly(temp_path);
+            return false;
+        }
 
-            if (options && options->track_replaygain_state) {
-                if (ebur128_add_frames_short(options->track_replaygain_state, buffer, kSamplesPerSector) != EBUR128_SUCCESS) {
-                    err = "Failed to update ReplayGain track state";
+        // Once over budget, errors are not worth another read.
+        if (hybrid_mode && !degraded) {
+            const bool chunk_clean = count_read_error_events(read_stats) == errors_before;
+            if (!escalated && !chunk_clean) {
+                // The light checks already saw trouble here: read the range again the way best mode does.
+                if (!backend.set_reader_mode(rip->reader, RIP_MODES_BEST, backend_err) ||
+                    !sector_reader.restart(track->start + processed, backend_err) ||
+                    !read_chunk(sector_reader, chunk)) {
+                    err = "Read error on track " + std::to_string(track->number) + " while escalating: " + backend_err;
                     encoder.finish();
                     cleanup_encoder_state();
                     remove_local_file_quietly(temp_path);
                     return false;
                 }
+                escalated = true;
+                clean_escalated_chunks = 0;
+                ++read_stats.escalations;
+                telemetry.reread_sectors += chunk;
+            } else if (escalated) {
+                clean_escalated_chunks = chunk_clean ? clean_escalated_chunks + 1 : 0;
             }
-            if (options && options->album_replaygain_state) {
-                if (ebur128_add_frames_short(options->album_replaygain_state, buffer, kSamplesPerSector) != EBUR128_SUCCESS) {
-                    err = "Failed to update ReplayGain album state";
-                    encoder.finish();
-                    cleanup_encoder_state();
-                    remove_local_file_quietly(temp_path);
-                    return false;
+            if (escalated) {
+                read_stats.escalated_sectors += chunk;
+                if (clean_escalated_chunks >= kHybridDeescalateCleanChunks) {
+                    if (!backend.set_reader_mode(rip->reader, RIP_MODES_HYBRID, backend_err)) {
+                        err = backend_err;
+                        encoder.finish();
+                        cleanup_encoder_state();
+                        remove_local_file_quietly(temp_path);
+                        return false;
+                    }
+                    escalated = false;
                 }
             }
+        }
 
-            const int base = c * kSamplesPerSector;
-            for (int i = 0; i < kSamplesPerSector; ++i) {
-                left[base + i] = buffer[i * 2];
-                right[base + i] = buffer[i * 2 + 1];
+        const bool verify_mismatch =
+            verify_mode && update_pcm_crc32(0, chunk_pcm.data(), chunk_values) != test_crcs[chunk_index];
+        if (verify_mismatch && track_budget_spent) {
+            // No budget left for a careful re-read: keep the copy and flag the whole range.
+            for (int c = 0; c < chunk; ++c) read_policy.damaged_sectors.push_back(track->start + processed + c);
+        } else if (verify_mismatch) {
+            // The two reads disagree, so this range is read again with full checks. Ranges where
+            // both fast reads agree are kept as read; verify mode is not best mode throughout.
+            bool reread_ok = full_reader.reader ||
+                backend.create_reader(rip->drive, RIP_MODES_BEST, full_reader.reader, backend_err);
+            if (reread_ok) {
+                OffsetSectorReader range_reader(
+                    backend, full_reader.reader, track->start + processed, toc->leadout_sector, rip->read_offset, read_stats);
+                reread_ok = range_reader.start(backend_err) && read_chunk(range_reader, chunk);
+            }
+            if (!reread_ok) {
+                err = "Read error on track " + std::to_string(track->number) + " while re-reading: " + backend_err;
+                encoder.finish();
+                cleanup_encoder_state();
+                remove_local_file_quietly(temp_path);
+                return false;
+            }
+            verify_reread_sectors += chunk;
+            telemetry.reread_sectors += chunk;
+        }
+        ++chunk_index;
+
+        if (options && options->track_replaygain_state) {
+            if (ebur128_add_frames_short(
+                    options->track_replaygain_state,
+                    chunk_pcm.data(),
+                    static_cast<size_t>(chunk) * kSamplesPerSector) != EBUR128_SUCCESS) {
+                err = "Failed to update ReplayGain track state";
+                encoder.finish();
+                cleanup_encoder_state();
+                remove_local_file_quietly(temp_path);
+                return false;
+            }
+        }
+        if (options && options->album_replaygain_state) {
+            if (ebur128_add_frames_short(
+                    options->album_replaygain_state,
+                    chunk_pcm.data(),
+                    static_cast<size_t>(chunk) * kSamplesPerSector) != EBUR128_SUCCESS) {
+                err = "Failed to update ReplayGain album state";
+                encoder.finish();
+                cleanup_encoder_state();
+                remove_local_file_quietly(temp_path);
+                return false;
+            }
+        }
+
+        pcm_crc = update_pcm_crc32(pcm_crc, chunk_pcm.data(), chunk_values);
+        update_accuraterip_checksum(accuraterip, chunk_pcm.data(), static_cast<size_t>(chunk) * kSamplesPerSector);
+
+        const int samples_in_chunk = chunk * kSamplesPerSector;
+        for (int i = 0; i < samples_in_chunk; ++i) {
+            left[i] = chunk_pcm[static_cast<size_t>(i) * 2];
+            right[i] = chunk_pcm[static_cast<size_t>(i) * 2 + 1];
+        }
+
+        for (auto& sink : sinks) {
+            if (!sink->push(chunk_pcm.data(), static_cast<size_t>(samples_in_chunk), err)) {
+                encoder.finish();
+                cleanup_encoder_state();
+                remove_local_file_quietly(temp_path);
+                return false;
             }
-            ++read_sectors;
         }
 
         const FLAC__int32* pcm[] = {left.data(), right.data()};
-        const int samples_in_chunk = read_sectors * kSamplesPerSector;
-        if (!encoder.process(pcm, samples_in_chunk)) {
+        const double encode_start = encode_seconds();
+        const bool encoded = encoder.process(pcm, samples_in_chunk);
+        encode_sec += encode_seconds() - encode_start;
+        if (!encoded) {
             err = "FLAC encoding error on track " + std::to_string(track->number);
             encoder.finish();
             cleanup_encoder_state();
@@ -357,51 +1372,54 @@ bool rip_track_with_options(
             return false;
         }
 
-        processed += read_sectors;
-        const double pct = static_cast<double>(processed) / static_cast<double>(sectors) * 100.0;
-        if (progress) {
-            const double elapsed_track = static_cast<double>(processed) * kSamplesPerSector / kSampleRate;
-            const double wall_now =
-                std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::steady_clock::now().time_since_epoch())
-                    .count() / 1000.0;
-            const double wall_elapsed = wall_now - wall_start_sec;
-            const double wall_track_elapsed = wall_now - wall_start_sec - wall_track_start;
-
-            CdRipProgressInfo info{};
-            info.track_number = track->number;
-            info.total_tracks = total_tracks;
-            info.percent = pct;
-            info.elapsed_track_sec = elapsed_track;
-            info.track_total_sec = static_cast<double>(sectors) * kSamplesPerSector / kSampleRate;
-            info.elapsed_total_sec = completed_before_sec + elapsed_track;
-            info.total_album_sec = total_album_sec;
-            info.track_name = track_name.c_str();
-            info.safe_title = safe_title.c_str();
-            info.title = title.c_str();
-            info.path = display_path.c_str();
-
-            const double audio_done = info.elapsed_total_sec;
-            const double audio_remain = std::max(0.0, total_album_sec - audio_done);
-            const double throughput = (wall_elapsed > 0.0 && audio_done > 0.0)
-                ? (audio_done / wall_elapsed)
-                : 0.0;
-            info.wall_elapsed_sec = wall_elapsed;
-
-            if (throughput > 0.0) {
-                info.wall_total_sec = wall_elapsed + audio_remain / throughput;
-                info.wall_track_total_sec = info.track_total_sec / throughput;
-            } else {
-                info.wall_total_sec = 0.0;
-                info.wall_track_total_sec = 0.0;
-            }
-            info.wall_track_elapsed_sec = wall_track_elapsed;
-            progress(&info);
-        }
+        processed += chunk;
+        const double copied = static_cast<double>(processed) / static_cast<double>(sectors);
+        report_progress(verify_mode ? 0.5 + copied * 0.5 : copied);
+    }
+    if (sequential) {
+        if (!rip->sequential) rip->sequential = std::make_shared<SequentialReadState>();
+        rip->sequential->discid = discid;
+        rip->sequential->reader = std::move(sector_reader_owner);
     }
 
+    const double finish_start = encode_seconds();
     encoder.finish();
+    encode_sec += encode_seconds() - finish_start;
     cleanup_encoder_state();
+    if (!disc_image) {
+        // The database is fetched once per disc, after the reads, so the drive never waits on
+        // the network mid-track; one more update carries the result.
+        if (check_accuraterip(toc, track_index, accuraterip, accuraterip_result)) report_progress(1.0);
+    }
+    if (adaptive) {
+        rip->adaptive_compression_level = next_adaptive_compression_level(
+            compression_level, encode_sec, read_wall_sec);
+    }
+
+    std::map<std::string, std::string> measured_tags{
+        {kPcmCrc32TagKey, format_pcm_crc32(pcm_crc)},
+    };
+    if (!disc_image) {
+        measured_tags[kAccurateRipV1TagKey] = format_pcm_crc32(accuraterip.v1);
+        measured_tags[kAccurateRipV2TagKey] = format_pcm_crc32(accuraterip.v2);
+    }
+    if (!accuraterip_result.empty()) measured_tags[kAccurateRipResultTagKey] = accuraterip_result;
+    telemetry.stats = read_stats;
+    if (collect_telemetry) measured_tags[kReadQualityTagKey] = format_read_quality_tag(telemetry);
+    if (!read_policy.damaged_sectors.empty()) {
+        measured_tags[kDamagedSectorsTagKey] = format_sector_ranges(read_policy.damaged_sectors);
+    }
+    if (!update_flac_tags(
+            temp_path,
+            nullptr,
+            0,
+            nullptr,
+            measured_tags,
+            /*preserve_replaygain_tags=*/false,
+            err)) {
+        remove_local_file_quietly(temp_path);
+        return false;
+    }
 
     if (replaygain_result && options && options->track_replaygain_state) {
         if (!finalize_replaygain_scan(options->track_replaygain_state, *replaygain_result, err)) {
@@ -410,11 +1428,33 @@ bool rip_track_with_options(
         }
     }
 
+    // Every extra output is finished before anything is published, so a failing output leaves
+    // no main FLAC behind either.
+    for (auto& sink : sinks) {
+        if (!sink->finish(measured_tags, err)) {
+            remove_local_file_quietly(temp_path);
+            return false;
+        }
+    }
     if (!publish_local_file_to_destination(temp_path, output_path, err)) {
         remove_local_file_quietly(temp_path);
         return false;
     }
     remove_local_file_quietly(temp_path);
+    for (auto& sink : sinks) {
+        if (!sink->publish(err)) {
+            return false;
+        }
+    }
+    if (collect_telemetry) finish_track_read_telemetry(rip, toc, telemetry);
+    if (salvaged) {
+        // The spool holds the whole disc; drop it once every track was encoded from it.
+        salvaged->encoded = true;
+        const auto& spooled = rip->salvage->tracks;
+        if (std::all_of(spooled.begin(), spooled.end(), [](const SalvageTrack& entry) { return entry.encoded; })) {
+            rip->salvage.reset();
+        }
+    }
     return true;
 }
 
@@ -455,4 +1495,41 @@ int cdrip_rip_track(
     return 1;
 }
 
+void cdrip_set_read_budget(
+    CdRip* cdrip,
+    double sector_budget_sec,
+    double track_budget_sec,
+    const CdRipDiagnosticObserver* observer) {
+
+    if (!cdrip) return;
+    cdrip->sector_budget_sec = sector_budget_sec > 0.0 ? sector_budget_sec : 0.0;
+    cdrip->track_budget_sec = track_budget_sec > 0.0 ? track_budget_sec : 0.0;
+    cdrip->budget_observer = observer ? *observer : CdRipDiagnosticObserver{};
+}
+
+void cdrip_set_sequential_read(
+    CdRip* cdrip,
+    bool enabled) {
+
+    if (!cdrip) return;
+    cdrip->sequential_read = enabled;
+    if (!enabled && cdrip->sequential) cdrip->sequential->reader.reset();
+}
+
+int cdrip_salvage_disc(
+    CdRip* cdrip,
+    const CdRipDiscToc* toc,
+    const CdRipDiagnosticObserver* observer,
+    CdRipProgressCallback progress,
+    const char** error) {
+
+    clear_error(error);
+    std::string err;
+    if (!salvage_disc(cdrip, toc, observer, progress, err)) {
+        set_error(error, err);
+        return 0;
+    }
+    return 1;
+}
+
 }
@@ -0,0 +1,195 @@
+// Scheme CD music/sound ripper
+// Copyright (c) Kouji Matsui. (@kekyo@mi.kekyo.net)
+// Under MIT.
+// https://github.com/kekyo/scheme-cd-ripper
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gio/gio.h>
+
+#include "internal.h"
+
+using namespace cdrip::detail;
+
+namespace {
+
+constexpr const char* kScanIndexHeader = "cdrip-scan-index 1";
+
+std::mutex g_scan_index_mutex;
+std::string g_scan_index_path;
+
+static bool parse_u64(
+    const std::string& text,
+    uint64_t& out) {
+
+    if (text.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (errno != 0 || !end || *end != '\0') return false;
+    out = static_cast<uint64_t>(value);
+    return true;
+}
+
+static bool parse_i64(
+    const std::string& text,
+    int64_t& out) {
+
+    if (text.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    const long long value = std::strtoll(text.c_str(), &end, 10);
+    if (errno != 0 || !end || *end != '\0') return false;
+    out = static_cast<int64_t>(value);
+    return true;
+}
+
+}  // namespace
+
+namespace cdrip::detail {
+
+std::string get_scan_index_path() {
+    std::lock_guard<std::mutex> guard(g_scan_index_mutex);
+    return g_scan_index_path;
+}
+
+bool stat_scan_identity(
+    const std::string& path,
+    ScanIndexEntry& out) {
+
+    if (is_uri(path)) {
+        GFile* file = g_file_new_for_uri(path.c_str());
+        GFileInfo* info = g_file_query_info(
+            file,
+            G_FILE_ATTRIBUTE_STANDARD_SIZE ","
+            G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+            G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC ","
+            G_FILE_ATTRIBUTE_UNIX_INODE,
+            G_FILE_QUERY_INFO_NONE,
+            nullptr,
+            nullptr);
+        g_object_unref(file);
+        if (!info) return false;
+        out.size = static_cast<uint64_t>(g_file_info_get_size(info));
+        out.mtime_ns =
+            static_cast<int64_t>(g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED)) * 1000000000LL +
+            static_cast<int64_t>(g_file_info_get_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC)) * 1000LL;
+        // Not every backend has inodes; size and mtime still identify changes.
+        out.inode = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_UNIX_INODE);
+        g_object_unref(info);
+        return true;
+    }
+
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0) return false;
+    out.size = static_cast<uint64_t>(st.st_size);
+    out.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL +
+        static_cast<int64_t>(st.st_mtim.tv_nsec);
+    out.inode = static_cast<uint64_t>(st.st_ino);
+    return true;
+}
+
+bool load_scan_index(
+    const std::string& index_path,
+    ScanIndex& out) {
+
+    out.clear();
+    if (index_path.empty()) return false;
+    std::ifstream in(index_path, std::ios::binary);
+    if (!in) return false;
+
+    std::string line;
+    if (!std::getline(in, line) || line != kScanIndexHeader) return false;
+    // Line: path, size, mtime_ns, inode, then key/value pairs.
+    while (std::getline(in, line)) {
+        const auto fields = split_index_fields(line);
+        if (fields.size() < 4 || (fields.size() - 4) % 2 != 0) continue;
+        ScanIndexEntry entry{};
+        if (!parse_u64(fields[1], entry.size) ||
+            !parse_i64(fields[2], entry.mtime_ns) ||
+            !parse_u64(fields[3], entry.inode)) {
+            continue;
+        }
+        for (size_t i = 4; i + 1 < fields.size(); i += 2) {
+            entry.tags[unescape_index_field(fields[i])] = unescape_index_field(fields[i + 1]);
+        }
+        out[unescape_index_field(fields[0])] = std::move(entry);
+    }
+    return true;
+}
+
+bool save_scan_index(
+    const std::string& index_path,
+    const ScanIndex& index,
+    std::string& err) {
+
+    err.clear();
+    if (index_path.empty()) {
+        err = "Scan index path is empty";
+        return false;
+    }
+    const std::filesystem::path path(index_path);
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+
+    std::filesystem::path tmp = path;
+    tmp += ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            err = "Failed to write scan index: " + tmp.string();
+            return false;
+        }
+        out << kScanIndexHeader << "\n";
+        for (const auto& [file_path, entry] : index) {
+            out << escape_index_field(file_path) << "\t" << entry.size << "\t"
+                << entry.mtime_ns << "\t" << entry.inode;
+            for (const auto& [key, value] : entry.tags) {
+                out << "\t" << escape_index_field(key) << "\t" << escape_index_field(value);
+            }
+            out << "\n";
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmp, ec);
+            err = "Failed to write scan index: " + tmp.string();
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        err = "Failed to replace scan index: " + index_path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace cdrip::detail
+
+/* ------------------------------------------------------------------- */
+/* Exported API functions */
+
+extern "C" {
+
+void cdrip_set_scan_index(
+    const char* index_path) {
+
+    std::lock_guard<std::mutex> guard(g_scan_index_mutex);
+    g_scan_index_path = to_string_or_empty(index_path);
+}
+
+};
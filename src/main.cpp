@@ -18,14 +18,21 @@
 #include <thread>
 #include <memory>
 #include <filesystem>
+#include <fstream>
+#include <future>
 #include <sstream>
 #include <string>
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <vector>
+#include <list>
 #include <map>
 #include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <glib.h>
@@ -35,6 +42,7 @@
 
 #include <sys/select.h>
 #include <sys/ioctl.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 #define COVER_ART_AA_WIDTH 35
@@ -43,6 +51,11 @@
 namespace {
 
 constexpr int kDefaultMusicBrainzRecrawlTrackLengthTolerancePercent = 2;
+constexpr int kDefaultCoverArtCacheMegabytes = 256;
+// Budget for metadata (including cover art) remembered across update-mode files.
+constexpr size_t kEntryListCacheMaxBytes = 64 * 1024 * 1024;
+// Upper bound of concurrent FLAC tag rewrites in update mode.
+constexpr size_t kMaxTagWriterThreads = 8;
 constexpr int kCdChannels = 2;
 constexpr unsigned long kCdSampleRate = 44100;
 
@@ -253,6 +266,13 @@ struct RipProgressSnapshot {
     double wall_total_sec{0.0};
     std::string title{};
     std::string track_name{};
+    // Shown only when the level changes between tracks (adaptive mode).
+    int adaptive_compression_level{-1};
+    std::string accuraterip{};
+    long verify_reread_sectors{0};
+    long read_error_events{0};
+    long escalated_sectors{0};
+    long damaged_sectors{0};
 };
 
 RipProgressSnapshot make_rip_progress_snapshot(
@@ -268,6 +288,14 @@ RipProgressSnapshot make_rip_progress_snapshot(
     snapshot.wall_total_sec = info.wall_total_sec;
     snapshot.title = view_string(info.title);
     snapshot.track_name = view_string(info.track_name);
+    snapshot.adaptive_compression_level = info.compression_adaptive ? info.compression_level : -1;
+    snapshot.accuraterip = view_string(info.accuraterip);
+    snapshot.verify_reread_sectors = info.verify_reread_sectors;
+    if (info.read_stats) {
+        snapshot.read_error_events = cdrip::detail::count_read_error_events(*info.read_stats);
+        snapshot.escalated_sectors = info.read_stats->escalated_sectors;
+    }
+    snapshot.damaged_sectors = info.damaged_sectors;
     return snapshot;
 }
 
@@ -306,8 +334,19 @@ std::string build_rip_progress_line(
     std::ostringstream oss;
     oss << frame_text
         << " Track " << std::setw(2) << snapshot.track_number << "/" << std::setw(2) << snapshot.total_tracks
-        << " [ETA: " << (show_eta ? fmt_time_fn(remaining_total) : "--:--") << " " << bar << "]: "
-        << "\"" << track_name << "\"";
+        << " [ETA: " << (show_eta ? fmt_time_fn(remaining_total) : "--:--") << " " << bar << "]";
+    if (snapshot.adaptive_compression_level >= 0) oss << " L" << snapshot.adaptive_compression_level;
+    oss << ": \"" << track_name << "\"";
+    if (completed && snapshot.verify_reread_sectors > 0) {
+        oss << " [re-read " << snapshot.verify_reread_sectors << " sectors]";
+    }
+    if (completed && snapshot.read_error_events > 0) {
+        oss << " [read errors: " << snapshot.read_error_events;
+        if (snapshot.escalated_sectors > 0) oss << ", full checks on " << snapshot.escalated_sectors << " sectors";
+        oss << "]";
+    }
+    if (completed && snapshot.damaged_sectors > 0) oss << " [damaged: " << snapshot.damaged_sectors << " sectors]";
+    if (completed && !snapshot.accuraterip.empty()) oss << " [AccurateRip: " << snapshot.accuraterip << "]";
     return oss.str();
 }
 
@@ -641,6 +680,25 @@ public:
         print_rip_progress_line(*info);
     }
 
+    static void diagnostic_cb(
+        const CdRipDiagnosticInfo* info,
+        void* state,
+        void* user_data) {
+
+        (void)state;
+        (void)user_data;
+        if (!info) return;
+        const std::string line = format_diagnostic_message(*info);
+        if (line.empty()) return;
+        auto* active = active_.load();
+        if (active && active->enabled()) {
+            active->print_external_line(line);
+            return;
+        }
+        std::cerr << line << "\n";
+        std::cerr.flush();
+    }
+
 private:
     std::string build_completed_line() const {
         std::lock_guard<std::mutex> guard(mutex_);
@@ -772,6 +830,88 @@ bool parse_int_value(
     }
 }
 
+// "auto" (or empty) maps to 0 and lets the library pick from the drive speed.
+bool parse_encoder_threads(
+    const std::string& raw,
+    int& out) {
+
+    const std::string value = cdrip::detail::to_lower(trim_ws(strip_inline_comment_value(raw)));
+    if (value.empty() || value == "auto") {
+        out = 0;
+        return true;
+    }
+    int parsed = 0;
+    if (!parse_int_value(value, parsed) || parsed <= 0) return false;
+    out = parsed;
+    return true;
+}
+
+// "KIND[:LEVEL]=FORMAT" entries separated by ';', e.g. "flac:0=player/{title:n}.flac;wav=wav/{title:n}.wav".
+bool parse_output_specs(
+    const std::string& raw,
+    std::vector<cdrip::detail::OutputSinkConfig>& out,
+    std::string& err) {
+
+    err.clear();
+    std::istringstream iss(raw);
+    std::string spec;
+    while (std::getline(iss, spec, ';')) {
+        spec = trim_ws(spec);
+        if (spec.empty()) continue;
+        const size_t eq = spec.find('=');
+        if (eq == std::string::npos || eq + 1 >= spec.size()) {
+            err = "output \"" + spec + "\" needs KIND[:LEVEL]=FORMAT";
+            return false;
+        }
+        std::string kind = cdrip::detail::to_lower(trim_ws(spec.substr(0, eq)));
+        cdrip::detail::OutputSinkConfig config{};
+        config.format = trim_ws(spec.substr(eq + 1));
+        const size_t colon = kind.find(':');
+        if (colon != std::string::npos) {
+            if (!parse_int_value(kind.substr(colon + 1), config.compression_level) ||
+                config.compression_level < 0 || config.compression_level > 8) {
+                err = "output \"" + spec + "\" needs a compression level 0-8";
+                return false;
+            }
+            kind = kind.substr(0, colon);
+            if (kind != "flac") {
+                err = "output \"" + spec + "\": only flac takes a compression level";
+                return false;
+            }
+        }
+        if (kind == "flac") {
+            config.kind = CDRIP_OUTPUT_FLAC;
+        } else if (kind == "wav") {
+            config.kind = CDRIP_OUTPUT_WAV;
+        } else if (kind == "aiff") {
+            config.kind = CDRIP_OUTPUT_AIFF;
+        } else if (kind == "raw") {
+            config.kind = CDRIP_OUTPUT_RAW;
+        } else {
+            err = "output \"" + spec + "\": unknown kind (flac, wav, aiff or raw)";
+            return false;
+        }
+        out.push_back(std::move(config));
+    }
+    return true;
+}
+
+const char* output_kind_name(
+    CdRipOutputKinds kind) {
+
+    switch (kind) {
+        case CDRIP_OUTPUT_WAV:
+            return "wav";
+        case CDRIP_OUTPUT_AIFF:
+            return "aiff";
+        case CDRIP_OUTPUT_RAW:
+            return "raw";
+        case CDRIP_OUTPUT_FLAC:
+        default:
+            return "flac";
+    }
+}
+
 bool get_config_bool(
     const char* config_path,
     const char* group,
@@ -1292,9 +1432,8 @@ CdRipCoverArt clone_cover_art(const CdRipCoverArt& src) {
     dest.available = src.available;
     dest.mime_type = dup_cstr_nullable(src.mime_type);
     if (src.data && src.size > 0) {
-        auto* buffer = new uint8_t[src.size];
-        std::memcpy(buffer, src.data, src.size);
-        dest.data = buffer;
+        // Image bytes are immutable; clones share them by reference.
+        dest.data = cdrip::detail::retain_cover_art_data(src.data);
     }
     return dest;
 }
@@ -1396,7 +1535,98 @@ struct EntryListDeleter {
 };
 
 using EntryListPtr = std::unique_ptr<CdRipCddbEntryList, EntryListDeleter>;
-using EntryListCache = std::map<std::string, EntryListPtr>;
+
+size_t estimate_cstr_bytes(const char* s) {
+    return s ? std::strlen(s) + 1 : 0;
+}
+
+size_t estimate_entry_list_bytes(const CdRipCddbEntryList* list) {
+    if (!list) return 0;
+    size_t bytes = sizeof(CdRipCddbEntryList);
+    for (size_t i = 0; list->entries && i < list->count; ++i) {
+        const auto& e = list->entries[i];
+        bytes += sizeof(CdRipCddbEntry);
+        bytes += estimate_cstr_bytes(e.cddb_discid);
+        bytes += estimate_cstr_bytes(e.source_label);
+        bytes += estimate_cstr_bytes(e.source_url);
+        bytes += estimate_cstr_bytes(e.fetched_at);
+        bytes += estimate_cstr_bytes(e.cover_art.mime_type);
+        // Shared art is charged to every holder: the cache is what keeps it alive.
+        bytes += e.cover_art.data ? e.cover_art.size : 0;
+        for (size_t k = 0; e.album_tags && k < e.album_tags_count; ++k) {
+            bytes += sizeof(CdRipTagKV);
+            bytes += estimate_cstr_bytes(e.album_tags[k].key);
+            bytes += estimate_cstr_bytes(e.album_tags[k].value);
+        }
+        for (size_t t = 0; e.tracks && t < e.tracks_count; ++t) {
+            const auto& tt = e.tracks[t];
+            bytes += sizeof(CdRipTrackTags);
+            for (size_t k = 0; tt.tags && k < tt.tags_count; ++k) {
+                bytes += sizeof(CdRipTagKV);
+                bytes += estimate_cstr_bytes(tt.tags[k].key);
+                bytes += estimate_cstr_bytes(tt.tags[k].value);
+            }
+        }
+    }
+    return bytes;
+}
+
+// Metadata lists keyed by build_metadata_cache_key(), evicted least recently used
+// first once the estimated footprint exceeds the byte budget.
+class EntryListCache {
+public:
+    explicit EntryListCache(
+        size_t max_bytes = kEntryListCacheMaxBytes)
+        : max_bytes_(max_bytes) {
+    }
+
+    const CdRipCddbEntryList* find(
+        const std::string& key) {
+
+        auto it = slots_.find(key);
+        if (it == slots_.end()) return nullptr;
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+        return it->second.list.get();
+    }
+
+    void store(
+        const std::string& key,
+        EntryListPtr list) {
+
+        if (key.empty() || !list) return;
+        erase(key);
+        const size_t bytes = estimate_entry_list_bytes(list.get());
+        lru_.push_front(key);
+        slots_.emplace(key, Slot{std::move(list), bytes, lru_.begin()});
+        total_bytes_ += bytes;
+        // Always keep the newest list, even if it alone exceeds the budget.
+        while (total_bytes_ > max_bytes_ && lru_.size() > 1) {
+            erase(lru_.back());
+        }
+    }
+
+private:
+    struct Slot {
+        EntryListPtr list;
+        size_t bytes{0};
+        std::list<std::string>::iterator lru;
+    };
+
+    void erase(
+        const std::string& key) {
+
+        auto it = slots_.find(key);
+        if (it == slots_.end()) return;
+        total_bytes_ -= it->second.bytes;
+        lru_.erase(it->second.lru);
+        slots_.erase(it);
+    }
+
+    size_t max_bytes_;
+    size_t total_bytes_{0};
+    std::list<std::string> lru_;
+    std::unordered_map<std::string, Slot> slots_;
+};
 
 void ensure_entry_ready_for_toc(
     CdRipCddbEntry* entry,
@@ -1552,6 +1782,133 @@ bool parse_discogs_mode(
     return false;
 }
 
+enum class CoverFileMode {
+    Embed,
+    File,
+    Thumbnail,
+};
+
+bool parse_cover_file_mode(
+    const std::string& raw,
+    CoverFileMode& out) {
+
+    std::string value = to_lower_ascii(trim_ws(raw));
+    if (value.empty()) value = "embed";
+    if (value == "embed") {
+        out = CoverFileMode::Embed;
+        return true;
+    }
+    if (value == "file") {
+        out = CoverFileMode::File;
+        return true;
+    }
+    if (value == "thumbnail") {
+        out = CoverFileMode::Thumbnail;
+        return true;
+    }
+    return false;
+}
+
+CdRipCoverArtEmbedModes cover_art_embed_mode_for(CoverFileMode mode) {
+    switch (mode) {
+        case CoverFileMode::Embed: return CDRIP_COVER_ART_EMBED_FULL;
+        case CoverFileMode::File: return CDRIP_COVER_ART_EMBED_NONE;
+        case CoverFileMode::Thumbnail: return CDRIP_COVER_ART_EMBED_THUMBNAIL;
+    }
+    return CDRIP_COVER_ART_EMBED_FULL;
+}
+
+// Writes the album cover file once per distinct track directory.
+void write_album_cover_files(
+    const CdRipCddbEntry* meta,
+    const std::vector<std::string>& track_paths,
+    std::unordered_set<std::string>& written_paths) {
+
+    if (!meta || !meta->cover_art.data || meta->cover_art.size == 0) return;
+    for (const auto& track_path : track_paths) {
+        const std::string cover_path = cdrip::detail::resolve_album_cover_path(track_path);
+        if (!written_paths.insert(cover_path).second) continue;
+        std::string cover_err;
+        if (!cdrip::detail::publish_album_cover_file(meta->cover_art, cover_path, cover_err)) {
+            std::cerr << "Cover art file error: " << cover_err << "\n";
+            continue;
+        }
+        std::cout << "Cover art written: " << cover_path << "\n";
+    }
+}
+
+enum class DuplicateMode {
+    Rip,
+    Warn,
+    Skip,
+    Eject,
+};
+
+bool parse_duplicate_mode(
+    const std::string& raw,
+    DuplicateMode& out) {
+
+    std::string value = to_lower_ascii(trim_ws(raw));
+    if (value.empty()) value = "warn";
+    if (value == "rip") {
+        out = DuplicateMode::Rip;
+        return true;
+    }
+    if (value == "warn") {
+        out = DuplicateMode::Warn;
+        return true;
+    }
+    if (value == "skip") {
+        out = DuplicateMode::Skip;
+        return true;
+    }
+    if (value == "eject") {
+        out = DuplicateMode::Eject;
+        return true;
+    }
+    return false;
+}
+
+// Album location recorded in the archive index: the directory of a track file, absolute for
+// local paths. Empty when the track has no directory of its own.
+std::string resolve_album_location(
+    const std::string& track_path) {
+
+    // Works for both local paths and URIs: both use '/' as the separator.
+    const auto slash = track_path.find_last_of('/');
+    if (slash == std::string::npos) return {};
+    const std::string directory = slash == 0 ? std::string{"/"} : track_path.substr(0, slash);
+    if (cdrip::detail::is_uri(directory)) return directory;
+    std::error_code ec;
+    const auto absolute = std::filesystem::absolute(directory, ec);
+    return ec ? directory : absolute.lexically_normal().string();
+}
+
+void register_archived_album(
+    const CdRipDiscToc* toc,
+    const std::string& track_path) {
+
+    // A track without a directory of its own would register the working directory, which
+    // always exists and would mark the disc as archived forever.
+    const std::string location = resolve_album_location(track_path);
+    if (location.empty()) return;
+    const char* archive_err = nullptr;
+    if (!cdrip_register_archived_disc(toc, location.c_str(), &archive_err) && archive_err) {
+        std::cerr << "Archive index error: " << view_string(archive_err) << "\n";
+    }
+    cdrip_release_error(archive_err);
+}
+
+const char* duplicate_mode_label(DuplicateMode mode) {
+    switch (mode) {
+        case DuplicateMode::Rip: return "rip";
+        case DuplicateMode::Warn: return "warn";
+        case DuplicateMode::Skip: return "skip";
+        case DuplicateMode::Eject: return "eject";
+    }
+    return "unknown";
+}
+
 const char* discogs_mode_label(DiscogsMode mode) {
     switch (mode) {
         case DiscogsMode::No: return "no";
@@ -1832,7 +2189,7 @@ CdRipCddbEntryList* merge_cddb_entries_for_toc(
 
 void clear_cover_art(CdRipCoverArt& art) {
     if (art.data) {
-        delete[] art.data;
+        cdrip::detail::release_cover_art_data(art.data);
         art.data = nullptr;
     }
     art.size = 0;
@@ -1881,44 +2238,292 @@ void clear_cover_art_fetch_attempt(
     attempt.had_error = false;
 }
 
+constexpr size_t kCoverArtPrefetchCandidates = 3;
+
+const char* cover_art_activity_label(CoverArtFetchSource src) {
+    switch (src) {
+        case CoverArtFetchSource::CoverArtArchive: return "coverartarchive";
+        case CoverArtFetchSource::Discogs: return "discogs";
+        case CoverArtFetchSource::None: break;
+    }
+    return nullptr;
+}
+
+// Fixed set of worker threads, used for cover art fetches, tag rewrites, ReplayGain scans,
+// verification and recompression.
+class WorkerPool {
+public:
+    explicit WorkerPool(
+        size_t thread_count) {
+
+        if (thread_count == 0) thread_count = 1;
+        for (size_t i = 0; i < thread_count; ++i) {
+            threads_.emplace_back([this]() { run(); });
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+    void submit(
+        std::function<void()> job) {
+
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        wake_.notify_one();
+    }
+
+    void drain() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this]() { return jobs_.empty() && running_ == 0; });
+    }
+
+    // Drops jobs that have not started; running jobs still finish.
+    void cancel_pending() {
+        std::deque<std::function<void()>> dropped;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            dropped.swap(jobs_);
+            if (running_ == 0) idle_.notify_all();
+        }
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+                if (jobs_.empty()) return;
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+                ++running_;
+            }
+            job();
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                --running_;
+                if (jobs_.empty() && running_ == 0) idle_.notify_all();
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<std::function<void()>> jobs_;
+    size_t running_{0};
+    bool stopping_{false};
+    std::vector<std::thread> threads_;
+};
+
+struct CoverArtFetchResult {
+    CdRipCoverArt art{};
+    bool success{false};
+    std::string error{};
+
+    CoverArtFetchResult() = default;
+    CoverArtFetchResult(const CoverArtFetchResult&) = delete;
+    CoverArtFetchResult& operator=(const CoverArtFetchResult&) = delete;
+    ~CoverArtFetchResult() {
+        clear_cover_art(art);
+    }
+};
+
+using CoverArtFetchResultPtr = std::shared_ptr<const CoverArtFetchResult>;
+using CoverArtFetchFuture = std::shared_future<CoverArtFetchResultPtr>;
+
+// Runs cover art fetches in the background so that both sources and every candidate entry
+// download concurrently, and so that candidates can be fetched speculatively while the user
+// is still choosing a CDDB entry. Results are keyed by the release ids the fetchers actually
+// use, so the same album requested twice shares one download.
+class CoverArtFetchPool {
+public:
+    explicit CoverArtFetchPool(
+        DiscogsMode discogs_mode)
+        : discogs_mode_(discogs_mode) {
+    }
+
+    CoverArtFetchPool(const CoverArtFetchPool&) = delete;
+    CoverArtFetchPool& operator=(const CoverArtFetchPool&) = delete;
+
+    // Queued fetches nobody waited on are dropped, so leaving the album's scope does not wait
+    // for every speculative download; fetches already running still finish.
+    ~CoverArtFetchPool() {
+        workers_.cancel_pending();
+    }
+
+    void prefetch(
+        const CdRipCddbEntry& entry,
+        const CdRipDiscToc* toc) {
+
+        if (discogs_mode_ != DiscogsMode::No) {
+            request(entry, toc, CoverArtFetchSource::Discogs);
+        }
+        request(entry, toc, CoverArtFetchSource::CoverArtArchive);
+    }
+
+    CoverArtFetchFuture request(
+        const CdRipCddbEntry& entry,
+        const CdRipDiscToc* toc,
+        CoverArtFetchSource source,
+        bool refresh = false) {
+
+        if (source == CoverArtFetchSource::CoverArtArchive && has_cover_art_data_local(entry.cover_art)) {
+            auto result = std::make_shared<CoverArtFetchResult>();
+            result->art = clone_cover_art(entry.cover_art);
+            result->success = true;
+            return make_ready(std::move(result));
+        }
+
+        const std::string key = build_key(entry, toc, source);
+        if (key.empty()) {
+            // The fetcher would return without touching the network; skip the worker.
+            return make_ready(std::make_shared<CoverArtFetchResult>());
+        }
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!refresh) {
+            auto it = jobs_.find(key);
+            if (it != jobs_.end()) return it->second;
+        }
+
+        EntryListPtr cloned_list(new CdRipCddbEntryList{});
+        cloned_list->count = 1;
+        cloned_list->entries = new CdRipCddbEntry[1]{};
+        cloned_list->entries[0] = clone_cddb_entry(entry);
+        const std::string toc_release_id = view_string(toc ? toc->mb_release_id : nullptr);
+        const CoverArtFetchFunction fetch_fn = (source == CoverArtFetchSource::Discogs)
+            ? &cdrip_fetch_discogs_cover_art
+            : &cdrip_fetch_cover_art;
+
+        auto task = std::make_shared<std::packaged_task<CoverArtFetchResultPtr()>>([
+            list = std::shared_ptr<CdRipCddbEntryList>(std::move(cloned_list)),
+            toc_release_id,
+            fetch_fn
+        ]() -> CoverArtFetchResultPtr {
+            // Only the release id is read from the TOC; keep a private copy so the
+            // worker never depends on the caller's TOC lifetime.
+            CdRipDiscToc local_toc{};
+            local_toc.mb_release_id = toc_release_id.empty() ? nullptr : toc_release_id.c_str();
+
+            auto result = std::make_shared<CoverArtFetchResult>();
+            CdRipCddbEntry* cloned = &list->entries[0];
+            const char* cover_err = nullptr;
+            const int ok = fetch_fn(cloned, &local_toc, nullptr, nullptr, &cover_err);
+            if (ok && has_cover_art_data_local(cloned->cover_art)) {
+                result->art = clone_cover_art(cloned->cover_art);
+                result->success = true;
+            } else if (cover_err) {
+                result->error = view_string(cover_err);
+            }
+            if (cover_err) cdrip_release_error(cover_err);
+            return result;
+        });
+        CoverArtFetchFuture future = task->get_future().share();
+        workers_.submit([task]() { (*task)(); });
+        jobs_[key] = future;
+        return future;
+    }
+
+private:
+    static CoverArtFetchFuture make_ready(
+        CoverArtFetchResultPtr result) {
+
+        std::promise<CoverArtFetchResultPtr> promise;
+        promise.set_value(std::move(result));
+        return promise.get_future().share();
+    }
+
+    static std::string build_key(
+        const CdRipCddbEntry& entry,
+        const CdRipDiscToc* toc,
+        CoverArtFetchSource source) {
+
+        if (to_lower_ascii(view_string(entry.source_label)) != "musicbrainz") return {};
+        if (source == CoverArtFetchSource::Discogs) {
+            const std::string discogs_release = trim_ws(get_album_tag(&entry, "DISCOGS_RELEASE"));
+            if (discogs_release.empty()) return {};
+            return "discogs:" + discogs_release;
+        }
+        if (entry.cover_art.available == 0) return {};
+        std::string release_id = get_album_tag(&entry, "MUSICBRAINZ_RELEASE");
+        if (release_id.empty()) release_id = view_string(toc ? toc->mb_release_id : nullptr);
+        const std::string release_group_id = get_album_tag(&entry, "MUSICBRAINZ_RELEASEGROUPID");
+        if (release_id.empty() && release_group_id.empty()) return {};
+        return "caa:" + release_id + "|" + release_group_id;
+    }
+
+    // Speculative prefetch can queue many candidates; only a few download at once.
+    static constexpr size_t kFetchThreads = 4;
+
+    DiscogsMode discogs_mode_;
+    std::mutex mutex_{};
+    std::map<std::string, CoverArtFetchFuture> jobs_{};
+    // Declared last so its threads are joined before the jobs they fulfill are destroyed.
+    WorkerPool workers_{kFetchThreads};
+};
+
+void notify_cover_art_wait(
+    const CdRipActivityObserver* observer,
+    void* observer_state,
+    CoverArtFetchSource source) {
+
+    CdRipActivityInfo info{};
+    info.phase = CDRIP_ACTIVITY_PHASE_COVER_ART_FETCH;
+    info.state = CDRIP_ACTIVITY_STATE_SOURCE_STARTED;
+    info.source_label = cover_art_activity_label(source);
+    info.total_sources = 1;
+    cdrip::detail::notify_activity(observer, observer_state, info);
+}
+
 CoverArtFetchAttempt fetch_cover_art_attempt(
     const std::vector<CdRipCddbEntry*>& effective,
     const CdRipDiscToc* toc,
-    CoverArtFetchFunction fetch_fn,
+    CoverArtFetchPool& pool,
     CoverArtFetchSource phase_source,
     std::string& notice_out) {
 
     CoverArtFetchAttempt result{};
+    std::vector<CoverArtFetchFuture> pending;
+    pending.reserve(effective.size());
+    for (CdRipCddbEntry* e : effective) {
+        if (!e) continue;
+        pending.push_back(pool.request(*e, toc, phase_source));
+    }
+
     ActivitySpinner phase_spinner{CDRIP_ACTIVITY_PHASE_COVER_ART_FETCH};
-    const CdRipActivityObserver* observer = nullptr;
     if (phase_spinner.enabled()) {
         phase_spinner.start();
-        observer = phase_spinner.observer();
+        notify_cover_art_wait(phase_spinner.observer(), &phase_spinner, phase_source);
     }
-    void* observer_state = static_cast<void*>(&phase_spinner);
-    for (CdRipCddbEntry* e : effective) {
-        if (!e) continue;
-
-        EntryListPtr cloned_list(new CdRipCddbEntryList{});
-        cloned_list->count = 1;
-        cloned_list->entries = new CdRipCddbEntry[1]{};
-        cloned_list->entries[0] = clone_cddb_entry(*e);
-
-        CdRipCddbEntry* cloned = &cloned_list->entries[0];
-        const char* cover_err = nullptr;
-        const int ok = fetch_fn(cloned, toc, observer, observer_state, &cover_err);
-        if (ok && has_cover_art_data_local(cloned->cover_art)) {
-            result.art = clone_cover_art(cloned->cover_art);
+    // Candidates keep their priority order even though they download concurrently.
+    for (const auto& future : pending) {
+        const CoverArtFetchResultPtr fetched = future.get();
+        if (fetched && fetched->success) {
+            result.art = clone_cover_art(fetched->art);
             result.source = phase_source;
             result.success = true;
-            if (cover_err) cdrip_release_error(cover_err);
             phase_spinner.stop();
             return result;
         }
-        if (cover_err) {
-            notice_out = view_string(cover_err);
+        if (fetched && !fetched->error.empty()) {
+            notice_out = fetched->error;
             result.had_error = true;
-            cdrip_release_error(cover_err);
         }
     }
     phase_spinner.stop();
@@ -1987,7 +2592,8 @@ bool ensure_cover_art_merged(
     bool allow_source_choice,
     CoverArtFetchSource& source_out,
     std::string& notice_out,
-    bool allow_aa) {
+    bool allow_aa,
+    CoverArtFetchPool* cover_art_pool = nullptr) {
 
     notice_out.clear();
     source_out = CoverArtFetchSource::None;
@@ -2006,44 +2612,61 @@ bool ensure_cover_art_merged(
         }
     }
 
+    std::optional<CoverArtFetchPool> local_pool;
+    if (!cover_art_pool) local_pool.emplace(discogs_mode);
+    CoverArtFetchPool& pool = cover_art_pool ? *cover_art_pool : *local_pool;
+
+    // Start every source/candidate combination up front; the phases below only wait on
+    // the results in their preferred order.
+    for (CdRipCddbEntry* e : effective) {
+        if (!e) continue;
+        if (allow_source_choice || discogs_mode != DiscogsMode::No) {
+            pool.request(*e, toc, CoverArtFetchSource::Discogs);
+        }
+        pool.request(*e, toc, CoverArtFetchSource::CoverArtArchive);
+    }
+
     struct PhaseResult {
         bool success{false};
         bool had_error{false};
     };
 
-    auto try_phase = [&](auto fetch_fn, CoverArtFetchSource phase_source) -> PhaseResult {
+    auto try_phase = [&](CoverArtFetchSource phase_source, bool refresh) -> PhaseResult {
         PhaseResult result{};
+        std::vector<std::pair<CdRipCddbEntry*, CoverArtFetchFuture>> pending;
+        pending.reserve(effective.size());
+        for (CdRipCddbEntry* e : effective) {
+            if (!e) continue;
+            pending.emplace_back(e, pool.request(*e, toc, phase_source, refresh));
+        }
+
         ActivitySpinner phase_spinner{CDRIP_ACTIVITY_PHASE_COVER_ART_FETCH};
-        const CdRipActivityObserver* observer = nullptr;
         if (phase_spinner.enabled()) {
             phase_spinner.start();
-            observer = phase_spinner.observer();
+            notify_cover_art_wait(phase_spinner.observer(), &phase_spinner, phase_source);
         }
-        void* observer_state = static_cast<void*>(&phase_spinner);
-        for (CdRipCddbEntry* e : effective) {
-            if (!e) continue;
-            const bool had_data = (e->cover_art.data && e->cover_art.size > 0);
-            const char* cover_err = nullptr;
-            const int ok = fetch_fn(e, toc, observer, observer_state, &cover_err);
-            if (ok && has_cover_art_data_local(e->cover_art)) {
+        for (auto& item : pending) {
+            CdRipCddbEntry* e = item.first;
+            const bool had_data = has_cover_art_data_local(e->cover_art);
+            const CoverArtFetchResultPtr fetched = item.second.get();
+            if (fetched && fetched->success) {
+                replace_cover_art(e->cover_art, fetched->art);
                 if (e != target) {
                     replace_cover_art(target->cover_art, e->cover_art);
                 }
+                phase_spinner.stop();
                 if (allow_aa && !had_data) {
                     maybe_print_cover_art_ascii(target->cover_art);
                 }
                 if (!had_data) {
                     source_out = phase_source;
                 }
-                if (cover_err) cdrip_release_error(cover_err);
                 result.success = true;
-                phase_spinner.stop();
                 return result;
             }
-            if (cover_err) {
-                notice_out = view_string(cover_err);
+            if (fetched && !fetched->error.empty()) {
+                notice_out = fetched->error;
                 result.had_error = true;
-                cdrip_release_error(cover_err);
             }
         }
         phase_spinner.stop();
@@ -2054,13 +2677,13 @@ bool ensure_cover_art_merged(
         CoverArtFetchAttempt caa_attempt = fetch_cover_art_attempt(
             effective,
             toc,
-            &cdrip_fetch_cover_art,
+            pool,
             CoverArtFetchSource::CoverArtArchive,
             notice_out);
         CoverArtFetchAttempt discogs_attempt = fetch_cover_art_attempt(
             effective,
             toc,
-            &cdrip_fetch_discogs_cover_art,
+            pool,
             CoverArtFetchSource::Discogs,
             notice_out);
 
@@ -2105,30 +2728,30 @@ bool ensure_cover_art_merged(
     }
 
     if (discogs_mode == DiscogsMode::Always) {
-        PhaseResult discogs_result = try_phase(&cdrip_fetch_discogs_cover_art, CoverArtFetchSource::Discogs);
+        PhaseResult discogs_result = try_phase(CoverArtFetchSource::Discogs, false);
         if (discogs_result.success) return true;
         // Keep any existing cover art if Discogs did not succeed.
         if (target_has_cover) return true;
-        PhaseResult caa_result = try_phase(&cdrip_fetch_cover_art, CoverArtFetchSource::CoverArtArchive);
+        PhaseResult caa_result = try_phase(CoverArtFetchSource::CoverArtArchive, false);
         if (caa_result.success) return true;
         if (caa_result.had_error) {
-            PhaseResult retry_discogs = try_phase(&cdrip_fetch_discogs_cover_art, CoverArtFetchSource::Discogs);
+            PhaseResult retry_discogs = try_phase(CoverArtFetchSource::Discogs, true);
             if (retry_discogs.success) return true;
         }
         return false;
     }
     if (discogs_mode == DiscogsMode::Fallback) {
-        PhaseResult caa_result = try_phase(&cdrip_fetch_cover_art, CoverArtFetchSource::CoverArtArchive);
+        PhaseResult caa_result = try_phase(CoverArtFetchSource::CoverArtArchive, false);
         if (caa_result.success) return true;
-        PhaseResult discogs_result = try_phase(&cdrip_fetch_discogs_cover_art, CoverArtFetchSource::Discogs);
+        PhaseResult discogs_result = try_phase(CoverArtFetchSource::Discogs, false);
         if (discogs_result.success) return true;
         if (discogs_result.had_error) {
-            PhaseResult retry_caa = try_phase(&cdrip_fetch_cover_art, CoverArtFetchSource::CoverArtArchive);
+            PhaseResult retry_caa = try_phase(CoverArtFetchSource::CoverArtArchive, true);
             if (retry_caa.success) return true;
         }
         return false;
     }
-    return try_phase(&cdrip_fetch_cover_art, CoverArtFetchSource::CoverArtArchive).success;
+    return try_phase(CoverArtFetchSource::CoverArtArchive, false).success;
 }
 
 struct CddbSelection {
@@ -2150,7 +2773,8 @@ CddbSelection select_cddb_entry_for_toc(
     int recrawl_track_length_tolerance_percent = kDefaultMusicBrainzRecrawlTrackLengthTolerancePercent,
     bool log_recrawl = false,
     EntryListCache* metadata_cache = nullptr,
-    const GRegex* title_filter = nullptr) {
+    const GRegex* title_filter = nullptr,
+    CoverArtFetchPool* cover_art_pool = nullptr) {
 
     CddbSelection result{};
     if (!toc || !servers) return result;
@@ -2183,9 +2807,8 @@ CddbSelection select_cddb_entry_for_toc(
     if (metadata_cache) {
         cache_key = build_metadata_cache_key(toc);
         if (!cache_key.empty()) {
-            auto it = metadata_cache->find(cache_key);
-            if (it != metadata_cache->end() && it->second) {
-                entries = clone_cddb_entry_list(it->second.get());
+            if (const auto* cached = metadata_cache->find(cache_key)) {
+                entries = clone_cddb_entry_list(cached);
             }
         }
     }
@@ -2225,8 +2848,8 @@ CddbSelection select_cddb_entry_for_toc(
                 &fetch_err);
         }
         if (entries && metadata_cache && !cache_key.empty()) {
-            (*metadata_cache)[cache_key] = EntryListPtr(
-                clone_cddb_entry_list(entries));
+            metadata_cache->store(cache_key, EntryListPtr(
+                clone_cddb_entry_list(entries)));
         }
     }
     std::cout << "\n";
@@ -2340,6 +2963,13 @@ CddbSelection select_cddb_entry_for_toc(
                       << get_album_media_tag(&chosen) << "\".\n";
         }
     } else {
+        if (cover_art_pool && had_candidates_before_fallback) {
+            // Start downloading cover art for the leading candidates while the user decides.
+            const size_t prefetch_count = std::min(sorted_indices.size(), kCoverArtPrefetchCandidates);
+            for (size_t i = 0; i < prefetch_count; ++i) {
+                cover_art_pool->prefetch(entries->entries[sorted_indices[i]], toc);
+            }
+        }
         while (true) {
             std::cout << "\nSelect match [0-" << sorted_indices.size()
                       << "] (comma/space separated, default 1): ";
@@ -2683,14 +3313,33 @@ struct Options {
     std::optional<std::string> filter_title;
     std::optional<bool> auto_mode;
     std::optional<bool> speed_fast;
+    std::optional<int> encoder_threads;
+    std::optional<int> read_offset;
+    std::optional<std::string> accuraterip;
+    std::optional<bool> read_quality;
+    std::optional<int> sector_budget;
+    std::optional<int> track_budget;
+    std::optional<bool> sequential;
+    std::optional<bool> image;
+    std::vector<std::string> outputs;
     std::optional<bool> replaygain;
     std::optional<std::string> discogs;
+    std::optional<std::string> cover_file;
+    std::optional<std::string> duplicate;
     std::string config_file;
     bool no_eject = false;
     bool no_aa = false;
     bool no_recrawl = false;
     bool logs = false;
+    bool dry_run = false;
     std::vector<std::string> update_paths;
+    std::vector<std::string> replaygain_paths;
+    std::vector<std::string> verify_paths;
+    std::string verify_report;
+    bool replaygain_force = false;
+    std::vector<std::string> recompress_paths;
+    std::optional<int> recompress_level;
+    bool recompress_exhaustive = false;
 };
 
 Options parse_args(int argc, char** argv) {
@@ -2702,7 +3351,14 @@ Options parse_args(int argc, char** argv) {
         } else if ((arg == "-f" || arg == "--format") && i + 1 < argc) {
             opts.format = argv[++i];
         } else if ((arg == "-c" || arg == "--compression") && i + 1 < argc) {
-            opts.compression_level = std::stoi(argv[++i]);
+            const std::string value = cdrip::detail::to_lower(argv[++i]);
+            if (value == "auto") {
+                opts.compression_level = CDRIP_COMPRESSION_AUTO;
+            } else if (value == "adaptive") {
+                opts.compression_level = CDRIP_COMPRESSION_ADAPTIVE;
+            } else {
+                opts.compression_level = std::stoi(value);
+            }
         } else if ((arg == "-w" || arg == "--max-width") && i + 1 < argc) {
             int v = 0;
             try {
@@ -2722,6 +3378,12 @@ Options parse_args(int argc, char** argv) {
                 opts.rip_mode = RIP_MODES_FAST;
             } else if (mode == "best") {
                 opts.rip_mode = RIP_MODES_BEST;
+            } else if (mode == "verify") {
+                opts.rip_mode = RIP_MODES_VERIFY;
+            } else if (mode == "hybrid") {
+                opts.rip_mode = RIP_MODES_HYBRID;
+            } else if (mode == "salvage") {
+                opts.rip_mode = RIP_MODES_SALVAGE;
             } else {
                 opts.rip_mode = RIP_MODES_DEFAULT;
             }
@@ -2739,16 +3401,60 @@ Options parse_args(int argc, char** argv) {
             opts.speed_fast = false;
         } else if (arg == "-sf" || arg == "--speed-fast") {
             opts.speed_fast = true;
+        } else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) {
+            int v = 0;
+            if (!parse_encoder_threads(argv[++i], v)) {
+                std::cerr << "Error: -t/--threads requires auto or a positive integer\n";
+                std::exit(1);
+            }
+            opts.encoder_threads = v;
+        } else if ((arg == "-ro" || arg == "--read-offset") && i + 1 < argc) {
+            int v = 0;
+            if (!parse_int_value(argv[++i], v)) {
+                std::cerr << "Error: -ro/--read-offset requires an integer (samples)\n";
+                std::exit(1);
+            }
+            opts.read_offset = v;
+        } else if ((arg == "-ar" || arg == "--accuraterip") && i + 1 < argc) {
+            opts.accuraterip = argv[++i];
+        } else if (arg == "-rq" || arg == "--read-quality") {
+            opts.read_quality = true;
+        } else if ((arg == "-sb" || arg == "--sector-budget") && i + 1 < argc) {
+            int v = 0;
+            if (!parse_int_value(argv[++i], v) || v < 0) {
+                std::cerr << "Error: -sb/--sector-budget requires a non-negative integer (seconds)\n";
+                std::exit(1);
+            }
+            opts.sector_budget = v;
+        } else if ((arg == "-tb" || arg == "--track-budget") && i + 1 < argc) {
+            int v = 0;
+            if (!parse_int_value(argv[++i], v) || v < 0) {
+                std::cerr << "Error: -tb/--track-budget requires a non-negative integer (seconds)\n";
+                std::exit(1);
+            }
+            opts.track_budget = v;
+        } else if (arg == "-sq" || arg == "--sequential") {
+            opts.sequential = true;
+        } else if (arg == "-im" || arg == "--image") {
+            opts.image = true;
+        } else if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            opts.outputs.push_back(argv[++i]);
         } else if (arg == "-g" || arg == "--replaygain") {
             opts.replaygain = true;
         } else if (arg == "-ng" || arg == "--no-replaygain") {
             opts.replaygain = false;
         } else if ((arg == "-dc" || arg == "--discogs") && i + 1 < argc) {
             opts.discogs = argv[++i];
+        } else if ((arg == "-cf" || arg == "--cover-file") && i + 1 < argc) {
+            opts.cover_file = argv[++i];
+        } else if ((arg == "-dp" || arg == "--duplicate") && i + 1 < argc) {
+            opts.duplicate = argv[++i];
         } else if (arg == "-na" || arg == "--no-aa") {
             opts.no_aa = true;
         } else if (arg == "-nr" || arg == "--no-recrawl") {
             opts.no_recrawl = true;
+        } else if (arg == "-dr" || arg == "--dry-run") {
+            opts.dry_run = true;
         } else if (arg == "-l" || arg == "--logs") {
             opts.logs = true;
         } else if (arg == "-ne" || arg == "--no-eject") {
@@ -2763,34 +3469,129 @@ Options parse_args(int argc, char** argv) {
                 std::cerr << "Error: -u/--update requires at least one path\n";
                 std::exit(1);
             }
-        } else if (arg == "-?" || arg == "-h" || arg == "--help") {
-            std::cout << "Usage: cdrip [-d device] [-f format] [-m mode] [-c compression] [-w px] [--max-width px] [-s] [-ft regex] [-nr] [-l] [-r] [-ne] [-a] [-ss|-sf] [-g|-ng] [-dc no|always|fallback] [-na] [-i config] [-u file|dir ...]\n";
-            std::cout << "  -d  / --device: CD device path (default: auto-detect)\n";
-            std::cout << "  -f  / --format: FLAC destination path format (default: \"{album:n/medium:n/tracknumber:02d}_{title:n}.flac\")\n";
-            std::cout << "  -m  / --mode: Integrity check mode: \"best\" (full integrity checks, default), \"fast\" (disabled any checks)\n";
-            std::cout << "  -c  / --compression: FLAC compression level (default: auto (best --> 5, fast --> 1))\n";
-            std::cout << "  -w  / --max-width: Cover art max width in pixels (default: 512)\n";
-            std::cout << "  -s  / --sort: Sort CDDB results by album name on the prompt\n";
-            std::cout << "  -ft / --filter-title: Filter CDDB candidates by title using case-insensitive regex (UTF-8)\n";
-            std::cout << "  -nr / --no-recrawl: Disable MusicBrainz recrawl from CDDB titles (revert to MB-0-only behavior)\n";
-            std::cout << "  -r  / --repeat: Prompt for next disc after finishing\n";
-            std::cout << "  -ne / --no-eject: Keep disc in the drive after ripping finishes\n";
-            std::cout << "  -a  / --auto: Enable fully automatic mode (without any prompts)\n";
+        } else if (arg == "-gs" || arg == "--replaygain-scan") {
+            if (i + 1 < argc) {
+                opts.replaygain_paths.push_back(argv[++i]);
+            } else {
+                std::cerr << "Error: -gs/--replaygain-scan requires at least one path\n";
+                std::exit(1);
+            }
+        } else if (arg == "-gf" || arg == "--replaygain-force") {
+            opts.replaygain_force = true;
+        } else if (arg == "-vf" || arg == "--verify") {
+            if (i + 1 < argc) {
+                opts.verify_paths.push_back(argv[++i]);
+            } else {
+                std::cerr << "Error: -vf/--verify requires at least one path\n";
+                std::exit(1);
+            }
+        } else if ((arg == "-vr" || arg == "--verify-report") && i + 1 < argc) {
+            opts.verify_report = argv[++i];
+        } else if (arg == "-rc" || arg == "--recompress") {
+            if (i + 1 < argc) {
+                opts.recompress_paths.push_back(argv[++i]);
+            } else {
+                std::cerr << "Error: -rc/--recompress requires at least one path\n";
+                std::exit(1);
+            }
+        } else if ((arg == "-rl" || arg == "--recompress-level") && i + 1 < argc) {
+            int v = -1;
+            try {
+                v = std::stoi(argv[++i]);
+            } catch (...) {
+            }
+            if (v < 0 || v > 8) {
+                std::cerr << "Error: -rl/--recompress-level requires a level between 0 and 8\n";
+                std::exit(1);
+            }
+            opts.recompress_level = v;
+        } else if (arg == "-rx" || arg == "--recompress-exhaustive") {
+            opts.recompress_exhaustive = true;
+        } else if (arg == "-?" || arg == "-h" || arg == "--help") {
+            std::cout << "Usage: cdrip [-d device] [-f format] [-m mode] [-c compression] [-w px] [--max-width px] [-s] [-ft regex] [-nr] [-l] [-r] [-ne] [-a] [-ss|-sf] [-t threads] [-ro samples] [-ar dir|url] [-g|-ng] [-dc no|always|fallback] [-cf embed|file|thumbnail] [-dp rip|warn|skip|eject] [-na] [-i config] [-u file|dir ...] [-gs file|dir ... [-gf]] [-vf file|dir ... [-vr report]] [-rc file|dir ... [-rl level] [-rx]] [-dr]\n";
+            std::cout << "  -d  / --device: CD device path (default: auto-detect), or image:///path/disc.cue (also .wav/.bin) to rip a stored disc image\n";
+            std::cout << "  -f  / --format: FLAC destination path format (default: \"{album:n/medium:n/tracknumber:02d}_{title:n}.flac\")\n";
+            std::cout << "  -m  / --mode: Integrity check mode: \"best\" (full integrity checks, default), \"fast\" (disabled any checks), \"verify\" (read twice, full checks only where reads differ), \"hybrid\" (overlap checks, full checks around read errors), \"salvage\" (whole disc fast first, then retry only damaged ranges slower with more checks)\n";
+            std::cout << "  -c  / --compression: FLAC compression level 0-8, auto or adaptive (default: auto (best --> 5, fast --> 1))\n";
+            std::cout << "  -w  / --max-width: Cover art max width in pixels (default: 512)\n";
+            std::cout << "  -s  / --sort: Sort CDDB results by album name on the prompt\n";
+            std::cout << "  -ft / --filter-title: Filter CDDB candidates by title using case-insensitive regex (UTF-8)\n";
+            std::cout << "  -nr / --no-recrawl: Disable MusicBrainz recrawl from CDDB titles (revert to MB-0-only behavior)\n";
+            std::cout << "  -r  / --repeat: Prompt for next disc after finishing\n";
+            std::cout << "  -ne / --no-eject: Keep disc in the drive after ripping finishes\n";
+            std::cout << "  -a  / --auto: Enable fully automatic mode (without any prompts)\n";
             std::cout << "  -ss / --speed-slow: Request 1x drive read speed when ripping starts (default)\n";
             std::cout << "  -sf / --speed-fast: Request maximum drive read speed when ripping starts\n";
+            std::cout << "  -t  / --threads: FLAC encoder threads per track: auto (all cores with -sf, otherwise 1, default) or a count (needs libFLAC 1.5)\n";
+            std::cout << "  -ro / --read-offset: Drive read offset in samples, as listed by AccurateRip (default: 0; disc images use only this option, not cdrip.read_offset)\n";
+            std::cout << "  -ar / --accuraterip: AccurateRip database to verify tracks against: directory of dBAR files or http(s) base URL (default: none)\n";
+            std::cout << "  -rq / --read-quality: Collect read quality telemetry: per-track summary, CDRIP_READ_QUALITY tag and read_report.json per album\n";
+            std::cout << "  -sb / --sector-budget: Seconds a sector read may take before integrity checks are lowered; slow sectors are then flagged, unreadable ones silenced (default: 0, unlimited)\n";
+            std::cout << "  -tb / --track-budget: Seconds of reading per track before integrity checks are disabled for the rest of it (default: 0, unlimited)\n";
+            std::cout << "  -sq / --sequential: Read adjacent tracks as one continuous stream, without seeking at track boundaries\n";
+            std::cout << "  -im / --image: Rip the whole disc into one FLAC image with an embedded CUESHEET and SEEKTABLE\n";
+            std::cout << "  -o  / --output: Extra output from the same read, repeatable: KIND[:LEVEL]=FORMAT with KIND flac, wav, aiff or raw (e.g. \"flac:0={album:n}/{tracknumber:02d}_{title:n}.flac\")\n";
             std::cout << "  -g  / --replaygain: Enable ReplayGain tagging (default)\n";
             std::cout << "  -ng / --no-replaygain: Disable ReplayGain tagging and save each track immediately\n";
             std::cout << "  -dc / --discogs: Cover art preference for Discogs: no, always (default), fallback\n";
+            std::cout << "  -cf / --cover-file: Cover art storage: embed (every track, default), file (cover.png only), thumbnail (cover.png + small embedded art)\n";
+            std::cout << "  -dp / --duplicate: Disc already in the archive index: rip, warn (default), skip, eject\n";
             std::cout << "  -na / --no-aa: Disable cover art ANSI/ASCII art output\n";
             std::cout << "  -l  / --logs: Print debug logs for MusicBrainz recrawl and selected metadata\n";
             std::cout << "  -i  / --input: cdrip config file path (default search: ./cdrip.conf --> ~/.cdrip.conf)\n";
             std::cout << "  -u  / --update <file|dir> [more ...]: Update existing FLAC tags from CDDB using embedded tags (other options ignored)\n";
+            std::cout << "  -gs / --replaygain-scan <file|dir> [more ...]: Compute ReplayGain for existing FLAC files, one album per thread (other options ignored)\n";
+            std::cout << "  -gf / --replaygain-force: With -gs, rescan albums that already have ReplayGain tags\n";
+            std::cout << "  -vf / --verify <file|dir> [more ...]: Decode FLAC files and check the STREAMINFO MD5 and the PCM_CRC32 tag (other options ignored)\n";
+            std::cout << "  -vr / --verify-report: With -vf, write the tab separated report to this file instead of stdout\n";
+            std::cout << "  -rc / --recompress <file|dir> [more ...]: Re-encode FLAC files at a higher level on idle cores, replacing only verified smaller files (other options ignored)\n";
+            std::cout << "  -rl / --recompress-level: With -rc, FLAC compression level to re-encode with (default: 8)\n";
+            std::cout << "  -rx / --recompress-exhaustive: With -rc, also enable exhaustive model search (much slower)\n";
+            std::cout << "  -dr / --dry-run: With -u, -gs or -rc, only report which files would change; nothing is written\n";
             std::exit(0);
         }
     }
     return opts;
 }
 
+// Metadata selection shared by every file of one album while its tags are written.
+struct AlbumSelection {
+    CddbSelection selection{};
+    // Track files of the album and tag writes still running; guarded by the caller's mutex.
+    std::vector<std::string> paths{};
+    size_t pending{0};
+    bool failed{false};
+
+    AlbumSelection() = default;
+    AlbumSelection(const AlbumSelection&) = delete;
+    AlbumSelection& operator=(const AlbumSelection&) = delete;
+
+    ~AlbumSelection() {
+        if (selection.entries) cdrip_release_cddbentry_list(selection.entries);
+        if (selection.merged) cdrip_release_cddbentry_list(selection.merged);
+    }
+};
+
+
+size_t tag_writer_thread_count() {
+    const unsigned int hw = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(hw == 0 ? 2 : hw, 2, kMaxTagWriterThreads);
+}
+
+// Decoding is CPU bound, so the ReplayGain scan and verification use every core.
+size_t decode_thread_count() {
+    const unsigned int hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 2 : static_cast<size_t>(hw);
+}
+
+bool has_replaygain_tags(
+    const std::string& path) {
+
+    std::map<std::string, std::string> tags;
+    if (!cdrip::detail::read_flac_vorbis_tags(path, tags)) return false;
+    return tags.count("REPLAYGAIN_TRACK_GAIN") > 0 && tags.count("REPLAYGAIN_ALBUM_GAIN") > 0;
+}
+
 int run_update_mode(
     const std::vector<std::string>& target_paths,
     const CdRipCddbServerList* servers,
@@ -2801,6 +3602,8 @@ int run_update_mode(
     bool log_recrawl,
     DiscogsMode discogs_mode,
     bool allow_aa,
+    bool write_cover_file,
+    bool dry_run,
     const GRegex* title_filter) {
 
     if (!servers || servers->count == 0) {
@@ -2813,7 +3616,10 @@ int run_update_mode(
     }
 
     EntryListCache metadata_cache;
+    std::unordered_set<std::string> written_cover_paths;
+    WorkerPool writer_pool{tag_writer_thread_count()};
     size_t updated_total = 0;
+    size_t unchanged_total = 0;
     for (size_t pi = 0; pi < target_paths.size(); ++pi) {
         const std::string& target_path = target_paths[pi];
         std::cout << "\n=== Update target (" << (pi + 1) << "/" << target_paths.size() << "): " << target_path << " ===\n";
@@ -2835,74 +3641,482 @@ int run_update_mode(
             continue;
         }
 
-        size_t updated = 0;
+        // Group files by album so metadata and cover art are resolved once per disc.
+        std::vector<std::vector<size_t>> albums;
+        std::unordered_map<std::string, size_t> album_index;
         for (size_t i = 0; i < list->count; ++i) {
             const auto& item = list->items[i];
-            std::cout << "\n[" << (i + 1) << "/" << list->count << "] " << view_string(item.path) << "\n";
             if (!item.valid || !item.toc) {
+                std::cout << "\n[" << (i + 1) << "/" << list->count << "] " << view_string(item.path) << "\n";
                 std::cout << "  Skipped: " << view_string(item.reason) << "\n";
                 continue;
             }
+            std::string key = build_metadata_cache_key(item.toc);
+            if (key.empty()) key = "path:" + view_string(item.path);
+            auto [it, inserted] = album_index.emplace(key, albums.size());
+            if (inserted) {
+                albums.emplace_back();
+                // Seed the archive index from the existing library; a dry run writes nothing.
+                if (!dry_run) register_archived_album(item.toc, view_string(item.path));
+            }
+            albums[it->second].push_back(i);
+        }
+
+        // Each file is reported as soon as its tags are written; output_mutex also guards the
+        // counters and the cover files written by the last job of an album.
+        std::mutex output_mutex;
+        size_t updated = 0;
+        size_t unchanged = 0;
+        auto report_file = [&](size_t index, const std::string& result) {
+            std::cout << "[" << (index + 1) << "/" << list->count << "] "
+                      << view_string(list->items[index].path) << "\n";
+            std::cout << "  " << result << "\n";
+        };
+        for (size_t ai = 0; ai < albums.size(); ++ai) {
+            const auto& files = albums[ai];
+            const auto& first = list->items[files.front()];
+            {
+                std::lock_guard<std::mutex> guard(output_mutex);
+                std::cout << "\n[Album " << (ai + 1) << "/" << albums.size() << "] " << view_string(first.path);
+                if (files.size() > 1) std::cout << " (+" << (files.size() - 1) << " file(s))";
+                std::cout << "\n";
+            }
 
-            const std::string cache_key = build_metadata_cache_key(item.toc);
-            auto selection = select_cddb_entry_for_toc(
-                item.toc, servers, sort, view_string(item.path), auto_mode,
+            const std::string cache_key = build_metadata_cache_key(first.toc);
+            CoverArtFetchPool cover_art_pool{discogs_mode};
+            auto album = std::make_shared<AlbumSelection>();
+            album->selection = select_cddb_entry_for_toc(
+                first.toc, servers, sort, view_string(first.path), auto_mode,
                 /*allow_fallback=*/false,
                 allow_recrawl,
                 recrawl_track_length_tolerance_percent,
                 log_recrawl,
                 &metadata_cache,
-                title_filter);
+                title_filter,
+                &cover_art_pool);
+            auto& selection = album->selection;
             if (!selection.entries || !selection.selected) {
-                std::cout << "  Skipped: no metadata selected\n";
-                if (selection.entries) cdrip_release_cddbentry_list(selection.entries);
+                std::lock_guard<std::mutex> guard(output_mutex);
+                for (const size_t index : files) {
+                    report_file(index, "Skipped: no metadata selected");
+                }
                 continue;
             }
 
-            ensure_entry_ready_for_toc(selection.selected, item.toc);
+            ensure_entry_ready_for_toc(selection.selected, first.toc);
 
             std::string cover_notice;
             CoverArtFetchSource cover_source{};
             if (!ensure_cover_art_merged(
                     selection.selected,
                     selection.selected_entries,
-                    item.toc,
+                    first.toc,
                     discogs_mode,
                     !auto_mode,
                     cover_source,
                     cover_notice,
-                    allow_aa)) {
+                    allow_aa,
+                    &cover_art_pool)) {
                 if (!cover_notice.empty()) {
+                    std::lock_guard<std::mutex> guard(output_mutex);
                     std::cerr << "  Cover art fetch notice: " << cover_notice << "\n";
                 }
             } else if (!cache_key.empty()) {
-                metadata_cache[cache_key] = EntryListPtr(
-                    clone_cddb_entry_list(selection.entries));
+                metadata_cache.store(cache_key, EntryListPtr(
+                    clone_cddb_entry_list(selection.entries)));
             }
 
-            const char* update_err = nullptr;
-            if (!cdrip_update_flac_with_cddb_entry(&item, selection.selected, &update_err)) {
-                std::cout << "  Failed: " << view_string(update_err) << "\n";
-                cdrip_release_error(update_err);
-            } else {
-                std::cout << "  Updated.\n";
-                ++updated;
-                ++updated_total;
+            // Tags are rewritten in the background while the next album is resolved. The cover
+            // file follows only once every tag write of the album succeeded.
+            album->pending = files.size();
+            for (const size_t index : files) {
+                album->paths.push_back(view_string(list->items[index].path));
             }
-            cdrip_release_cddbentry_list(selection.entries);
-            if (selection.merged) {
-                cdrip_release_cddbentry_list(selection.merged);
+            for (const size_t index : files) {
+                const CdRipTaggedToc* item = &list->items[index];
+                writer_pool.submit([&, album, item, index]() {
+                    const char* update_err = nullptr;
+                    const CdRipUpdateResults outcome = cdrip_update_flac_with_cddb_entry_ex(
+                        item, album->selection.selected, dry_run ? 1 : 0, &update_err);
+                    std::string result;
+                    switch (outcome) {
+                        case CDRIP_UPDATE_CHANGED:
+                            result = dry_run ? "Would update." : "Updated.";
+                            break;
+                        case CDRIP_UPDATE_UNCHANGED:
+                            result = "Unchanged.";
+                            break;
+                        default:
+                            result = "Failed: " + view_string(update_err);
+                            break;
+                    }
+                    cdrip_release_error(update_err);
+
+                    std::lock_guard<std::mutex> guard(output_mutex);
+                    report_file(index, result);
+                    if (outcome == CDRIP_UPDATE_CHANGED) ++updated;
+                    if (outcome == CDRIP_UPDATE_UNCHANGED) ++unchanged;
+                    if (outcome != CDRIP_UPDATE_CHANGED && outcome != CDRIP_UPDATE_UNCHANGED) album->failed = true;
+                    if (--album->pending == 0 && !album->failed && write_cover_file && !dry_run) {
+                        write_album_cover_files(album->selection.selected, album->paths, written_cover_paths);
+                    }
+                });
             }
         }
+        writer_pool.drain();
+
+        updated_total += updated;
+        unchanged_total += unchanged;
 
         cdrip_release_taggedtoc_list(list);
-        std::cout << "\nDone for target \"" << target_path << "\". Updated " << updated << " file(s).\n";
+        std::cout << "\nDone for target \"" << target_path << "\". "
+                  << (dry_run ? "Would update " : "Updated ") << updated << " file(s), "
+                  << unchanged << " unchanged.\n";
     }
 
-    std::cout << "\nAll targets done. Updated " << updated_total << " file(s) in total.\n";
+    std::cout << "\nAll targets done. " << (dry_run ? "Would update " : "Updated ") << updated_total
+              << " file(s) in total, " << unchanged_total << " unchanged.\n";
     return 0;
 }
 
+int run_replaygain_mode(
+    const std::vector<std::string>& target_paths,
+    bool force,
+    bool dry_run) {
+
+    struct ReplayGainAlbum {
+        std::vector<std::string> paths;
+        std::vector<int> track_numbers;
+    };
+
+    std::vector<ReplayGainAlbum> albums;
+    for (const auto& target_path : target_paths) {
+        const char* err = nullptr;
+        CdRipTaggedTocList* list = cdrip_collect_cddb_queries_from_path(target_path.c_str(), &err);
+        if (!list) {
+            std::cerr << "Failed to collect targets.\n";
+            return 1;
+        }
+        if (err) {
+            std::cerr << view_string(err) << "\n";
+            cdrip_release_error(err);
+        }
+
+        // Album gain is per disc; files without requery seed tags fall back to their directory.
+        std::unordered_map<std::string, size_t> album_index;
+        for (size_t i = 0; i < list->count; ++i) {
+            const auto& item = list->items[i];
+            const std::string path = view_string(item.path);
+            if (path.empty()) continue;
+            std::string key = (item.valid && item.toc) ? build_metadata_cache_key(item.toc) : std::string{};
+            if (key.empty()) key = "dir:" + resolve_album_location(path);
+            auto [it, inserted] = album_index.emplace(key, albums.size());
+            if (inserted) albums.emplace_back();
+            albums[it->second].paths.push_back(path);
+            albums[it->second].track_numbers.push_back(item.track_number);
+        }
+        cdrip_release_taggedtoc_list(list);
+    }
+    if (albums.empty()) {
+        std::cout << "No FLAC files found.\n";
+        return 0;
+    }
+    for (auto& album : albums) {
+        std::vector<size_t> order(album.paths.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&album](size_t lhs, size_t rhs) {
+            if (album.track_numbers[lhs] != album.track_numbers[rhs]) {
+                return album.track_numbers[lhs] < album.track_numbers[rhs];
+            }
+            return album.paths[lhs] < album.paths[rhs];
+        });
+        ReplayGainAlbum sorted;
+        for (const size_t i : order) {
+            sorted.paths.push_back(album.paths[i]);
+            sorted.track_numbers.push_back(album.track_numbers[i]);
+        }
+        album = std::move(sorted);
+    }
+
+    const size_t thread_count = decode_thread_count();
+    std::cout << "ReplayGain scan: " << albums.size() << " album(s) on " << thread_count << " thread(s).\n";
+
+    std::mutex output_mutex;
+    std::atomic<size_t> scanned{0};
+    std::atomic<size_t> skipped{0};
+    std::atomic<size_t> failed{0};
+    std::atomic<size_t> written{0};
+    {
+        // One album per job: album gain needs every track of the disc.
+        WorkerPool scan_pool{thread_count};
+        for (size_t ai = 0; ai < albums.size(); ++ai) {
+            scan_pool.submit([&, ai]() {
+                const auto& album = albums[ai];
+                std::ostringstream report;
+                report << "\n[Album " << (ai + 1) << "/" << albums.size() << "] " << album.paths.front();
+                if (album.paths.size() > 1) report << " (+" << (album.paths.size() - 1) << " file(s))";
+                report << "\n";
+
+                const bool tagged = !force && std::all_of(
+                    album.paths.begin(), album.paths.end(), &has_replaygain_tags);
+                std::vector<cdrip::detail::ReplayGainScanResult> tracks;
+                cdrip::detail::ReplayGainScanResult album_result;
+                std::string scan_err;
+                if (tagged) {
+                    report << "  Skipped: already has ReplayGain tags\n";
+                    ++skipped;
+                } else if (!cdrip::detail::scan_album_replaygain(album.paths, tracks, album_result, scan_err)) {
+                    report << "  Failed: " << scan_err << "\n";
+                    ++failed;
+                } else {
+                    ++scanned;
+                    const auto album_tags = cdrip::detail::build_replaygain_tags(
+                        cdrip::detail::ReplayGainScanResult{}, album_result);
+                    const auto album_gain = album_tags.find("REPLAYGAIN_ALBUM_GAIN");
+                    if (album_gain != album_tags.end()) {
+                        report << "  Album gain: " << album_gain->second << "\n";
+                    }
+                    for (size_t i = 0; i < album.paths.size(); ++i) {
+                        const auto tags = cdrip::detail::build_replaygain_tags(tracks[i], album_result);
+                        std::string write_err;
+                        bool changed = false;
+                        report << "  " << album.paths[i] << ": ";
+                        if (!cdrip::detail::update_flac_tags(
+                                album.paths[i], nullptr, 0, nullptr, tags,
+                                /*preserve_replaygain_tags=*/false, write_err, dry_run, &changed)) {
+                            report << "Failed: " << write_err << "\n";
+                            ++failed;
+                            continue;
+                        }
+                        const auto gain = tags.find("REPLAYGAIN_TRACK_GAIN");
+                        report << (gain != tags.end() ? gain->second : std::string{"-"}) << ", "
+                               << (changed ? (dry_run ? "would update" : "updated") : "unchanged") << "\n";
+                        if (changed) ++written;
+                    }
+                }
+
+                std::lock_guard<std::mutex> guard(output_mutex);
+                std::cout << report.str() << std::flush;
+            });
+        }
+        scan_pool.drain();
+    }
+
+    std::cout << "\nReplayGain scan done. " << scanned.load() << " album(s) scanned, "
+              << skipped.load() << " skipped, " << failed.load() << " failure(s); "
+              << (dry_run ? "would update " : "updated ") << written.load() << " file(s).\n";
+    return failed.load() == 0 ? 0 : 1;
+}
+
+int run_verify_mode(
+    const std::vector<std::string>& target_paths,
+    const std::string& report_path) {
+
+    std::vector<std::string> files;
+    std::unordered_set<std::string> seen;
+    for (const auto& target_path : target_paths) {
+        const char* err = nullptr;
+        CdRipTaggedTocList* list = cdrip_collect_cddb_queries_from_path(target_path.c_str(), &err);
+        if (!list) {
+            std::cerr << "Failed to collect targets.\n";
+            return 1;
+        }
+        if (err) {
+            std::cerr << view_string(err) << "\n";
+            cdrip_release_error(err);
+        }
+        for (size_t i = 0; i < list->count; ++i) {
+            const std::string path = view_string(list->items[i].path);
+            if (!path.empty() && seen.insert(path).second) files.push_back(path);
+        }
+        cdrip_release_taggedtoc_list(list);
+    }
+    std::sort(files.begin(), files.end());
+
+    std::ofstream report_file;
+    const bool report_to_file = !report_path.empty() && report_path != "-";
+    if (report_to_file) {
+        report_file.open(report_path, std::ios::trunc);
+        if (!report_file) {
+            std::cerr << "Failed to open verify report: " << report_path << "\n";
+            return 1;
+        }
+    }
+    std::ostream& report = report_to_file ? static_cast<std::ostream&>(report_file) : std::cout;
+
+    // Tab separated, one line per file in completion order; fields are escaped like the cache indexes.
+    report << "# cdrip-verify 1\n";
+    report << "# status\tmd5\tcrc\tpath\tdetail\n" << std::flush;
+
+    std::mutex report_mutex;
+    std::atomic<size_t> ok_count{0};
+    std::atomic<size_t> failed_count{0};
+    std::atomic<size_t> error_count{0};
+    {
+        WorkerPool verify_pool{decode_thread_count()};
+        for (const auto& path : files) {
+            verify_pool.submit([&, path]() {
+                std::map<std::string, std::string> tags;
+                cdrip::detail::read_flac_vorbis_tags(path, tags);
+                const auto expected = tags.find(cdrip::detail::kPcmCrc32TagKey);
+                const bool has_crc = expected != tags.end() && !expected->second.empty();
+
+                uint32_t crc = 0;
+                bool crc_supported = true;
+                std::vector<int16_t> pcm16;
+                const cdrip::detail::FlacPcmSink sink = [&](const FLAC__int32* samples, size_t frames, unsigned channels, unsigned bits_per_sample) {
+                    if (bits_per_sample != 16) {
+                        crc_supported = false;
+                        return true;
+                    }
+                    pcm16.resize(frames * channels);
+                    for (size_t i = 0; i < pcm16.size(); ++i) {
+                        pcm16[i] = static_cast<int16_t>(samples[i]);
+                    }
+                    crc = cdrip::detail::update_pcm_crc32(crc, pcm16.data(), pcm16.size());
+                    return true;
+                };
+
+                cdrip::detail::FlacDecodeResult decoded{};
+                std::string decode_err;
+                const bool decoded_ok = cdrip::detail::decode_flac_file(
+                    path, /*check_md5=*/true, has_crc ? sink : cdrip::detail::FlacPcmSink{}, decoded, decode_err);
+
+                std::string md5_status = "missing";
+                std::string crc_status = "missing";
+                std::string status = "OK";
+                std::string detail;
+                if (!decoded_ok) {
+                    md5_status = "-";
+                    crc_status = "-";
+                    status = "ERROR";
+                    detail = decode_err;
+                } else {
+                    if (decoded.md5_checked) md5_status = decoded.md5_ok ? "ok" : "mismatch";
+                    if (has_crc && !crc_supported) {
+                        crc_status = "unsupported";
+                    } else if (has_crc) {
+                        const std::string actual = cdrip::detail::format_pcm_crc32(crc);
+                        crc_status = (to_lower_ascii(actual) == to_lower_ascii(trim_ws(expected->second)))
+                            ? "ok"
+                            : "mismatch";
+                        if (crc_status == "mismatch") detail = "expected " + expected->second + ", got " + actual;
+                    }
+                    if (md5_status == "mismatch" || crc_status == "mismatch") status = "FAILED";
+                }
+                if (status == "OK") ++ok_count;
+                if (status == "FAILED") ++failed_count;
+                if (status == "ERROR") ++error_count;
+
+                std::lock_guard<std::mutex> guard(report_mutex);
+                report << status << "\t" << md5_status << "\t" << crc_status << "\t"
+                       << cdrip::detail::escape_index_field(path) << "\t"
+                       << cdrip::detail::escape_index_field(detail) << "\n" << std::flush;
+            });
+        }
+        verify_pool.drain();
+    }
+
+    report << "# summary\tok=" << ok_count.load() << "\tfailed=" << failed_count.load()
+           << "\terror=" << error_count.load() << "\n" << std::flush;
+    if (report_to_file) {
+        std::cout << "Verified " << files.size() << " file(s): " << ok_count.load() << " ok, "
+                  << failed_count.load() << " failed, " << error_count.load() << " error(s). Report: "
+                  << report_path << "\n";
+    }
+    return (failed_count.load() == 0 && error_count.load() == 0) ? 0 : 1;
+}
+
+int run_recompress_mode(
+    const std::vector<std::string>& target_paths,
+    int compression_level,
+    bool exhaustive_model_search,
+    bool dry_run) {
+
+    std::vector<std::string> files;
+    std::unordered_set<std::string> seen;
+    for (const auto& target_path : target_paths) {
+        const char* err = nullptr;
+        CdRipTaggedTocList* list = cdrip_collect_cddb_queries_from_path(target_path.c_str(), &err);
+        if (!list) {
+            std::cerr << "Failed to collect targets.\n";
+            return 1;
+        }
+        if (err) {
+            std::cerr << view_string(err) << "\n";
+            cdrip_release_error(err);
+        }
+        for (size_t i = 0; i < list->count; ++i) {
+            const std::string path = view_string(list->items[i].path);
+            if (!path.empty() && seen.insert(path).second) files.push_back(path);
+        }
+        cdrip_release_taggedtoc_list(list);
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+        std::cout << "No FLAC files found.\n";
+        return 0;
+    }
+    if (dry_run) {
+        std::cout << "Recompress (dry run): " << files.size() << " file(s) would be re-encoded at level "
+                  << compression_level << (exhaustive_model_search ? " with exhaustive model search" : "") << ".\n";
+        return 0;
+    }
+
+    // Lowest CPU priority before the workers start, so they only take idle cores.
+    errno = 0;
+    if (setpriority(PRIO_PROCESS, 0, 19) != 0 && errno != 0) {
+        std::cerr << "Warning: Failed to lower process priority: " << std::strerror(errno) << "\n";
+    }
+
+    const size_t thread_count = decode_thread_count();
+    std::cout << "Recompress: " << files.size() << " file(s) at level " << compression_level
+              << (exhaustive_model_search ? " (exhaustive)" : "") << " on " << thread_count << " thread(s).\n";
+
+    std::mutex output_mutex;
+    std::atomic<size_t> replaced{0};
+    std::atomic<size_t> kept{0};
+    std::atomic<size_t> changed{0};
+    std::atomic<size_t> failed{0};
+    std::atomic<uint64_t> saved_bytes{0};
+    {
+        WorkerPool recompress_pool{thread_count};
+        for (const auto& path : files) {
+            recompress_pool.submit([&, path]() {
+                cdrip::detail::FlacRecompressResult result{};
+                std::string recompress_err;
+                std::ostringstream report;
+                report << path << ": ";
+                if (!cdrip::detail::recompress_flac_file(
+                        path, compression_level, exhaustive_model_search, result, recompress_err)) {
+                    report << "Failed: " << recompress_err << "\n";
+                    ++failed;
+                } else if (result.changed) {
+                    report << "skipped (changed during recompression)\n";
+                    ++changed;
+                } else if (result.replaced) {
+                    const uint64_t saved = result.original_bytes - result.recompressed_bytes;
+                    report << result.original_bytes << " -> " << result.recompressed_bytes
+                           << " bytes (saved " << saved << ")\n";
+                    saved_bytes += saved;
+                    ++replaced;
+                } else {
+                    report << "kept (re-encoded size " << result.recompressed_bytes << " bytes is not smaller)\n";
+                    ++kept;
+                }
+                std::lock_guard<std::mutex> guard(output_mutex);
+                std::cout << report.str() << std::flush;
+            });
+        }
+        recompress_pool.drain();
+    }
+
+    std::cout << "\nRecompress done. " << replaced.load() << " file(s) replaced, " << kept.load()
+              << " kept, " << changed.load() << " changed meanwhile, " << failed.load() << " failure(s); saved "
+              << (saved_bytes.load() / 1024) << " KiB.\n";
+    return failed.load() == 0 ? 0 : 1;
+}
+
 int main(int argc, char** argv) {
     std::cout << "\nScheme CD music/sound ripper [" << display_version() << "]\n";
     std::cout << "Copyright (c) Kouji Matsui (@kekyo@mi.kekyo.net)\n";
@@ -2988,6 +4202,127 @@ int main(int argc, char** argv) {
     }
     if (cli_opts.speed_fast.has_value()) speed_fast = *cli_opts.speed_fast;
 
+    std::string threads_err;
+    int encoder_threads = 0;
+    if (cfg->config_path && cfg->config_path[0]) {
+        const std::string threads_value = get_config_string(cfg->config_path, "cdrip", "threads", "auto", threads_err);
+        if (!threads_err.empty()) {
+            std::cerr << "Failed to parse cdrip.threads from \"" << view_string(cfg->config_path) << "\": " << threads_err << "\n";
+            return 1;
+        }
+        if (!parse_encoder_threads(threads_value, encoder_threads)) {
+            std::cerr << "Invalid cdrip.threads in \"" << view_string(cfg->config_path) << "\": " << threads_value
+                      << " (expected: auto or > 0)\n";
+            return 1;
+        }
+    }
+    if (cli_opts.encoder_threads.has_value()) encoder_threads = *cli_opts.encoder_threads;
+
+    std::string read_offset_err;
+    int read_offset = 0;
+    std::string accuraterip_source;
+    if (cfg->config_path && cfg->config_path[0]) {
+        read_offset = get_config_int(cfg->config_path, "cdrip", "read_offset", 0, read_offset_err);
+        if (!read_offset_err.empty()) {
+            std::cerr << "Failed to parse cdrip.read_offset from \"" << view_string(cfg->config_path) << "\": " << read_offset_err << "\n";
+            return 1;
+        }
+        accuraterip_source = get_config_string(cfg->config_path, "cdrip", "accuraterip", "", read_offset_err);
+        if (!read_offset_err.empty()) {
+            std::cerr << "Failed to parse cdrip.accuraterip from \"" << view_string(cfg->config_path) << "\": " << read_offset_err << "\n";
+            return 1;
+        }
+    }
+    if (cli_opts.read_offset.has_value()) read_offset = *cli_opts.read_offset;
+    if (cli_opts.accuraterip.has_value()) accuraterip_source = *cli_opts.accuraterip;
+    cdrip_set_accuraterip_database(accuraterip_source.c_str());
+
+    std::string read_quality_err;
+    bool read_quality = false;
+    if (cfg->config_path && cfg->config_path[0]) {
+        read_quality = get_config_bool(cfg->config_path, "cdrip", "read_quality", /*default_value=*/false, read_quality_err);
+        if (!read_quality_err.empty()) {
+            std::cerr << "Failed to parse cdrip.read_quality from \"" << view_string(cfg->config_path) << "\": " << read_quality_err << "\n";
+            return 1;
+        }
+    }
+    if (cli_opts.read_quality.has_value()) read_quality = *cli_opts.read_quality;
+    CdRipDiagnosticObserver read_quality_observer{};
+    read_quality_observer.callback = &RipProgressSpinner::diagnostic_cb;
+
+    std::string read_budget_err;
+    int sector_budget = 0;
+    int track_budget = 0;
+    if (cfg->config_path && cfg->config_path[0]) {
+        sector_budget = get_config_int(cfg->config_path, "cdrip", "sector_budget", 0, read_budget_err);
+        if (read_budget_err.empty() && sector_budget < 0) read_budget_err = "expected: >= 0";
+        if (!read_budget_err.empty()) {
+            std::cerr << "Failed to parse cdrip.sector_budget from \"" << view_string(cfg->config_path) << "\": " << read_budget_err << "\n";
+            return 1;
+        }
+        track_budget = get_config_int(cfg->config_path, "cdrip", "track_budget", 0, read_budget_err);
+        if (read_budget_err.empty() && track_budget < 0) read_budget_err = "expected: >= 0";
+        if (!read_budget_err.empty()) {
+            std::cerr << "Failed to parse cdrip.track_budget from \"" << view_string(cfg->config_path) << "\": " << read_budget_err << "\n";
+            return 1;
+        }
+    }
+    if (cli_opts.sector_budget.has_value()) sector_budget = *cli_opts.sector_budget;
+    if (cli_opts.track_budget.has_value()) track_budget = *cli_opts.track_budget;
+
+    std::string sequential_err;
+    bool sequential = false;
+    if (cfg->config_path && cfg->config_path[0]) {
+        sequential = get_config_bool(cfg->config_path, "cdrip", "sequential", /*default_value=*/false, sequential_err);
+        if (!sequential_err.empty()) {
+            std::cerr << "Failed to parse cdrip.sequential from \"" << view_string(cfg->config_path) << "\": " << sequential_err << "\n";
+            return 1;
+        }
+    }
+    if (cli_opts.sequential.has_value()) sequential = *cli_opts.sequential;
+
+    std::string image_err;
+    bool disc_image = false;
+    if (cfg->config_path && cfg->config_path[0]) {
+        disc_image = get_config_bool(cfg->config_path, "cdrip", "image", /*default_value=*/false, image_err);
+        if (!image_err.empty()) {
+            std::cerr << "Failed to parse cdrip.image from \"" << view_string(cfg->config_path) << "\": " << image_err << "\n";
+            return 1;
+        }
+    }
+    if (cli_opts.image.has_value()) disc_image = *cli_opts.image;
+    if (disc_image && rip_mode == RIP_MODES_SALVAGE) {
+        std::cerr << "Error: disc image output is not available in salvage mode\n";
+        return 1;
+    }
+
+    std::string outputs_err;
+    std::vector<cdrip::detail::OutputSinkConfig> outputs;
+    if (cli_opts.outputs.empty() && cfg->config_path && cfg->config_path[0]) {
+        const std::string raw_outputs = get_config_string(cfg->config_path, "cdrip", "outputs", "", outputs_err);
+        if (outputs_err.empty()) parse_output_specs(raw_outputs, outputs, outputs_err);
+        if (!outputs_err.empty()) {
+            std::cerr << "Failed to parse cdrip.outputs from \"" << view_string(cfg->config_path) << "\": " << outputs_err << "\n";
+            return 1;
+        }
+    }
+    for (const auto& spec : cli_opts.outputs) {
+        if (!parse_output_specs(spec, outputs, outputs_err)) {
+            std::cerr << "Error: -o/--output " << outputs_err << "\n";
+            return 1;
+        }
+    }
+    auto apply_outputs = [&](CdRip* handle) {
+        cdrip_clear_outputs(handle);
+        for (const auto& output : outputs) {
+            const char* output_err = nullptr;
+            if (!cdrip_add_output(handle, output.kind, output.format.c_str(), output.compression_level, &output_err)) {
+                std::cerr << "Output error: " << view_string(output_err) << "\n";
+            }
+            cdrip_release_error(output_err);
+        }
+    };
+
     std::string replaygain_err;
     bool replaygain = true;
     if (cfg->config_path && cfg->config_path[0]) {
@@ -3047,17 +4382,143 @@ int main(int argc, char** argv) {
         }
     }
 
+    std::string cover_cache_err;
+    bool cover_cache = true;
+    int cover_cache_mb = kDefaultCoverArtCacheMegabytes;
+    if (cfg->config_path && cfg->config_path[0]) {
+        cover_cache = get_config_bool(cfg->config_path, "cdrip", "cover_cache", /*default_value=*/true, cover_cache_err);
+        if (cover_cache_err.empty()) {
+            cover_cache_mb = get_config_int(
+                cfg->config_path,
+                "cdrip",
+                "cover_cache_mb",
+                kDefaultCoverArtCacheMegabytes,
+                cover_cache_err);
+        }
+        if (!cover_cache_err.empty()) {
+            std::cerr << "Failed to parse cdrip.cover_cache from \""
+                      << view_string(cfg->config_path) << "\": " << cover_cache_err << "\n";
+            return 1;
+        }
+        if (cover_cache_mb <= 0) {
+            std::cerr << "Invalid cdrip.cover_cache_mb in \""
+                      << view_string(cfg->config_path) << "\": "
+                      << cover_cache_mb << " (expected: > 0)\n";
+            return 1;
+        }
+    }
+
+    std::string cover_file_err;
+    std::string cover_file_value = "embed";
+    if (cfg->config_path && cfg->config_path[0]) {
+        cover_file_value = get_config_string(cfg->config_path, "cdrip", "cover_file", "embed", cover_file_err);
+        if (!cover_file_err.empty()) {
+            std::cerr << "Failed to parse cdrip.cover_file from \"" << view_string(cfg->config_path) << "\": " << cover_file_err << "\n";
+            return 1;
+        }
+    }
+    if (cli_opts.cover_file.has_value()) cover_file_value = *cli_opts.cover_file;
+
+    CoverFileMode cover_file_mode = CoverFileMode::Embed;
+    if (!parse_cover_file_mode(cover_file_value, cover_file_mode)) {
+        const bool from_cli = cli_opts.cover_file.has_value();
+        std::cerr << "Invalid " << (from_cli ? "-cf/--cover-file" : "cdrip.cover_file")
+                  << " value: " << cover_file_value << " (expected: embed|file|thumbnail)\n";
+        return 1;
+    }
+    const bool write_cover_file = cover_file_mode != CoverFileMode::Embed;
+
+    std::string scan_index_err;
+    bool scan_index = true;
+    if (cfg->config_path && cfg->config_path[0]) {
+        scan_index = get_config_bool(cfg->config_path, "cdrip", "scan_index", /*default_value=*/true, scan_index_err);
+        if (!scan_index_err.empty()) {
+            std::cerr << "Failed to parse cdrip.scan_index from \"" << view_string(cfg->config_path) << "\": " << scan_index_err << "\n";
+            return 1;
+        }
+    }
+    if (scan_index) {
+        const std::filesystem::path scan_index_path =
+            std::filesystem::path(g_get_user_cache_dir()) / "cdrip" / "scan_index";
+        cdrip_set_scan_index(scan_index_path.string().c_str());
+    }
+
+    std::string archive_index_err;
+    bool archive_index = true;
+    if (cfg->config_path && cfg->config_path[0]) {
+        archive_index = get_config_bool(cfg->config_path, "cdrip", "archive_index", /*default_value=*/true, archive_index_err);
+        if (!archive_index_err.empty()) {
+            std::cerr << "Failed to parse cdrip.archive_index from \"" << view_string(cfg->config_path) << "\": " << archive_index_err << "\n";
+            return 1;
+        }
+    }
+    if (archive_index) {
+        const std::filesystem::path archive_index_path =
+            std::filesystem::path(g_get_user_cache_dir()) / "cdrip" / "archive_index";
+        cdrip_set_archive_index(archive_index_path.string().c_str());
+    }
+
+    std::string duplicate_err;
+    std::string duplicate_value = "warn";
+    if (cfg->config_path && cfg->config_path[0]) {
+        duplicate_value = get_config_string(cfg->config_path, "cdrip", "duplicate", "warn", duplicate_err);
+        if (!duplicate_err.empty()) {
+            std::cerr << "Failed to parse cdrip.duplicate from \"" << view_string(cfg->config_path) << "\": " << duplicate_err << "\n";
+            return 1;
+        }
+    }
+    if (cli_opts.duplicate.has_value()) duplicate_value = *cli_opts.duplicate;
+
+    DuplicateMode duplicate_mode = DuplicateMode::Warn;
+    if (!parse_duplicate_mode(duplicate_value, duplicate_mode)) {
+        const bool from_cli = cli_opts.duplicate.has_value();
+        std::cerr << "Invalid " << (from_cli ? "-dp/--duplicate" : "cdrip.duplicate")
+                  << " value: " << duplicate_value << " (expected: rip|warn|skip|eject)\n";
+        return 1;
+    }
+
     cdrip_set_cover_art_max_width(max_width);
+    cdrip_set_cover_art_embed_mode(cover_art_embed_mode_for(cover_file_mode));
+    if (cover_cache) {
+        const std::filesystem::path cover_cache_dir =
+            std::filesystem::path(g_get_user_cache_dir()) / "cdrip" / "cover_art";
+        cdrip_set_cover_art_cache(
+            cover_cache_dir.string().c_str(),
+            static_cast<long long>(cover_cache_mb) * 1024 * 1024);
+    }
+
+    if (!cli_opts.recompress_paths.empty()) {
+        return run_recompress_mode(cli_opts.recompress_paths, cli_opts.recompress_level.value_or(8),
+                                   cli_opts.recompress_exhaustive, cli_opts.dry_run);
+    }
+    if (!cli_opts.verify_paths.empty()) {
+        return run_verify_mode(cli_opts.verify_paths, cli_opts.verify_report);
+    }
+    if (!cli_opts.replaygain_paths.empty()) {
+        return run_replaygain_mode(cli_opts.replaygain_paths, cli_opts.replaygain_force, cli_opts.dry_run);
+    }
 
     if (!cli_opts.update_paths.empty()) {
         // Ignore other options when update mode is specified.
         return run_update_mode(cli_opts.update_paths, servers_from_config, cfg->sort, auto_mode,
                                allow_recrawl, recrawl_track_length_tolerance_percent, log_recrawl,
-                               discogs_mode, allow_aa, title_filter.get());
+                               discogs_mode, allow_aa, write_cover_file, cli_opts.dry_run,
+                               title_filter.get());
     }
 
     const char* err = nullptr;
-    if (auto_mode) {
+    // A disc image is always "inserted"; there is no drive to detect or wait for.
+    const bool image_device = cdrip::detail::is_image_device(device);
+    if (image_device) {
+        std::cout << "\nUsing disc image: " << device.substr(std::strlen(cdrip::detail::kImageDevicePrefix)) << "\n";
+        // An image holds audio already read from a drive; the configured drive offset does not
+        // apply to it, only an offset given on the command line.
+        if (!cli_opts.read_offset.has_value() && read_offset != 0) {
+            std::cout << "Ignoring cdrip.read_offset " << std::showpos << read_offset << std::noshowpos
+                      << " for the disc image (use -ro to apply an offset)\n";
+            read_offset = 0;
+        }
+    } else if (auto_mode) {
         std::string wait_message;
         if (!device.empty()) {
             wait_message = "Waiting for media in " + device + " (auto mode)...";
@@ -3171,7 +4632,7 @@ int main(int argc, char** argv) {
     }
 
     err = nullptr;
-    CdRipSettings settings{format.c_str(), compression_level, rip_mode, speed_fast};
+    CdRipSettings settings{format.c_str(), compression_level, rip_mode, speed_fast, encoder_threads, read_offset};
     auto drive = cdrip_open(device.c_str(), &settings, &err);
     if (!drive) {
         std::string err_msg = view_string(err);
@@ -3180,6 +4641,10 @@ int main(int argc, char** argv) {
         std::cerr << (err_msg.empty() ? "Could not open drive" : err_msg) << "\n";
         return 1;
     }
+    cdrip_set_read_telemetry(drive, read_quality, &read_quality_observer);
+    cdrip_set_read_budget(drive, sector_budget, track_budget, &read_quality_observer);
+    cdrip_set_sequential_read(drive, sequential);
+    apply_outputs(drive);
 
     std::cout << "\nOptions:\n";
     std::string config_source = cfg->config_path ? view_string(cfg->config_path) : std::string{"(defaults)"};
@@ -3191,7 +4656,11 @@ int main(int argc, char** argv) {
         ? compression_level
         : (effective_mode == RIP_MODES_FAST ? 1 : 5);
     std::cout << "  compression : " << resolved_compression;
-    if (compression_level < 0) std::cout << " (auto)";
+    if (compression_level == CDRIP_COMPRESSION_ADAPTIVE) {
+        std::cout << " (adaptive, adjusted between tracks)";
+    } else if (compression_level < 0) {
+        std::cout << " (auto)";
+    }
     std::cout << "\n";
     std::cout << "  mode        : ";
     switch (rip_mode) {
@@ -3201,18 +4670,111 @@ int main(int argc, char** argv) {
         case RIP_MODES_BEST:
             std::cout << "best (full integrity checks)";
             break;
+        case RIP_MODES_VERIFY:
+            std::cout << "verify (read twice, full checks only where reads differ)";
+            break;
+        case RIP_MODES_HYBRID:
+            std::cout << "hybrid (overlap checks, full checks around read errors)";
+            break;
+        case RIP_MODES_SALVAGE:
+            std::cout << "salvage (whole disc fast first, damaged ranges retried last)";
+            break;
         default:
             std::cout << "default (best - full integrity checks)";
             break;
     }
     std::cout << "\n";
     std::cout << "  speed       : " << (speed_fast ? "fast (max)" : "slow (1x)") << "\n";
+    const unsigned resolved_threads = cdrip::detail::resolve_encoder_threads(encoder_threads, speed_fast);
+    std::cout << "  read offset : " << std::showpos << read_offset << std::noshowpos << " samples\n";
+    std::cout << "  accuraterip : " << (accuraterip_source.empty() ? std::string{"checksums only (no database)"} : "\"" + accuraterip_source + "\"") << "\n";
+    std::cout << "  read quality: " << (read_quality ? "enabled (tags and read_report.json)" : "disabled") << "\n";
+    std::cout << "  sequential  : " << (sequential ? "enabled (adjacent tracks without seeking)" : "disabled") << "\n";
+    std::cout << "  output      : " << (disc_image ? "disc image (one FLAC with CUESHEET)" : "one FLAC per track") << "\n";
+    for (const auto& output : outputs) {
+        std::cout << "  extra output: " << output_kind_name(output.kind);
+        if (output.kind == CDRIP_OUTPUT_FLAC) std::cout << " (level " << output.compression_level << ")";
+        std::cout << " \"" << output.format << "\"\n";
+    }
+    std::cout << "  read budget : ";
+    if (sector_budget <= 0 && track_budget <= 0) {
+        std::cout << "unlimited";
+    } else {
+        std::cout << "sector " << (sector_budget > 0 ? std::to_string(sector_budget) + " s" : std::string{"unlimited"})
+                  << ", track " << (track_budget > 0 ? std::to_string(track_budget) + " s" : std::string{"unlimited"});
+    }
+    std::cout << "\n";
+    std::cout << "  threads     : " << resolved_threads;
+    if (encoder_threads > 1 && resolved_threads == 1) {
+        std::cout << " (libFLAC without multithreading)";
+    } else if (encoder_threads <= 0) {
+        std::cout << " (auto)";
+    }
+    std::cout << "\n";
     std::cout << "  replaygain  : " << (replaygain ? "enabled (save after full album rip)" : "disabled (save each track immediately)") << "\n";
+    std::cout << "  duplicate   : " << duplicate_mode_label(duplicate_mode) << "\n";
     std::cout << "  auto        : " << (auto_mode ? "enabled" : "disabled");
     std::cout << "\n\n";
 
     CdRipProgressCallback progress = &RipProgressSpinner::progress_cb;
 
+    // Closes the drive and waits for the next disc; returns an exit code when ripping ends.
+    auto next_disc = [&](bool success, bool eject_disc) -> std::optional<int> {
+        const char* close_err = nullptr;
+        cdrip_close(drive, eject_disc, &close_err);
+        drive = nullptr;
+        if (close_err) {
+            std::cerr << view_string(close_err) << "\n";
+            cdrip_release_error(close_err);
+        }
+
+        if (!repeat || image_device) return success ? 0 : 1;
+
+        if (!auto_mode) {
+            if (!eject_disc) {
+                const std::string removal_message =
+                    "\nRemove disc from " + device + " (or type 'q' to quit)...";
+                auto removed = wait_for_device_media_state(device, false, removal_message, true);
+                if (removed == MediaWaitResult::Quit) return success ? 0 : 1;
+                if (removed == MediaWaitResult::Error) return 1;
+            }
+
+            const std::string insert_message =
+                "\nInsert next disc into " + device + " (or type 'q' to quit)...";
+            auto inserted = wait_for_device_media_state(device, true, insert_message, true);
+            if (inserted == MediaWaitResult::Quit) return success ? 0 : 1;
+            if (inserted == MediaWaitResult::Error) return 1;
+        } else {
+            if (!eject_disc) {
+                std::string removal_message = "Waiting for disc removal from " + device + " (auto mode)...";
+                if (!wait_for_media_removal(device, removal_message)) {
+                    return 1;
+                }
+            }
+            std::string wait_message = "Waiting for next disc in " + device + " (auto mode)...";
+            auto next_device = wait_for_media(device, false, wait_message);
+            if (!next_device) return 1;
+            device = *next_device;
+        }
+
+        err = nullptr;
+        drive = cdrip_open(device.c_str(), &settings, &err);
+        if (!drive) {
+            std::cerr << "Could not reopen drive " << device << ": " << view_string(err) << "\n";
+            cdrip_release_error(err);
+            err = nullptr;
+            device.clear();
+            return 1;
+        }
+        cdrip_release_error(err);
+        err = nullptr;
+        cdrip_set_read_telemetry(drive, read_quality, &read_quality_observer);
+        cdrip_set_read_budget(drive, sector_budget, track_budget, &read_quality_observer);
+        cdrip_set_sequential_read(drive, sequential);
+        apply_outputs(drive);
+        return std::nullopt;
+    };
+
     while (true) {
         if (!drive) {
             std::cerr << "Drive not available\n";
@@ -3234,12 +4796,30 @@ int main(int argc, char** argv) {
         }
         cdrip_release_error(toc_err);
 
+        if (duplicate_mode != DuplicateMode::Rip) {
+            const char* archived = cdrip_find_archived_disc(toc);
+            if (archived) {
+                std::cout << "\nThis disc is already archived: " << view_string(archived) << "\n";
+                cdrip_release_archived_location(archived);
+                if (duplicate_mode == DuplicateMode::Skip || duplicate_mode == DuplicateMode::Eject) {
+                    const bool eject_disc = eject_after || duplicate_mode == DuplicateMode::Eject;
+                    std::cout << (eject_disc
+                        ? "Skipped, will eject CD from the drive...\n"
+                        : "Skipped, keeping CD in the drive (no-eject).\n");
+                    cdrip_release_disctoc(toc);
+                    if (const auto exit_code = next_disc(true, eject_disc)) return *exit_code;
+                    continue;
+                }
+            }
+        }
+
         CdRipCddbServerList* servers = servers_from_config;
 
+        CoverArtFetchPool cover_art_pool{discogs_mode};
         auto selection = select_cddb_entry_for_toc(
             toc, servers, sort, std::string{}, auto_mode, /*allow_fallback=*/true,
             allow_recrawl, recrawl_track_length_tolerance_percent, log_recrawl,
-            /*metadata_cache=*/nullptr, title_filter.get());
+            /*metadata_cache=*/nullptr, title_filter.get(), &cover_art_pool);
         const bool ignore_meta = (selection.selected == nullptr);
         if (!selection.entries) {
             std::cerr << "Failed to obtain CDDB entries\n";
@@ -3275,7 +4855,8 @@ int main(int argc, char** argv) {
                 !auto_mode && !repeat,
                 cover_source,
                 cover_notice,
-                allow_aa)) {
+                allow_aa,
+                &cover_art_pool)) {
             if (meta->cover_art.data && meta->cover_art.size > 0 && cover_source != CoverArtFetchSource::None) {
                 std::cout << "\nCover art fetched from " << cover_art_source_label(cover_source) << ".\n";
             }
@@ -3299,8 +4880,29 @@ int main(int argc, char** argv) {
         }
 
         bool success = true;
+        // A disc image is ripped as one track spanning every audio track.
+        CdRipTrackInfo image_track{};
+        if (disc_image) {
+            std::string image_track_err;
+            if (cdrip::detail::build_disc_image_track(toc, image_track, image_track_err)) {
+                audio_tracks.assign(1, &image_track);
+                track_secs.assign(1, total_album_sec);
+            } else {
+                std::cerr << "Rip error: " << image_track_err << "\n";
+                success = false;
+            }
+        }
         double completed_before = 0.0;
         int total_tracks = static_cast<int>(audio_tracks.size());
+        auto output_tags = [&](const CdRipTrackInfo* track,
+                               std::string& title,
+                               std::string& track_name,
+                               std::string& safe_title) {
+            return disc_image
+                ? cdrip::detail::build_disc_image_vorbis_tags(meta, toc, title, track_name, safe_title)
+                : cdrip::detail::build_track_vorbis_tags(
+                    track, meta, toc, total_tracks, title, track_name, safe_title);
+        };
         std::vector<AlbumTrackStage> staged_tracks;
         std::string staged_album_dir;
         using Ebur128Ptr = std::unique_ptr<ebur128_state, decltype(&destroy_ebur128_state)>;
@@ -3324,6 +4926,16 @@ int main(int argc, char** argv) {
                 std::chrono::steady_clock::now().time_since_epoch())
                 .count() /
             1000.0;
+        if (success && rip_mode == RIP_MODES_SALVAGE) {
+            // Read the whole disc up front; the tracks below are then encoded from the spool.
+            std::cout << "Salvage reading the whole disc...\n";
+            const char* salvage_err = nullptr;
+            if (!cdrip_salvage_disc(drive, toc, &read_quality_observer, progress, &salvage_err)) {
+                success = false;
+                std::cerr << "Rip error: " << view_string(salvage_err) << "\n";
+            }
+            cdrip_release_error(salvage_err);
+        }
         if (success) {
             for (size_t idx = 0; idx < audio_tracks.size(); ++idx) {
                 const auto* track = audio_tracks[idx];
@@ -3332,14 +4944,7 @@ int main(int argc, char** argv) {
                     std::string track_name;
                     std::string safe_title;
                     std::string final_path;
-                    const auto tags = cdrip::detail::build_track_vorbis_tags(
-                        track,
-                        meta,
-                        toc,
-                        total_tracks,
-                        title,
-                        track_name,
-                        safe_title);
+                    const auto tags = output_tags(track, title, track_name, safe_title);
                     std::string resolve_err;
                     if (!cdrip::detail::resolve_track_output_path(format, tags, final_path, resolve_err)) {
                         success = false;
@@ -3367,6 +4972,7 @@ int main(int argc, char** argv) {
                     write_options.display_path = final_path.c_str();
                     write_options.track_replaygain_state = track_replaygain_state.get();
                     write_options.album_replaygain_state = album_replaygain_state.get();
+                    write_options.disc_image = disc_image;
 
                     cdrip::detail::ReplayGainScanResult track_replaygain;
                     std::string rip_err;
@@ -3402,7 +5008,10 @@ int main(int argc, char** argv) {
                     const char* rip_err = nullptr;
                     RipProgressSpinner rip_spinner{};
                     rip_spinner.activate();
-                    if (!cdrip_rip_track(drive, track, meta, toc, progress, &rip_err, total_tracks, completed_before, total_album_sec, wall_start)) {
+                    const bool ripped = disc_image
+                        ? cdrip_rip_disc_image(drive, meta, toc, progress, &rip_err, wall_start)
+                        : cdrip_rip_track(drive, track, meta, toc, progress, &rip_err, total_tracks, completed_before, total_album_sec, wall_start);
+                    if (!ripped) {
                         rip_spinner.finish(false);
                         success = false;
                         if (rip_err) {
@@ -3431,11 +5040,12 @@ int main(int argc, char** argv) {
                 for (const auto& staged_track : staged_tracks) {
                     const auto replaygain_tags =
                         cdrip::detail::build_replaygain_tags(staged_track.replaygain, album_replaygain);
+                    // An image keeps its own tags; only ReplayGain is merged in.
                     if (!cdrip::detail::update_flac_tags(
                             staged_track.staged_path,
                             toc,
                             staged_track.track_number,
-                            meta,
+                            disc_image ? nullptr : meta,
                             replaygain_tags,
                             /*preserve_replaygain_tags=*/false,
                             replaygain_err)) {
@@ -3461,6 +5071,40 @@ int main(int argc, char** argv) {
         }
 
         if (success) {
+            std::vector<std::string> track_paths;
+            for (const auto* track : audio_tracks) {
+                std::string title;
+                std::string track_name;
+                std::string safe_title;
+                std::string final_path;
+                std::string resolve_err;
+                const auto tags = output_tags(track, title, track_name, safe_title);
+                if (cdrip::detail::resolve_track_output_path(format, tags, final_path, resolve_err)) {
+                    track_paths.push_back(final_path);
+                }
+            }
+            if (write_cover_file) {
+                std::unordered_set<std::string> written_cover_paths;
+                write_album_cover_files(meta, track_paths, written_cover_paths);
+            }
+            if (!track_paths.empty()) {
+                register_archived_album(toc, track_paths.front());
+            }
+            if (read_quality && !track_paths.empty()) {
+                const std::string report_path = cdrip::detail::resolve_read_report_path(track_paths.front());
+                const char* report_err = nullptr;
+                if (cdrip_write_read_report(drive, toc, report_path.c_str(), &report_err)) {
+                    std::cout << "Read report written: " << report_path << "\n";
+                } else {
+                    std::cerr << "Read report error: " << view_string(report_err) << "\n";
+                }
+                cdrip_release_error(report_err);
+            }
+        }
+
+        if (image_device) {
+            std::cout << (success ? "\nDone.\n" : "\nAborted with errors.\n");
+        } else if (success) {
             if (eject_after) {
                 std::cout << "\nDone, will eject CD from the drive...\n";
             } else {
@@ -3497,7 +5141,7 @@ int main(int argc, char** argv) {
             }
             delete[] fallback_meta->album_tags;
             if (fallback_meta->cover_art.data) {
-                delete[] fallback_meta->cover_art.data;
+                cdrip::detail::release_cover_art_data(fallback_meta->cover_art.data);
             }
             delete[] fallback_meta->cover_art.mime_type;
             delete[] fallback_meta->cddb_discid;
@@ -3508,53 +5152,6 @@ int main(int argc, char** argv) {
         }
         cdrip_release_disctoc(toc);
 
-        const char* close_err = nullptr;
-        cdrip_close(drive, eject_after, &close_err);
-        drive = nullptr;
-        if (close_err) {
-            std::cerr << view_string(close_err) << "\n";
-            cdrip_release_error(close_err);
-        }
-
-        if (!repeat) return success ? 0 : 1;
-
-        if (!auto_mode) {
-            if (!eject_after) {
-                const std::string removal_message =
-                    "\nRemove disc from " + device + " (or type 'q' to quit)...";
-                auto removed = wait_for_device_media_state(device, false, removal_message, true);
-                if (removed == MediaWaitResult::Quit) return success ? 0 : 1;
-                if (removed == MediaWaitResult::Error) return 1;
-            }
-
-            const std::string insert_message =
-                "\nInsert next disc into " + device + " (or type 'q' to quit)...";
-            auto inserted = wait_for_device_media_state(device, true, insert_message, true);
-            if (inserted == MediaWaitResult::Quit) return success ? 0 : 1;
-            if (inserted == MediaWaitResult::Error) return 1;
-        } else {
-            if (!eject_after) {
-                std::string removal_message = "Waiting for disc removal from " + device + " (auto mode)...";
-                if (!wait_for_media_removal(device, removal_message)) {
-                    return 1;
-                }
-            }
-            std::string wait_message = "Waiting for next disc in " + device + " (auto mode)...";
-            auto next_device = wait_for_media(device, false, wait_message);
-            if (!next_device) return 1;
-            device = *next_device;
-        }
-
-        err = nullptr;
-        drive = cdrip_open(device.c_str(), &settings, &err);
-        if (!drive) {
-            std::cerr << "Could not reopen drive " << device << ": " << view_string(err) << "\n";
-            cdrip_release_error(err);
-            err = nullptr;
-            device.clear();
-            return 1;
-        }
-        cdrip_release_error(err);
-        err = nullptr;
+        if (const auto exit_code = next_disc(success, eject_after)) return *exit_code;
     }
 }
@@ -0,0 +1,155 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <glib.h>
+
+#include "../src/cdrip/internal.h"
+
+using cdrip::detail::build_archive_keys;
+
+namespace {
+
+auto expect_true = [](
+    bool condition,
+    const std::string& message) {
+
+    if (!condition) {
+        std::cerr << "assert_true failed: " << message << "\n";
+        std::exit(1);
+    }
+};
+
+auto expect_eq = [](
+    const std::string& expected,
+    const std::string& actual,
+    const std::string& message) {
+
+    if (expected != actual) {
+        std::cerr << "assert_eq failed: " << message << "\n";
+        std::cerr << "  expected: " << expected << "\n";
+        std::cerr << "  actual:   " << actual << "\n";
+        std::exit(1);
+    }
+};
+
+struct TestToc {
+    CdRipTrackInfo tracks[2]{};
+    CdRipDiscToc toc{};
+
+    TestToc(const char* cddb_discid, const char* mb_discid) {
+        tracks[0].number = 1;
+        tracks[0].start = 150;
+        tracks[1].number = 2;
+        tracks[1].start = 20000;
+        toc.cddb_discid = cddb_discid;
+        toc.mb_discid = mb_discid;
+        toc.tracks = tracks;
+        toc.tracks_count = 2;
+    }
+};
+
+auto find_location = [](const CdRipDiscToc* toc) {
+    const char* found = cdrip_find_archived_disc(toc);
+    const std::string location = found ? std::string{found} : std::string{};
+    cdrip_release_archived_location(found);
+    return location;
+};
+
+auto test_keys_ignore_discid_case = []() {
+    TestToc upper{"A50AB10C", "mbid-1"};
+    TestToc lower{"a50ab10c", nullptr};
+    const auto upper_keys = build_archive_keys(&upper.toc);
+    const auto lower_keys = build_archive_keys(&lower.toc);
+    expect_true(upper_keys.size() == 2, "both identifiers should yield keys");
+    expect_eq("mb:mbid-1", upper_keys[0], "MusicBrainz key should come first");
+    expect_true(lower_keys.size() == 1, "missing MusicBrainz id should be skipped");
+    expect_eq(upper_keys[1], lower_keys[0], "CDDB key should not depend on case");
+    expect_true(build_archive_keys(nullptr).empty(), "null TOC should yield no keys");
+};
+
+auto test_register_and_find = [](const std::filesystem::path& dir) {
+    const std::string index_path = (dir / "nested" / "archive_index").string();
+    const auto album = dir / "Album\tOne";
+    std::filesystem::create_directories(album);
+
+    cdrip_set_archive_index(index_path.c_str());
+    TestToc disc{"a50ab10c", "mbid-1"};
+    expect_eq("", find_location(&disc.toc), "empty index should not match");
+
+    const char* err = nullptr;
+    expect_true(cdrip_register_archived_disc(&disc.toc, album.string().c_str(), &err) != 0,
+        "disc should be registered");
+    cdrip_release_error(err);
+    expect_eq(album.string(), find_location(&disc.toc), "registered disc should be found");
+
+    // Reload from disk; a TOC rebuilt from tags may lack the MusicBrainz id.
+    cdrip_set_archive_index(index_path.c_str());
+    TestToc from_tags{"A50AB10C", nullptr};
+    expect_eq(album.string(), find_location(&from_tags.toc), "index should survive a reload");
+
+    TestToc other{"b50ab10c", nullptr};
+    expect_eq("", find_location(&other.toc), "other disc should not match");
+
+    std::filesystem::remove_all(album);
+    expect_eq("", find_location(&disc.toc), "removed album should not match");
+    cdrip_set_archive_index(nullptr);
+};
+
+auto test_relative_locations_are_stored_absolute = [](const std::filesystem::path& dir) {
+    const std::string index_path = (dir / "relative_index").string();
+    const auto album = dir / "Artist" / "Album";
+    std::filesystem::create_directories(album);
+    const auto previous = std::filesystem::current_path();
+    cdrip_set_archive_index(index_path.c_str());
+    TestToc disc{"c50ab10c", "mbid-3"};
+
+    std::filesystem::current_path(dir);
+    const char* err = nullptr;
+    expect_true(cdrip_register_archived_disc(&disc.toc, "Artist/./Album/", &err) != 0,
+        "relative location should be registered");
+    cdrip_release_error(err);
+
+    // Found from another working directory, under its absolute path.
+    std::filesystem::current_path(album);
+    cdrip_set_archive_index(index_path.c_str());
+    expect_eq(album.string(), find_location(&disc.toc), "relative location should be stored absolute");
+    std::filesystem::current_path(previous);
+
+    // Relative lines written by older versions are not trusted.
+    TestToc legacy{"d50ab10c", nullptr};
+    std::ofstream(index_path, std::ios::app) << build_archive_keys(&legacy.toc)[0] << "\t.\n";
+    cdrip_set_archive_index(index_path.c_str());
+    expect_eq("", find_location(&legacy.toc), "relative index lines should not match");
+    cdrip_set_archive_index(nullptr);
+};
+
+auto test_disabled_index_is_noop = [](const std::filesystem::path& dir) {
+    cdrip_set_archive_index(nullptr);
+    TestToc disc{"a50ab10c", "mbid-1"};
+    const char* err = nullptr;
+    expect_true(cdrip_register_archived_disc(&disc.toc, dir.string().c_str(), &err) != 0,
+        "registering without an index should succeed");
+    cdrip_release_error(err);
+    expect_eq("", find_location(&disc.toc), "disabled index should not match");
+};
+
+}  // namespace
+
+int main() {
+    gchar* tmp = g_dir_make_tmp("cdrip-archive-index-XXXXXX", nullptr);
+    expect_true(tmp != nullptr, "temp directory should be created");
+    const std::filesystem::path root(tmp);
+    g_free(tmp);
+
+    test_keys_ignore_discid_case();
+    test_register_and_find(root);
+    test_relative_locations_are_stored_absolute(root);
+    test_disabled_index_is_noop(root);
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+#include "../src/cdrip/internal.h"
+
+using cdrip::detail::load_cached_cover_art;
+using cdrip::detail::store_cached_cover_art;
+
+namespace {
+
+auto expect_true = [](
+    bool condition,
+    const std::string& message) {
+
+    if (!condition) {
+        std::cerr << "assert_true failed: " << message << "\n";
+        std::exit(1);
+    }
+};
+
+auto expect_size = [](
+    size_t expected,
+    size_t actual,
+    const std::string& message) {
+
+    if (expected != actual) {
+        std::cerr << "assert_size failed: " << message << "\n";
+        std::cerr << "  expected: " << expected << "\n";
+        std::cerr << "  actual:   " << actual << "\n";
+        std::exit(1);
+    }
+};
+
+std::vector<uint8_t> make_fake_png(
+    size_t size,
+    uint8_t fill) {
+
+    std::vector<uint8_t> png(size, fill);
+    const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    std::copy(std::begin(signature), std::end(signature), png.begin());
+    return png;
+}
+
+size_t count_cached_images(
+    const std::filesystem::path& dir) {
+
+    size_t count = 0;
+    for (const auto& item : std::filesystem::directory_iterator(dir)) {
+        if (item.path().extension() == ".png") ++count;
+    }
+    return count;
+}
+
+auto test_cache_round_trip_is_keyed_by_source_id_and_width = [](const std::filesystem::path& dir) {
+    cdrip_set_cover_art_cache(dir.string().c_str(), 1024 * 1024);
+    const auto png = make_fake_png(64, 0x11);
+    store_cached_cover_art("caa-release", "release-1", 512, png);
+
+    std::vector<uint8_t> loaded;
+    expect_true(load_cached_cover_art("caa-release", "release-1", 512, loaded), "stored image should hit");
+    expect_true(loaded == png, "cached bytes should round-trip");
+    expect_true(!load_cached_cover_art("caa-release", "release-1", 256, loaded), "other widths should miss");
+    expect_true(!load_cached_cover_art("discogs", "release-1", 512, loaded), "other sources should miss");
+    expect_true(!load_cached_cover_art("caa-release", "release-2", 512, loaded), "other ids should miss");
+};
+
+auto test_cache_evicts_least_recently_used = [](const std::filesystem::path& dir) {
+    // Room for two images (plus their small metadata files) but not three.
+    cdrip_set_cover_art_cache(dir.string().c_str(), 2 * 4096 + 1024);
+    store_cached_cover_art("discogs", "1", 512, make_fake_png(4096, 0x01));
+    store_cached_cover_art("discogs", "2", 512, make_fake_png(4096, 0x02));
+
+    // Make "1" the most recently used entry before the third store.
+    std::vector<uint8_t> loaded;
+    const auto old_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+    for (const auto& item : std::filesystem::directory_iterator(dir)) {
+        if (item.path().extension() == ".png") std::filesystem::last_write_time(item.path(), old_time);
+    }
+    expect_true(load_cached_cover_art("discogs", "1", 512, loaded), "first image should still be cached");
+
+    store_cached_cover_art("discogs", "3", 512, make_fake_png(4096, 0x03));
+    expect_size(2, count_cached_images(dir), "cache should be trimmed to its budget");
+    expect_true(load_cached_cover_art("discogs", "1", 512, loaded), "recently used image should survive");
+    expect_true(!load_cached_cover_art("discogs", "2", 512, loaded), "least recently used image should be evicted");
+    expect_true(load_cached_cover_art("discogs", "3", 512, loaded), "new image should be cached");
+};
+
+auto test_disabled_cache_is_a_no_op = [](const std::filesystem::path& dir) {
+    cdrip_set_cover_art_cache(nullptr, 0);
+    store_cached_cover_art("discogs", "4", 512, make_fake_png(64, 0x04));
+    std::vector<uint8_t> loaded;
+    expect_true(!load_cached_cover_art("discogs", "4", 512, loaded), "disabled cache should never hit");
+    (void)dir;
+};
+
+}  // namespace
+
+int main() {
+    gchar* tmp = g_dir_make_tmp("cdrip-cover-cache-XXXXXX", nullptr);
+    expect_true(tmp != nullptr, "temp directory should be created");
+    const std::filesystem::path root(tmp);
+    g_free(tmp);
+
+    test_cache_round_trip_is_keyed_by_source_id_and_width(root / "round_trip");
+    test_cache_evicts_least_recently_used(root / "lru");
+    test_disabled_cache_is_a_no_op(root / "disabled");
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    return 0;
+}
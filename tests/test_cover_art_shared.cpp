@@ -0,0 +1,89 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/cdrip/internal.h"
+
+using cdrip::detail::make_shared_cover_art_data;
+using cdrip::detail::release_cover_art_data;
+using cdrip::detail::retain_cover_art_data;
+
+namespace {
+
+auto expect_true = [](
+    bool condition,
+    const std::string& message) {
+
+    if (!condition) {
+        std::cerr << "assert_true failed: " << message << "\n";
+        std::exit(1);
+    }
+};
+
+CdRipCddbEntryList* make_list_sharing(
+    const uint8_t* data,
+    size_t size,
+    size_t count) {
+
+    auto* list = new CdRipCddbEntryList{};
+    list->count = count;
+    list->entries = new CdRipCddbEntry[count]{};
+    for (size_t i = 0; i < count; ++i) {
+        list->entries[i].cover_art.data = retain_cover_art_data(data);
+        list->entries[i].cover_art.size = size;
+    }
+    return list;
+}
+
+auto test_release_keeps_shared_bytes_alive = []() {
+    const std::vector<uint8_t> bytes{1, 2, 3, 4, 5, 6, 7, 8};
+    const uint8_t* data = make_shared_cover_art_data(bytes.data(), bytes.size());
+    expect_true(data != nullptr, "shared buffer should be allocated");
+
+    CdRipCddbEntryList* list = make_list_sharing(data, bytes.size(), 3);
+    expect_true(list->entries[0].cover_art.data == data, "clones should share the same bytes");
+    expect_true(list->entries[2].cover_art.data == data, "clones should share the same bytes");
+    cdrip_release_cddbentry_list(list);
+
+    expect_true(std::vector<uint8_t>(data, data + bytes.size()) == bytes,
+        "bytes should survive while a reference remains");
+    release_cover_art_data(data);
+};
+
+auto test_retain_shares_without_copying = []() {
+    const std::vector<uint8_t> bytes{9, 8, 7, 6};
+    const uint8_t* data = make_shared_cover_art_data(bytes.data(), bytes.size());
+    const uint8_t* shared = retain_cover_art_data(data);
+    expect_true(shared == data, "retaining should not copy");
+    release_cover_art_data(data);
+    expect_true(shared[0] == 9 && shared[3] == 6, "bytes should survive the first release");
+    release_cover_art_data(shared);
+};
+
+auto test_release_frees_caller_buffers = []() {
+    // Consumers may fill entries from their own new[] buffers; releasing them must stay valid.
+    auto* bytes = new uint8_t[4]{1, 2, 3, 4};
+    auto* list = new CdRipCddbEntryList{};
+    list->count = 1;
+    list->entries = new CdRipCddbEntry[1]{};
+    list->entries[0].cover_art.data = bytes;
+    list->entries[0].cover_art.size = 4;
+    cdrip_release_cddbentry_list(list);
+};
+
+auto test_empty_input_is_null = []() {
+    expect_true(make_shared_cover_art_data(nullptr, 4) == nullptr, "null input should not allocate");
+    expect_true(retain_cover_art_data(nullptr) == nullptr, "null retain should stay null");
+    release_cover_art_data(nullptr);
+};
+
+}  // namespace
+
+int main() {
+    test_release_keeps_shared_bytes_alive();
+    test_retain_shares_without_copying();
+    test_release_frees_caller_buffers();
+    test_empty_input_is_null();
+    return 0;
+}
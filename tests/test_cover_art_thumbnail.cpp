@@ -0,0 +1,127 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/cdrip/internal.h"
+
+using cdrip::detail::select_caa_front_image_urls;
+using cdrip::detail::select_discogs_front_image_url;
+
+namespace {
+
+auto expect_true = [](
+    bool condition,
+    const std::string& message) {
+
+    if (!condition) {
+        std::cerr << "assert_true failed: " << message << "\n";
+        std::exit(1);
+    }
+};
+
+auto expect_eq = [](
+    const std::string& expected,
+    const std::string& actual,
+    const std::string& message) {
+
+    if (expected != actual) {
+        std::cerr << "assert_eq failed: " << message << "\n";
+        std::cerr << "  expected: " << expected << "\n";
+        std::cerr << "  actual:   " << actual << "\n";
+        std::exit(1);
+    }
+};
+
+auto expect_size = [](
+    size_t expected,
+    size_t actual,
+    const std::string& message) {
+
+    if (expected != actual) {
+        std::cerr << "assert_size failed: " << message << "\n";
+        std::cerr << "  expected: " << expected << "\n";
+        std::cerr << "  actual:   " << actual << "\n";
+        std::exit(1);
+    }
+};
+
+const std::string kCaaIndex = R"({
+  "images": [
+    {
+      "front": false,
+      "types": ["Back"],
+      "image": "http://coverartarchive.org/release/r/back.jpg",
+      "thumbnails": {"250": "http://coverartarchive.org/release/r/back-250.jpg"}
+    },
+    {
+      "front": true,
+      "types": ["Front"],
+      "image": "http://coverartarchive.org/release/r/front.jpg",
+      "thumbnails": {
+        "250": "http://coverartarchive.org/release/r/front-250.jpg",
+        "500": "http://coverartarchive.org/release/r/front-500.jpg",
+        "1200": "http://coverartarchive.org/release/r/front-1200.jpg",
+        "small": "http://coverartarchive.org/release/r/front-250.jpg",
+        "large": "http://coverartarchive.org/release/r/front-500.jpg"
+      }
+    }
+  ]
+})";
+
+auto test_caa_picks_smallest_thumbnail_covering_max_width = []() {
+    std::vector<std::string> urls;
+    std::string err;
+    expect_true(select_caa_front_image_urls(kCaaIndex, 512, urls, err), "index should resolve: " + err);
+    expect_size(2, urls.size(), "thumbnail and original fallback");
+    expect_eq("https://coverartarchive.org/release/r/front-1200.jpg", urls[0], "512px needs the 1200 thumbnail");
+    expect_eq("https://coverartarchive.org/release/r/front.jpg", urls[1], "original is the fallback");
+
+    expect_true(select_caa_front_image_urls(kCaaIndex, 500, urls, err), "index should resolve: " + err);
+    expect_eq("https://coverartarchive.org/release/r/front-500.jpg", urls[0], "500px fits the 500 thumbnail");
+
+    expect_true(select_caa_front_image_urls(kCaaIndex, 200, urls, err), "index should resolve: " + err);
+    expect_eq("https://coverartarchive.org/release/r/front-250.jpg", urls[0], "small widths use the 250 thumbnail");
+};
+
+auto test_caa_uses_original_when_no_thumbnail_is_big_enough = []() {
+    std::vector<std::string> urls;
+    std::string err;
+    expect_true(select_caa_front_image_urls(kCaaIndex, 2000, urls, err), "index should resolve: " + err);
+    expect_size(1, urls.size(), "only the original should be requested");
+    expect_eq("https://coverartarchive.org/release/r/front.jpg", urls[0], "original covers large widths");
+};
+
+auto test_caa_without_front_image_fails = []() {
+    const std::string index = R"({"images": [{"front": false, "types": ["Back"], "image": "https://x/back.jpg"}]})";
+    std::vector<std::string> urls;
+    std::string err;
+    expect_true(!select_caa_front_image_urls(index, 512, urls, err), "missing front should fail");
+    expect_true(!err.empty(), "missing front should report an error");
+};
+
+auto test_discogs_prefers_150_variant_only_when_sufficient = []() {
+    const std::string release = R"({
+      "images": [
+        {"type": "secondary", "uri": "https://i.discogs.com/s.jpg", "uri150": "https://i.discogs.com/s150.jpg", "width": 600},
+        {"type": "primary", "uri": "https://i.discogs.com/p.jpg", "uri150": "https://i.discogs.com/p150.jpg", "width": 600}
+      ]
+    })";
+    std::string url;
+    std::string err;
+    expect_true(select_discogs_front_image_url(release, 512, url, err), "release should resolve: " + err);
+    expect_eq("https://i.discogs.com/p.jpg", url, "512px needs the full primary image");
+
+    expect_true(select_discogs_front_image_url(release, 120, url, err), "release should resolve: " + err);
+    expect_eq("https://i.discogs.com/p150.jpg", url, "120px fits the 150 variant");
+};
+
+}  // namespace
+
+int main() {
+    test_caa_picks_smallest_thumbnail_covering_max_width();
+    test_caa_uses_original_when_no_thumbnail_is_big_enough();
+    test_caa_without_front_image_fails();
+    test_discogs_prefers_150_variant_only_when_sufficient();
+    return 0;
+}
@@ -1,11 +1,15 @@
 #include <cstdlib>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <iostream>
 #include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include <json-glib/json-glib.h>
+
 #include "../src/cdrip/internal.h"
 
 namespace {
@@ -107,6 +111,15 @@ struct FakeBackendState {
     bool fail_get_disc_last_sector{false};
     bool fail_seek{false};
     int fail_read_call{-1};
+    // Returns a damaged copy of the sector on this read call (simulates an unstable read).
+    int corrupt_read_call{-1};
+    std::vector<int16_t> corrupted_sector{};
+    // Reports a paranoia fixup on this read call.
+    int fixup_read_call{-1};
+    // Fails this read call but moves on, like paranoia giving up on an unreadable sector.
+    int damaged_read_call{-1};
+    int last_max_retries{0};
+    std::vector<CdRipRipModes> reader_mode_changes{};
     bool fail_eject{false};
 };
 
@@ -119,6 +132,13 @@ struct RecordedProgress {
     std::string title{};
     std::string track_name{};
     std::string path{};
+    int compression_level{-1};
+    int compression_adaptive{0};
+    long verify_reread_sectors{0};
+    long damaged_sectors{0};
+    CdRipReadStats read_stats{};
+    bool has_telemetry{false};
+    long telemetry_sectors_read{0};
 };
 
 std::vector<RecordedProgress>* g_recorded_progress = nullptr;
@@ -290,7 +310,9 @@ auto fake_seek_reader = [](
 
 auto fake_read_sector = [](
     void* reader,
+    int max_retries,
     const int16_t*& out_buffer,
+    CdRipReadStats& stats,
     std::string& err) {
 
     expect_true(g_fake_backend_state != nullptr, "fake backend state should be installed");
@@ -301,6 +323,14 @@ auto fake_read_sector = [](
         err = "Fake read failure";
         return false;
     }
+    g_fake_backend_state->last_max_retries = max_retries;
+    if (g_fake_backend_state->read_calls == g_fake_backend_state->damaged_read_call) {
+        out_buffer = nullptr;
+        err = "Fake damaged sector";
+        g_fake_backend_state->next_sector_index++;
+        g_fake_backend_state->read_calls++;
+        return false;
+    }
     err.clear();
     if (g_fake_backend_state->next_sector_index >= g_fake_backend_state->sectors.size()) {
         out_buffer = nullptr;
@@ -308,11 +338,32 @@ auto fake_read_sector = [](
         return false;
     }
     out_buffer = g_fake_backend_state->sectors[g_fake_backend_state->next_sector_index].data();
+    if (g_fake_backend_state->read_calls == g_fake_backend_state->corrupt_read_call) {
+        auto& corrupted = g_fake_backend_state->corrupted_sector;
+        corrupted = g_fake_backend_state->sectors[g_fake_backend_state->next_sector_index];
+        corrupted[100] = static_cast<int16_t>(corrupted[100] ^ 0x0100);
+        out_buffer = corrupted.data();
+    }
+    if (g_fake_backend_state->read_calls == g_fake_backend_state->fixup_read_call) {
+        stats.fixups++;
+    }
     g_fake_backend_state->next_sector_index++;
     g_fake_backend_state->read_calls++;
     return true;
 };
 
+auto fake_set_reader_mode = [](
+    void* reader,
+    CdRipRipModes mode,
+    std::string& err) {
+
+    expect_true(g_fake_backend_state != nullptr, "fake backend state should be installed");
+    expect_true(reader != nullptr, "fake reader handle should be valid");
+    err.clear();
+    g_fake_backend_state->reader_mode_changes.push_back(mode);
+    return true;
+};
+
 const cdrip::detail::DriveBackend kFakeDriveBackend{
     fake_detect_drives,
     fake_open_drive,
@@ -326,6 +377,7 @@ const cdrip::detail::DriveBackend kFakeDriveBackend{
     fake_get_disc_last_sector,
     fake_seek_reader,
     fake_read_sector,
+    fake_set_reader_mode,
 };
 
 struct FakeBackendScope {
@@ -354,6 +406,13 @@ auto progress_callback = [](
         cdrip::detail::to_string_or_empty(info->title),
         cdrip::detail::to_string_or_empty(info->track_name),
         cdrip::detail::to_string_or_empty(info->path),
+        info->compression_level,
+        info->compression_adaptive,
+        info->verify_reread_sectors,
+        info->damaged_sectors,
+        info->read_stats ? *info->read_stats : CdRipReadStats{},
+        info->telemetry != nullptr,
+        info->telemetry ? info->telemetry->sectors_read : 0,
     });
 };
 
@@ -469,6 +528,8 @@ auto test_open_build_toc_rip_and_close_use_swapped_backend = []() {
         1,
         RIP_MODES_FAST,
         true,
+        0,
+        0,
     };
     const char* err = nullptr;
     CdRip* rip = open_fake_rip(settings);
@@ -538,7 +599,7 @@ auto test_open_reports_backend_failure = []() {
     state.fail_open = true;
     FakeBackendScope scope(state);
 
-    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false};
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
     const char* err = nullptr;
     CdRip* rip = cdrip_open("/dev/fake-cdrom", &settings, &err);
     expect_true(rip == nullptr, "open should fail when backend open fails");
@@ -552,7 +613,7 @@ auto test_open_releases_drive_when_reader_creation_fails = []() {
     state.fail_create_reader = true;
     FakeBackendScope scope(state);
 
-    const CdRipSettings settings{"", 1, RIP_MODES_BEST, false};
+    const CdRipSettings settings{"", 1, RIP_MODES_BEST, false, 0, 0};
     const char* err = nullptr;
     CdRip* rip = cdrip_open("/dev/fake-cdrom", &settings, &err);
     expect_true(rip == nullptr, "open should fail when reader creation fails");
@@ -569,7 +630,7 @@ auto test_build_disc_toc_reports_backend_failure_and_no_audio = []() {
         state.fail_get_track_count = true;
         FakeBackendScope scope(state);
 
-        const CdRipSettings settings{"", 1, RIP_MODES_FAST, false};
+        const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
         CdRip* rip = open_fake_rip(settings);
         const char* err = nullptr;
         CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
@@ -589,7 +650,7 @@ auto test_build_disc_toc_reports_backend_failure_and_no_audio = []() {
         }
         FakeBackendScope scope(state);
 
-        const CdRipSettings settings{"", 1, RIP_MODES_FAST, false};
+        const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
         CdRip* rip = open_fake_rip(settings);
         const char* err = nullptr;
         CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
@@ -614,7 +675,7 @@ auto test_rip_track_reports_seek_and_read_failures = []() {
         std::filesystem::create_directories(temp_dir);
         const auto flac_path = (temp_dir / "seek-failure.flac").string();
 
-        const CdRipSettings settings{"", 1, RIP_MODES_FAST, false};
+        const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
         CdRip* rip = open_fake_rip(settings);
         const char* err = nullptr;
         CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
@@ -660,7 +721,7 @@ auto test_rip_track_reports_seek_and_read_failures = []() {
         std::filesystem::create_directories(temp_dir);
         const auto flac_path = (temp_dir / "read-failure.flac").string();
 
-        const CdRipSettings settings{"", 1, RIP_MODES_FAST, false};
+        const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
         CdRip* rip = open_fake_rip(settings);
         const char* err = nullptr;
         CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
@@ -702,7 +763,7 @@ auto test_close_reports_eject_failure_after_cleanup = []() {
     state.fail_eject = true;
     FakeBackendScope scope(state);
 
-    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false};
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
     CdRip* rip = open_fake_rip(settings);
     const char* err = nullptr;
     cdrip_close(rip, true, &err);
@@ -722,7 +783,7 @@ auto test_rip_track_skips_non_audio_without_reads = []() {
     std::filesystem::create_directories(temp_dir);
     const auto flac_path = (temp_dir / "skip.flac").string();
 
-    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false};
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
     CdRip* rip = open_fake_rip(settings);
     const auto entry = make_test_entry();
     CdRipDiscToc toc{};
@@ -770,7 +831,7 @@ auto test_rip_track_emits_progress_updates = []() {
     std::filesystem::create_directories(temp_dir);
     const auto flac_path = (temp_dir / "progress.flac").string();
 
-    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false};
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
     CdRip* rip = open_fake_rip(settings);
     const char* err = nullptr;
     CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
@@ -806,6 +867,423 @@ auto test_rip_track_emits_progress_updates = []() {
     expect_true(progress.back().total_tracks == static_cast<int>(toc->tracks_count), "progress callback should preserve total tracks");
     expect_eq("Fake Track 1", progress.back().track_name, "progress callback should include track name");
     expect_eq(flac_path, progress.back().path, "progress callback should include output path");
+    expect_true(progress.back().compression_level == 1, "progress callback should report the fixed compression level");
+    expect_true(progress.back().compression_adaptive == 0, "fixed compression should not be reported as adaptive");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_adaptive_compression_level_follows_encoder_headroom = []() {
+    using cdrip::detail::next_adaptive_compression_level;
+    expect_true(next_adaptive_compression_level(5, 1.0, 60.0) == 6, "ample headroom should raise the level");
+    expect_true(next_adaptive_compression_level(8, 1.0, 60.0) == 8, "level should not exceed 8");
+    expect_true(next_adaptive_compression_level(5, 20.0, 60.0) == 5, "moderate load should keep the level");
+    expect_true(next_adaptive_compression_level(5, 40.0, 60.0) == 4, "encoder near the drive rate should lower the level");
+    expect_true(next_adaptive_compression_level(5, 90.0, 60.0) == 3, "encoder slower than the drive should drop faster");
+    expect_true(next_adaptive_compression_level(0, 90.0, 60.0) == 0, "level should not go below 0");
+    expect_true(next_adaptive_compression_level(5, 0.0, 0.5) == 5, "too short a measurement should keep the level");
+};
+
+auto test_resolve_encoder_threads_follows_drive_speed = []() {
+    using cdrip::detail::resolve_encoder_threads;
+    expect_true(resolve_encoder_threads(0, false) == 1, "auto should stay single-threaded at 1x");
+    expect_true(resolve_encoder_threads(0, true) >= 1, "auto should pick at least one thread at full speed");
+#ifdef CDRIP_HAVE_FLAC_NUM_THREADS
+    expect_true(resolve_encoder_threads(3, false) == 3, "explicit thread count should be used as is");
+#else
+    expect_true(resolve_encoder_threads(3, true) == 1, "older libFLAC should fall back to one thread");
+#endif
+};
+
+auto test_rip_track_reports_adaptive_compression_level = []() {
+    auto state = make_backend_state();
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-adaptive";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "adaptive.flac").string();
+
+    const CdRipSettings settings{"", CDRIP_COMPRESSION_ADAPTIVE, RIP_MODES_FAST, false, 0, 0};
+    CdRip* rip = open_fake_rip(settings);
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before adaptive test");
+    release_error(err);
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::vector<RecordedProgress> progress{};
+    ProgressCaptureScope progress_scope(progress);
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[0], &entry, toc, progress_callback,
+            static_cast<int>(toc->tracks_count), 0.0, 4.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "adaptive rip should succeed" : rip_err);
+    expect_true(!progress.empty(), "adaptive rip should emit progress");
+    expect_true(progress.back().compression_level == 1, "first adaptive track should start from the mode default");
+    expect_true(progress.back().compression_adaptive != 0, "adaptive level should be flagged in progress");
+    expect_true(rip->adaptive_compression_level >= 0, "next track level should be decided after the track");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_rip_track_applies_read_offset = []() {
+    auto state = make_backend_state();
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-offset";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "offset.flac").string();
+
+    constexpr int kOffset = 30;
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, kOffset};
+    CdRip* rip = open_fake_rip(settings);
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before offset test");
+    release_error(err);
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[1], &entry, toc, nullptr,
+            static_cast<int>(toc->tracks_count), 0.0, 0.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "offset rip should succeed" : rip_err);
+    expect_true(state.last_seek_sector == 160, "a small positive offset should start at the track start");
+    expect_size(150, static_cast<size_t>(state.read_calls), "sectors past the lead-out should not be read");
+
+    // Frame n of the track comes from the drive's frame n + offset; past the lead-out is silence.
+    const long track_frames = 150L * kSamplesPerSector;
+    long frame = 0;
+    bool matches = true;
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string decode_err;
+    expect_true(
+        cdrip::detail::decode_flac_file(
+            flac_path,
+            true,
+            [&](const FLAC__int32* samples, size_t frames, unsigned, unsigned) {
+                for (size_t i = 0; i < frames; ++i, ++frame) {
+                    const long source = frame + kOffset;
+                    int expected = 0;
+                    if (source < track_frames) {
+                        const long sector = 160 + source / kSamplesPerSector;
+                        expected = static_cast<int>(((sector + source % kSamplesPerSector) % 128) * 128);
+                    }
+                    if (samples[i * 2] != expected || samples[i * 2 + 1] != -expected) matches = false;
+                }
+                return true;
+            },
+            decoded,
+            decode_err),
+        decode_err.empty() ? "offset FLAC should decode" : decode_err);
+    expect_true(frame == track_frames, "offset rip should keep the track length");
+    expect_true(matches, "offset rip should shift audio by the read offset");
+
+    const auto tags = read_vorbis_comments(flac_path);
+    expect_eq("30", tags.at("ACCURATERIP_READ_OFFSET"), "offset should be recorded in the tags");
+    expect_true(tags.at("ACCURATERIP_CRC_V1").size() == 8, "AccurateRip v1 checksum should be tagged");
+    expect_true(tags.at("ACCURATERIP_CRC_V2").size() == 8, "AccurateRip v2 checksum should be tagged");
+    expect_true(tags.count("ACCURATERIP_RESULT") == 0, "no result should be tagged without a database");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_rip_track_verify_mode_rereads_mismatching_ranges = []() {
+    auto state = make_backend_state();
+    // Second sector of the test pass reads differently from the copy pass.
+    state.corrupt_read_call = 1;
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-verify";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "verify.flac").string();
+
+    const CdRipSettings settings{"", 1, RIP_MODES_VERIFY, false, 0, 0};
+    CdRip* rip = open_fake_rip(settings);
+    expect_true(state.last_reader_mode == RIP_MODES_VERIFY, "verify mode should open its fast reader");
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before verify test");
+    release_error(err);
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::vector<RecordedProgress> progress{};
+    ProgressCaptureScope progress_scope(progress);
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[0], &entry, toc, progress_callback,
+            static_cast<int>(toc->tracks_count), 0.0, 4.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "verify rip should succeed" : rip_err);
+
+    // 150 sectors per pass; only the first 128-sector range differs and is read again.
+    expect_size(150 + 150 + 128, static_cast<size_t>(state.read_calls), "only the mismatching range should be re-read");
+    expect_size(2, static_cast<size_t>(state.create_reader_calls), "re-reads should use a second reader");
+    expect_true(state.last_reader_mode == RIP_MODES_BEST, "re-reads should use full integrity checks");
+    expect_size(1, static_cast<size_t>(state.destroy_reader_calls), "the re-read reader should be released after the track");
+    expect_true(!progress.empty(), "verify rip should emit progress");
+    expect_true(progress.back().percent == 100.0, "verify rip should end at 100 percent");
+    expect_true(progress.back().verify_reread_sectors == 128, "re-read sectors should be reported");
+    for (const auto& entry_progress : progress) {
+        if (entry_progress.percent < 50.0) {
+            expect_true(entry_progress.verify_reread_sectors == 0, "the test pass should not re-read");
+        }
+    }
+
+    long frame = 0;
+    bool matches = true;
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string decode_err;
+    expect_true(
+        cdrip::detail::decode_flac_file(
+            flac_path,
+            true,
+            [&](const FLAC__int32* samples, size_t frames, unsigned, unsigned) {
+                for (size_t i = 0; i < frames; ++i, ++frame) {
+                    const long sector = frame / kSamplesPerSector;
+                    const int expected = static_cast<int>(((sector + frame % kSamplesPerSector) % 128) * 128);
+                    if (samples[i * 2] != expected || samples[i * 2 + 1] != -expected) matches = false;
+                }
+                return true;
+            },
+            decoded,
+            decode_err),
+        decode_err.empty() ? "verify FLAC should decode" : decode_err);
+    expect_true(frame == 150L * kSamplesPerSector, "verify rip should keep the track length");
+    expect_true(matches, "verify rip should contain the clean audio");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_rip_track_hybrid_mode_escalates_around_errors = []() {
+    auto state = make_backend_state();
+    // One five-range audio track; a fixup shows up in the first range.
+    state.tracks = {CdRipTrackInfo{1, 0, 639, 1}};
+    state.last_sector = 639;
+    state.sectors.resize(640, state.sectors.front());
+    state.fixup_read_call = 5;
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-hybrid";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "hybrid.flac").string();
+
+    const CdRipSettings settings{"", 1, RIP_MODES_HYBRID, false, 0, 0};
+    CdRip* rip = open_fake_rip(settings);
+    expect_true(state.last_reader_mode == RIP_MODES_HYBRID, "hybrid mode should open its reader with light checks");
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before hybrid test");
+    release_error(err);
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::vector<RecordedProgress> progress{};
+    ProgressCaptureScope progress_scope(progress);
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[0], &entry, toc, progress_callback,
+            static_cast<int>(toc->tracks_count), 0.0, 15.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "hybrid rip should succeed" : rip_err);
+
+    // The first range is read again in full mode, which stays on for two clean ranges.
+    expect_size(640 + 128, static_cast<size_t>(state.read_calls), "only the erroring range should be read twice");
+    expect_size(3, state.reader_mode_changes.size(), "hybrid mode should reset, escalate and de-escalate");
+    expect_true(state.reader_mode_changes[0] == RIP_MODES_HYBRID, "tracks should start with light checks");
+    expect_true(state.reader_mode_changes[1] == RIP_MODES_BEST, "errors should escalate to full checks");
+    expect_true(state.reader_mode_changes[2] == RIP_MODES_HYBRID, "clean ranges should de-escalate");
+    expect_true(!progress.empty(), "hybrid rip should emit progress");
+    const auto& stats = progress.back().read_stats;
+    expect_true(stats.fixups == 1, "paranoia events should be counted");
+    expect_true(stats.escalations == 1, "escalations should be counted");
+    expect_true(stats.escalated_sectors == 3 * 128, "sectors read in full mode should be counted");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_read_telemetry_buckets_sector_times = []() {
+    CdRipReadTelemetry telemetry{};
+    cdrip::detail::record_sector_read(telemetry, 0.0004);
+    cdrip::detail::record_sector_read(telemetry, 0.001);
+    cdrip::detail::record_sector_read(telemetry, 0.03);
+    cdrip::detail::record_sector_read(telemetry, 5.0);
+    expect_true(telemetry.sector_time_histogram[0] == 1, "sub-millisecond reads should land in the first bucket");
+    expect_true(telemetry.sector_time_histogram[1] == 1, "bucket bounds should be exclusive");
+    expect_true(telemetry.sector_time_histogram[4] == 1, "30 ms should land in the <100 ms bucket");
+    expect_true(telemetry.sector_time_histogram[CDRIP_READ_TIME_BUCKETS - 1] == 1, "slow reads should land in the open bucket");
+    expect_true(telemetry.sectors_read == 4, "every read should be counted");
+    expect_true(telemetry.slowest_sector_sec == 5.0, "the slowest read should be kept");
+    telemetry.stats.fixups = 2;
+    expect_eq(
+        "sectors=4 rereads=0 fixups=2 scratches=0 skips=0 drifts=0 read_errors=0 slowest_ms=5000",
+        cdrip::detail::format_read_quality_tag(telemetry),
+        "read quality tag should summarize the telemetry");
+    expect_eq(
+        "smb://nas/music/Album/read_report.json",
+        cdrip::detail::resolve_read_report_path("smb://nas/music/Album/01.flac"),
+        "read report should sit next to the tracks");
+};
+
+auto test_rip_track_collects_read_telemetry = []() {
+    auto state = make_backend_state();
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-telemetry";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "telemetry.flac").string();
+    const auto report_path = (temp_dir / "read_report.json").string();
+
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
+    CdRip* rip = open_fake_rip(settings);
+    std::vector<std::string> diagnostics{};
+    CdRipDiagnosticObserver observer{};
+    observer.callback = [](const CdRipDiagnosticInfo* info, void*, void* user_data) {
+        static_cast<std::vector<std::string>*>(user_data)->push_back(info->message);
+    };
+    observer.user_data = &diagnostics;
+    cdrip_set_read_telemetry(rip, true, &observer);
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before telemetry test");
+    release_error(err);
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::vector<RecordedProgress> progress{};
+    ProgressCaptureScope progress_scope(progress);
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[0], &entry, toc, progress_callback,
+            static_cast<int>(toc->tracks_count), 0.0, 4.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "telemetry rip should succeed" : rip_err);
+
+    expect_true(!progress.empty() && progress.back().has_telemetry, "progress should carry telemetry");
+    expect_true(progress.back().telemetry_sectors_read == 150, "every sector read should be timed");
+    expect_size(1, rip->telemetry_tracks.size(), "finished tracks should be kept for the report");
+    long histogram_total = 0;
+    for (const long count : rip->telemetry_tracks[0].sector_time_histogram) histogram_total += count;
+    expect_true(histogram_total == 150, "histogram should cover every sector read");
+    expect_size(1, diagnostics.size(), "observer should get one summary per track");
+    expect_true(diagnostics[0].find("Track 1 read quality: sectors=150") == 0, "summary should name the track");
+
+    const auto tags = read_vorbis_comments(flac_path);
+    expect_true(tags.at("CDRIP_READ_QUALITY").find("sectors=150 ") == 0, "read quality should be tagged");
+
+    expect_true(cdrip_write_read_report(rip, toc, report_path.c_str(), &err) != 0, err ? err : "report should be written");
+    release_error(err);
+    std::ifstream report_in(report_path);
+    const std::string report{std::istreambuf_iterator<char>(report_in), std::istreambuf_iterator<char>()};
+    JsonParser* parser = json_parser_new();
+    expect_true(json_parser_load_from_data(parser, report.c_str(), static_cast<gssize>(report.size()), nullptr),
+        "report should be valid JSON");
+    JsonObject* root = json_node_get_object(json_parser_get_root(parser));
+    JsonArray* report_tracks = json_object_get_array_member(root, "tracks");
+    expect_size(1, json_array_get_length(report_tracks), "report should list the ripped track");
+    JsonObject* report_track = json_array_get_object_element(report_tracks, 0);
+    expect_true(json_object_get_int_member(report_track, "track") == 1, "report should name the ripped track");
+    expect_true(json_object_get_int_member(report_track, "sectors_read") == 150, "report should hold the sector count");
+    expect_true(json_object_get_int_member(json_object_get_object_member(root, "total"), "sectors_read") == 150,
+        "report total should add up the tracks");
+    g_object_unref(parser);
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_rip_track_read_budget_replaces_damaged_sectors = []() {
+    auto state = make_backend_state();
+    state.damaged_read_call = 10;
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-budget";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "budget.flac").string();
+
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
+    CdRip* rip = open_fake_rip(settings);
+    cdrip_set_read_budget(rip, 5.0, 600.0, nullptr);
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before budget test");
+    release_error(err);
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::vector<RecordedProgress> progress{};
+    ProgressCaptureScope progress_scope(progress);
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[0], &entry, toc, progress_callback,
+            static_cast<int>(toc->tracks_count), 0.0, 2.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "budgeted rip should survive an unreadable sector" : rip_err);
+    expect_size(150, static_cast<size_t>(state.read_calls), "an unreadable sector should be read only once");
+    expect_true(state.last_max_retries == 0, "fast reads should keep the backend's default retries");
+    expect_true(!progress.empty() && progress.back().damaged_sectors == 1, "progress should count damaged sectors");
+
+    // The unreadable sector becomes silence; its neighbours keep their audio.
+    long frame = 0;
+    bool matches = true;
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string decode_err;
+    expect_true(
+        cdrip::detail::decode_flac_file(
+            flac_path,
+            true,
+            [&](const FLAC__int32* samples, size_t frames, unsigned, unsigned) {
+                for (size_t i = 0; i < frames; ++i, ++frame) {
+                    const long sector = frame / kSamplesPerSector;
+                    const int expected = sector == 10
+                        ? 0
+                        : static_cast<int>(((sector + frame % kSamplesPerSector) % 128) * 128);
+                    if (samples[i * 2] != expected || samples[i * 2 + 1] != -expected) matches = false;
+                }
+                return true;
+            },
+            decoded,
+            decode_err),
+        decode_err.empty() ? "budgeted FLAC should decode" : decode_err);
+    expect_true(frame == 150L * kSamplesPerSector, "budgeted rip should keep the track length");
+    expect_true(matches, "only the unreadable sector should be silenced");
+
+    const auto tags = read_vorbis_comments(flac_path);
+    expect_eq("10", tags.at("CDRIP_DAMAGED_SECTORS"), "damaged sectors should be tagged as LBA ranges");
 
     cdrip_release_disctoc(toc);
     cdrip_close(rip, false, &err);
@@ -813,6 +1291,591 @@ auto test_rip_track_emits_progress_updates = []() {
     std::filesystem::remove_all(temp_dir);
 };
 
+auto test_salvage_disc_retries_only_damaged_ranges = []() {
+    auto state = make_backend_state();
+    // A damaged read with a fixup in the first range of track 1.
+    state.corrupt_read_call = 5;
+    state.fixup_read_call = 5;
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-salvage";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "salvage.flac").string();
+
+    const CdRipSettings settings{"", 1, RIP_MODES_SALVAGE, false, 0, 0};
+    CdRip* rip = open_fake_rip(settings);
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before salvage test");
+    release_error(err);
+
+    std::vector<std::string> diagnostics{};
+    CdRipDiagnosticObserver observer{};
+    observer.callback = [](const CdRipDiagnosticInfo* info, void*, void* user_data) {
+        static_cast<std::vector<std::string>*>(user_data)->push_back(info->message);
+    };
+    observer.user_data = &diagnostics;
+    std::vector<RecordedProgress> salvage_progress{};
+    {
+        ProgressCaptureScope salvage_scope(salvage_progress);
+        expect_true(
+            cdrip_salvage_disc(rip, toc, &observer, progress_callback, &err) != 0,
+            err ? err : "salvage should succeed");
+    }
+    release_error(err);
+
+    // Both audio tracks once, then only the 32-sector range that reported the fixup.
+    expect_size(150 + 150 + 32, static_cast<size_t>(state.read_calls), "only the damaged range should be read again");
+    expect_size(2, state.reader_mode_changes.size(), "salvage should read fast, then retry with overlap checks");
+    expect_true(state.reader_mode_changes[0] == RIP_MODES_HYBRID, "the first pass should keep overlap checks");
+    expect_true(state.reader_mode_changes[1] == RIP_MODES_HYBRID, "the retry pass should add overlap checks");
+    expect_true(!state.last_speed_fast, "the configured drive speed should be restored");
+    expect_size(2, diagnostics.size(), "every pass should be summarized");
+    expect_eq(
+        "Salvage pass 2 (overlap checks, slow): 32 sectors recovered, 0 sectors still damaged",
+        diagnostics[1],
+        "the retry pass should recover the range");
+    // Every range of both passes is reported; the pass stands in for the track name.
+    expect_size(5 + 5 + 1, salvage_progress.size(), "every salvage range should report progress");
+    expect_eq("Salvage pass 1 (fast)", salvage_progress[9].track_name, "the first pass should be named");
+    expect_true(salvage_progress[9].percent >= 100.0, "the first pass should end at 100%");
+    expect_eq("Salvage pass 2 (overlap checks)", salvage_progress[10].track_name, "the retry pass should be named");
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::vector<RecordedProgress> progress{};
+    ProgressCaptureScope progress_scope(progress);
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[0], &entry, toc, progress_callback,
+            static_cast<int>(toc->tracks_count), 0.0, 4.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "salvaged track should encode" : rip_err);
+    expect_size(150 + 150 + 32, static_cast<size_t>(state.read_calls), "encoding should not touch the drive");
+    expect_true(!progress.empty() && progress.back().read_stats.fixups == 1, "salvage read stats should be reported");
+    expect_true(progress.back().damaged_sectors == 0, "recovered ranges should not count as damaged");
+
+    // The retried range replaced the damaged first read.
+    long frame = 0;
+    bool matches = true;
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string decode_err;
+    expect_true(
+        cdrip::detail::decode_flac_file(
+            flac_path,
+            true,
+            [&](const FLAC__int32* samples, size_t frames, unsigned, unsigned) {
+                for (size_t i = 0; i < frames; ++i, ++frame) {
+                    const long sector = frame / kSamplesPerSector;
+                    const int expected = static_cast<int>(((sector + frame % kSamplesPerSector) % 128) * 128);
+                    if (samples[i * 2] != expected || samples[i * 2 + 1] != -expected) matches = false;
+                }
+                return true;
+            },
+            decoded,
+            decode_err),
+        decode_err.empty() ? "salvaged FLAC should decode" : decode_err);
+    expect_true(frame == 150L * kSamplesPerSector, "salvaged track should keep its length");
+    expect_true(matches, "salvaged track should hold the clean audio");
+    const auto tags = read_vorbis_comments(flac_path);
+    expect_true(tags.count("CDRIP_DAMAGED_SECTORS") == 0, "recovered tracks should not be tagged as damaged");
+
+    // The spool is kept until the last track was encoded from it.
+    expect_true(rip->salvage != nullptr, "the spool should be kept for the remaining tracks");
+    const auto last_path = (temp_dir / "salvage-3.flac").string();
+    options.output_path = last_path.c_str();
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[2], &entry, toc, progress_callback,
+            static_cast<int>(toc->tracks_count), 0.0, 4.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "last salvaged track should encode" : rip_err);
+    expect_true(rip->salvage == nullptr, "the spool should be released after the last track");
+    expect_size(150 + 150 + 32, static_cast<size_t>(state.read_calls), "the last track should not touch the drive");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_rip_track_sequential_read_continues_without_seek = []() {
+    auto state = make_backend_state();
+    state.tracks = {CdRipTrackInfo{1, 0, 149, 1}, CdRipTrackInfo{2, 150, 309, 1}};
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-sequential";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto first_path = (temp_dir / "01.flac").string();
+    const auto second_path = (temp_dir / "02.flac").string();
+
+    constexpr int kOffset = 30;
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, kOffset};
+    CdRip* rip = open_fake_rip(settings);
+    cdrip_set_sequential_read(rip, true);
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before sequential test");
+    release_error(err);
+
+    const auto entry = make_test_entry();
+    const int seeks_before = state.seek_calls;
+    for (size_t i = 0; i < 2; ++i) {
+        cdrip::detail::RipTrackWriteOptions options{};
+        options.output_path = i == 0 ? first_path.c_str() : second_path.c_str();
+        std::string rip_err;
+        expect_true(
+            cdrip::detail::rip_track_with_options(
+                rip, &toc->tracks[i], &entry, toc, nullptr,
+                static_cast<int>(toc->tracks_count), 0.0, 0.0, 0.0, &options, nullptr, rip_err),
+            rip_err.empty() ? "sequential rip should succeed" : rip_err);
+    }
+    expect_true(state.seek_calls - seeks_before == 1, "the second track should continue without a seek");
+    // One sector of look-ahead for the offset, then every sector once; nothing past the lead-out.
+    expect_size(310, static_cast<size_t>(state.read_calls), "no sector should be read twice");
+
+    // Track 2 starts exactly where track 1 stopped, shifted by the read offset.
+    const long track_frames = 160L * kSamplesPerSector;
+    long frame = 0;
+    bool matches = true;
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string decode_err;
+    expect_true(
+        cdrip::detail::decode_flac_file(
+            second_path,
+            true,
+            [&](const FLAC__int32* samples, size_t frames, unsigned, unsigned) {
+                for (size_t i = 0; i < frames; ++i, ++frame) {
+                    const long source = frame + kOffset;
+                    int expected = 0;
+                    if (source < track_frames) {
+                        const long sector = 150 + source / kSamplesPerSector;
+                        expected = static_cast<int>(((sector + source % kSamplesPerSector) % 128) * 128);
+                    }
+                    if (samples[i * 2] != expected || samples[i * 2 + 1] != -expected) matches = false;
+                }
+                return true;
+            },
+            decoded,
+            decode_err),
+        decode_err.empty() ? "sequential FLAC should decode" : decode_err);
+    expect_true(frame == track_frames, "sequential rip should keep the track length");
+    expect_true(matches, "sequential rip should stay gapless across the track boundary");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_rip_disc_image_embeds_cuesheet_and_track_tags = []() {
+    auto state = make_backend_state();
+    state.tracks = {CdRipTrackInfo{1, 0, 149, 1}, CdRipTrackInfo{2, 150, 309, 1}};
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-image";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "image.flac").string();
+
+    const CdRipSettings settings{"", 1, RIP_MODES_FAST, false, 0, 0};
+    CdRip* rip = open_fake_rip(settings);
+    const char* err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before image test");
+    release_error(err);
+
+    CdRipTrackInfo image_track{};
+    std::string image_err;
+    expect_true(cdrip::detail::build_disc_image_track(toc, image_track, image_err), image_err);
+    expect_true(image_track.start == 0 && image_track.end == 309, "image should span both audio tracks");
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    options.disc_image = true;
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &image_track, &entry, toc, nullptr, 1, 0.0, 0.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "image rip should succeed" : rip_err);
+    expect_size(310, static_cast<size_t>(state.read_calls), "image should read every sector once");
+
+    long frame = 0;
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string decode_err;
+    expect_true(
+        cdrip::detail::decode_flac_file(
+            flac_path,
+            true,
+            [&](const FLAC__int32*, size_t frames, unsigned, unsigned) {
+                frame += static_cast<long>(frames);
+                return true;
+            },
+            decoded,
+            decode_err),
+        decode_err.empty() ? "image FLAC should decode" : decode_err);
+    expect_true(frame == 310L * kSamplesPerSector, "image should hold the whole disc");
+
+    const auto tags = read_vorbis_comments(flac_path);
+    expect_eq("Fake Album", tags.at("TITLE"), "image title should be the album");
+    expect_eq("Fake Track 1", tags.at("CUE_TRACK01_TITLE"), "track titles should use the CUE convention");
+    expect_eq("Fake Track 2", tags.at("CUE_TRACK02_TITLE"), "track titles should use the CUE convention");
+    expect_true(tags.find("TRACKNUMBER") == tags.end(), "image should not carry a track number");
+    expect_true(tags.find("CUE_TRACK01_ARTIST") == tags.end(), "album-wide values should not repeat per track");
+    expect_true(tags.find(cdrip::detail::kAccurateRipV2TagKey) == tags.end(), "image should not carry per-track AccurateRip tags");
+
+    FLAC__StreamMetadata* cuesheet = nullptr;
+    expect_true(FLAC__metadata_get_cuesheet(flac_path.c_str(), &cuesheet), "image should embed a cue sheet");
+    const auto& cue = cuesheet->data.cue_sheet;
+    expect_size(3, cue.num_tracks, "cue sheet should list both tracks and the lead-out");
+    expect_true(cue.tracks[1].number == 2 && cue.tracks[1].offset == 150ULL * kSamplesPerSector,
+        "track 2 should start at its first sector");
+    expect_true(cue.tracks[2].number == 170 && cue.tracks[2].offset == 310ULL * kSamplesPerSector,
+        "lead-out should follow the last sector");
+    FLAC__metadata_object_delete(cuesheet);
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_rip_track_feeds_extra_outputs_from_one_read = []() {
+    auto state = make_backend_state();
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-outputs";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "main.flac").string();
+    const std::string base = temp_dir.string() + "/";
+
+    const CdRipSettings settings{"", 8, RIP_MODES_FAST, false, 0, 0};
+    CdRip* rip = open_fake_rip(settings);
+    const char* err = nullptr;
+    expect_true(cdrip_add_output(rip, CDRIP_OUTPUT_FLAC, (base + "{tracknumber:02d}-fast.flac").c_str(), 0, &err), "FLAC output should be accepted");
+    expect_true(cdrip_add_output(rip, CDRIP_OUTPUT_WAV, (base + "{tracknumber:02d}.wav").c_str(), 0, &err), "WAV output should be accepted");
+    expect_true(cdrip_add_output(rip, CDRIP_OUTPUT_AIFF, (base + "{tracknumber:02d}.aiff").c_str(), 0, &err), "AIFF output should be accepted");
+    expect_true(cdrip_add_output(rip, CDRIP_OUTPUT_RAW, (base + "{tracknumber:02d}.pcm").c_str(), 0, &err), "raw output should be accepted");
+    expect_true(!cdrip_add_output(rip, CDRIP_OUTPUT_FLAC, "x.flac", 9, &err), "FLAC level 9 should be rejected");
+    release_error(err);
+    err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "TOC build should succeed before outputs test");
+    release_error(err);
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[0], &entry, toc, nullptr,
+            static_cast<int>(toc->tracks_count), 0.0, 0.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "rip with extra outputs should succeed" : rip_err);
+    expect_size(150, static_cast<size_t>(state.read_calls), "extra outputs should not read the disc again");
+
+    const size_t pcm_bytes = 150U * CDIO_CD_FRAMESIZE_RAW;
+    auto read_file = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    };
+    const std::string raw = read_file(base + "01.pcm");
+    const std::string wav = read_file(base + "01.wav");
+    const std::string aiff = read_file(base + "01.aiff");
+    expect_size(pcm_bytes, raw.size(), "raw output should hold the track's PCM");
+    expect_size(44 + pcm_bytes, wav.size(), "WAV output should hold a header and the PCM");
+    expect_size(54 + pcm_bytes, aiff.size(), "AIFF output should hold a header and the PCM");
+    expect_true(wav.compare(0, 4, "RIFF") == 0 && wav.compare(44, std::string::npos, raw) == 0,
+        "WAV data should match the raw output");
+    // Sample 1 of sector 0 is 128 on the left channel: little-endian in WAV, big-endian in AIFF.
+    expect_true(raw[4] == static_cast<char>(0x80) && raw[5] == 0, "raw output should be little-endian");
+    expect_true(aiff.compare(0, 4, "FORM") == 0 && aiff[54 + 4] == 0 && aiff[54 + 5] == static_cast<char>(0x80),
+        "AIFF output should be big-endian");
+
+    long frame = 0;
+    bool matches = true;
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string decode_err;
+    expect_true(
+        cdrip::detail::decode_flac_file(
+            base + "01-fast.flac",
+            true,
+            [&](const FLAC__int32* samples, size_t frames, unsigned, unsigned) {
+                for (size_t i = 0; i < frames; ++i, ++frame) {
+                    const long sector = frame / kSamplesPerSector;
+                    const int expected = static_cast<int>(((sector + frame % kSamplesPerSector) % 128) * 128);
+                    if (samples[i * 2] != expected || samples[i * 2 + 1] != -expected) matches = false;
+                }
+                return true;
+            },
+            decoded,
+            decode_err),
+        decode_err.empty() ? "extra FLAC output should decode" : decode_err);
+    expect_true(frame == 150L * kSamplesPerSector && matches, "extra FLAC output should hold the same audio");
+    const auto main_tags = read_vorbis_comments(flac_path);
+    const auto extra_tags = read_vorbis_comments(base + "01-fast.flac");
+    expect_eq("Fake Track 1", extra_tags.at("TITLE"), "extra FLAC output should be tagged");
+    expect_eq(main_tags.at("PCM_CRC32"), extra_tags.at("PCM_CRC32"), "both FLACs should carry the same PCM CRC");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, false, &err);
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_output_sink_rewrites_header_for_frames_written = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-sink-header";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+
+    // The TOC promises 10 sectors, but only 4 arrive.
+    CdRipTrackInfo track{};
+    track.number = 1;
+    track.start = 0;
+    track.end = 9;
+    track.is_audio = 1;
+    const std::vector<int16_t> pcm(static_cast<size_t>(4) * kSamplesPerSector * 2, 0);
+    auto read_le32 = [](const std::string& bytes, size_t at) {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i) value = (value << 8) | static_cast<unsigned char>(bytes[at + i]);
+        return value;
+    };
+    auto read_be32 = [](const std::string& bytes, size_t at) {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value = (value << 8) | static_cast<unsigned char>(bytes[at + i]);
+        return value;
+    };
+
+    for (const auto kind : {CDRIP_OUTPUT_WAV, CDRIP_OUTPUT_AIFF}) {
+        cdrip::detail::OutputSinkConfig config{};
+        config.kind = kind;
+        const auto path = (temp_dir / (kind == CDRIP_OUTPUT_WAV ? "short.wav" : "short.aiff")).string();
+        std::string err;
+        {
+            cdrip::detail::OutputSink sink(config, path);
+            expect_true(sink.start({}, CdRipCoverArt{}, nullptr, track, false, err), err);
+            expect_true(sink.push(pcm.data(), pcm.size() / 2, err), err);
+            expect_true(sink.finish({}, err), err);
+            expect_true(sink.publish(err), err);
+        }
+        std::ifstream in(path, std::ios::binary);
+        const std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        const uint32_t data_bytes = 4U * CDIO_CD_FRAMESIZE_RAW;
+        if (kind == CDRIP_OUTPUT_WAV) {
+            expect_size(44 + data_bytes, bytes.size(), "WAV output should hold the frames written");
+            expect_true(read_le32(bytes, 4) == 36 + data_bytes, "RIFF size should follow the frames written");
+            expect_true(read_le32(bytes, 40) == data_bytes, "WAV data size should follow the frames written");
+        } else {
+            expect_size(54 + data_bytes, bytes.size(), "AIFF output should hold the frames written");
+            expect_true(read_be32(bytes, 22) == 4U * kSamplesPerSector, "AIFF frame count should follow the frames written");
+            expect_true(read_be32(bytes, 42) == 8 + data_bytes, "SSND size should follow the frames written");
+        }
+    }
+    std::filesystem::remove_all(temp_dir);
+};
+
+// Writes sectors of the fake disc's PCM, as a bare BIN or wrapped in a WAV header.
+auto write_image_pcm = [](
+    const std::filesystem::path& path,
+    long first_sector,
+    long sectors,
+    bool wav,
+    size_t trim_bytes = 0,
+    bool big_endian = false) {
+
+    std::string pcm;
+    for (long sector = first_sector; sector < first_sector + sectors; ++sector) {
+        for (int sample = 0; sample < kSamplesPerSector; ++sample) {
+            const int16_t left = static_cast<int16_t>(((sector + sample) % 128) * 128);
+            const int16_t values[2] = {left, static_cast<int16_t>(-left)};
+            for (const int16_t value : values) {
+                const char low = static_cast<char>(value & 0xff);
+                const char high = static_cast<char>((value >> 8) & 0xff);
+                pcm.push_back(big_endian ? high : low);
+                pcm.push_back(big_endian ? low : high);
+            }
+        }
+    }
+    pcm.resize(pcm.size() - trim_bytes);
+    std::ofstream out(path, std::ios::binary);
+    if (wav) {
+        auto le32 = [&](uint32_t v) { for (int i = 0; i < 4; ++i) out.put(static_cast<char>((v >> (i * 8)) & 0xff)); };
+        auto le16 = [&](uint16_t v) { out.put(static_cast<char>(v & 0xff)); out.put(static_cast<char>(v >> 8)); };
+        out.write("RIFF", 4);
+        le32(static_cast<uint32_t>(36 + pcm.size()));
+        out.write("WAVEfmt ", 8);
+        le32(16);
+        le16(1);
+        le16(2);
+        le32(44100);
+        le32(44100 * 4);
+        le16(4);
+        le16(16);
+        out.write("data", 4);
+        le32(static_cast<uint32_t>(pcm.size()));
+    }
+    out.write(pcm.data(), static_cast<std::streamsize>(pcm.size()));
+};
+
+auto test_image_backend_rips_bin_cue = []() {
+    // image:// devices must win over a swapped test backend.
+    auto state = make_backend_state();
+    FakeBackendScope scope(state);
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-bincue";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    write_image_pcm(temp_dir / "disc.bin", 0, 40, false);
+    {
+        std::ofstream cue(temp_dir / "disc.cue");
+        cue << "REM GENRE Test\n"
+            << "FILE \"disc.bin\" BINARY\n"
+            << "  TRACK 01 AUDIO\n"
+            << "    INDEX 01 00:00:00\n"
+            << "  TRACK 02 AUDIO\n"
+            << "    INDEX 00 00:00:15\n"
+            << "    INDEX 01 00:00:20\n";
+    }
+    const auto flac_path = (temp_dir / "track2.flac").string();
+
+    const std::string device = "image://" + (temp_dir / "disc.cue").string();
+    const CdRipSettings settings{"", 1, RIP_MODES_BEST, false, 0, 0};
+    const char* err = nullptr;
+    CdRip* rip = cdrip_open(device.c_str(), &settings, &err);
+    expect_true(rip != nullptr, err ? err : "image device should open");
+    release_error(err);
+    err = nullptr;
+    CdRipDiscToc* toc = cdrip_build_disc_toc(rip, &err);
+    expect_true(toc != nullptr, err ? err : "image TOC should build");
+    release_error(err);
+    expect_size(2, toc->tracks_count, "image should hold two tracks");
+    expect_true(toc->tracks[1].start == 20 && toc->tracks[1].end == 39, "track 2 should start at INDEX 01");
+    expect_size(0, static_cast<size_t>(state.read_calls), "image should not touch the swapped backend");
+
+    const auto entry = make_test_entry();
+    cdrip::detail::RipTrackWriteOptions options{};
+    options.output_path = flac_path.c_str();
+    std::string rip_err;
+    expect_true(
+        cdrip::detail::rip_track_with_options(
+            rip, &toc->tracks[1], &entry, toc, nullptr,
+            static_cast<int>(toc->tracks_count), 0.0, 0.0, 0.0, &options, nullptr, rip_err),
+        rip_err.empty() ? "image rip should succeed" : rip_err);
+
+    long frame = 0;
+    bool matches = true;
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string decode_err;
+    expect_true(
+        cdrip::detail::decode_flac_file(
+            flac_path,
+            true,
+            [&](const FLAC__int32* samples, size_t frames, unsigned, unsigned) {
+                for (size_t i = 0; i < frames; ++i, ++frame) {
+                    const long sector = 20 + frame / kSamplesPerSector;
+                    const int expected = static_cast<int>(((sector + frame % kSamplesPerSector) % 128) * 128);
+                    if (samples[i * 2] != expected || samples[i * 2 + 1] != -expected) matches = false;
+                }
+                return true;
+            },
+            decoded,
+            decode_err),
+        decode_err.empty() ? "image track should decode" : decode_err);
+    expect_true(frame == 20L * kSamplesPerSector && matches, "image track should hold the BIN's audio");
+
+    cdrip_release_disctoc(toc);
+    cdrip_close(rip, true, &err);
+    expect_true(err == nullptr, "closing an image should not try to eject");
+    release_error(err);
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_image_backend_lays_out_wav_tracks_and_gaps = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-wavcue";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    write_image_pcm(temp_dir / "01.wav", 0, 20, true);
+    // The last sector of track 2 is short by 100 stereo frames.
+    write_image_pcm(temp_dir / "02.wav", 20, 20, true, 400);
+    {
+        std::ofstream cue(temp_dir / "disc.cue");
+        cue << "FILE \"01.wav\" WAVE\n"
+            << "  TRACK 01 AUDIO\n"
+            << "    INDEX 01 00:00:00\n"
+            << "FILE \"02.wav\" WAVE\n"
+            << "  TRACK 02 AUDIO\n"
+            << "    PREGAP 00:00:05\n"
+            << "    INDEX 01 00:00:00\n";
+    }
+
+    const auto& backend = cdrip::detail::image_drive_backend();
+    void* drive = nullptr;
+    std::string err;
+    expect_true(backend.open_drive("image://" + (temp_dir / "disc.cue").string(), drive, err), err);
+    CdRipTrackInfo track{};
+    expect_true(backend.get_track_info(drive, 2, track, err), err);
+    expect_true(track.start == 25 && track.end == 44, "track 2 should start after its PREGAP");
+    long last_sector = 0;
+    expect_true(backend.get_disc_last_sector(drive, last_sector, err) && last_sector == 44, "image should end after track 2");
+
+    void* reader = nullptr;
+    expect_true(backend.create_reader(drive, RIP_MODES_BEST, reader, err), err);
+    CdRipReadStats stats{};
+    const int16_t* pcm = nullptr;
+    expect_true(backend.seek_reader(reader, 22, err) && backend.read_sector(reader, 0, pcm, stats, err), err);
+    expect_true(pcm[0] == 0 && pcm[kSamplesPerSector * 2 - 1] == 0, "PREGAP should read as silence");
+    expect_true(backend.seek_reader(reader, 25, err) && backend.read_sector(reader, 0, pcm, stats, err), err);
+    expect_true(pcm[2] == 21 * 128 && pcm[3] == -21 * 128, "track 2 should read its WAV from the first sector");
+    expect_true(backend.seek_reader(reader, 44, err) && backend.read_sector(reader, 0, pcm, stats, err), err);
+    const int last_full = kSamplesPerSector - 101;
+    expect_true(pcm[last_full * 2] == static_cast<int16_t>(((39 + last_full) % 128) * 128) &&
+        pcm[(last_full + 1) * 2] == 0,
+        "a short last sector should be padded with silence");
+    expect_true(!backend.read_sector(reader, 0, pcm, stats, err), "reads past the image should fail");
+    backend.destroy_reader(reader);
+    backend.close_drive(drive);
+
+    std::ofstream(temp_dir / "bad.cue") << "FILE \"01.wav\" AIFF\n  TRACK 01 AUDIO\n    INDEX 01 00:00:00\n";
+    expect_true(!backend.open_drive("image://" + (temp_dir / "bad.cue").string(), drive, err) && !err.empty(),
+        "unsupported FILE types should be reported");
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_image_backend_reads_motorola_and_checks_track_numbers = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-drive-backend-motorola";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+    write_image_pcm(temp_dir / "disc.bin", 0, 10, false, 0, true);
+    std::ofstream(temp_dir / "disc.cue") << "FILE \"disc.bin\" MOTOROLA\n  TRACK 01 AUDIO\n    INDEX 01 00:00:00\n";
+
+    const auto& backend = cdrip::detail::image_drive_backend();
+    void* drive = nullptr;
+    std::string err;
+    expect_true(backend.open_drive("image://" + (temp_dir / "disc.cue").string(), drive, err), err);
+    void* reader = nullptr;
+    expect_true(backend.create_reader(drive, RIP_MODES_BEST, reader, err), err);
+    CdRipReadStats stats{};
+    const int16_t* pcm = nullptr;
+    expect_true(backend.seek_reader(reader, 3, err) && backend.read_sector(reader, 0, pcm, stats, err), err);
+    // Sample 1 of sector 3 is 4 * 128 on the left channel; swapped bytes would read as 2.
+    expect_true(pcm[2] == 4 * 128 && pcm[3] == -4 * 128, "MOTOROLA samples should be byte-swapped to host order");
+    backend.destroy_reader(reader);
+    backend.close_drive(drive);
+
+    // Track numbers that skip or repeat cannot be looked up by number.
+    std::ofstream(temp_dir / "gap.cue") << "FILE \"disc.bin\" MOTOROLA\n"
+                                        << "  TRACK 01 AUDIO\n    INDEX 01 00:00:00\n"
+                                        << "  TRACK 03 AUDIO\n    INDEX 01 00:00:05\n";
+    expect_true(!backend.open_drive("image://" + (temp_dir / "gap.cue").string(), drive, err) &&
+        err.find("out of sequence") != std::string::npos,
+        "out of sequence track numbers should be reported");
+    std::filesystem::remove_all(temp_dir);
+};
+
 }  // namespace
 
 int main() {
@@ -825,5 +1888,22 @@ int main() {
     test_close_reports_eject_failure_after_cleanup();
     test_rip_track_skips_non_audio_without_reads();
     test_rip_track_emits_progress_updates();
+    test_adaptive_compression_level_follows_encoder_headroom();
+    test_resolve_encoder_threads_follows_drive_speed();
+    test_rip_track_reports_adaptive_compression_level();
+    test_rip_track_applies_read_offset();
+    test_rip_track_verify_mode_rereads_mismatching_ranges();
+    test_rip_track_hybrid_mode_escalates_around_errors();
+    test_read_telemetry_buckets_sector_times();
+    test_rip_track_collects_read_telemetry();
+    test_rip_track_read_budget_replaces_damaged_sectors();
+    test_salvage_disc_retries_only_damaged_ranges();
+    test_rip_track_sequential_read_continues_without_seek();
+    test_rip_disc_image_embeds_cuesheet_and_track_tags();
+    test_rip_track_feeds_extra_outputs_from_one_read();
+    test_output_sink_rewrites_header_for_frames_written();
+    test_image_backend_rips_bin_cue();
+    test_image_backend_lays_out_wav_tracks_and_gaps();
+    test_image_backend_reads_motorola_and_checks_track_numbers();
     return 0;
 }
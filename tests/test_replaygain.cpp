@@ -1,3 +1,4 @@
+#include <cmath>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
@@ -94,6 +95,40 @@ auto write_test_flac = [](
     FLAC__metadata_object_delete(vorbis);
 };
 
+auto write_tone_flac = [](
+    const std::string& path,
+    const std::map<std::string, std::string>& tags,
+    double amplitude) {
+
+    // One second of 1 kHz, long enough for the loudness gate.
+    constexpr unsigned int kToneSamples = kSampleRate;
+    FLAC::Encoder::File encoder;
+    encoder.set_verify(false);
+    encoder.set_compression_level(1);
+    encoder.set_channels(kChannels);
+    encoder.set_bits_per_sample(16);
+    encoder.set_sample_rate(kSampleRate);
+    encoder.set_total_samples_estimate(kToneSamples);
+
+    FLAC__StreamMetadata* vorbis = cdrip::detail::build_vorbis_comments(tags);
+    expect_true(vorbis != nullptr, "Vorbis block should be created");
+    std::vector<FLAC__StreamMetadata*> blocks{vorbis};
+    encoder.set_metadata(blocks.data(), static_cast<unsigned>(blocks.size()));
+    expect_true(
+        encoder.init(path.c_str()) == FLAC__STREAM_ENCODER_INIT_STATUS_OK,
+        "FLAC encoder should initialize");
+
+    std::vector<FLAC__int32> channel(kToneSamples);
+    for (unsigned int i = 0; i < kToneSamples; ++i) {
+        channel[i] = static_cast<FLAC__int32>(
+            amplitude * 32767.0 * std::sin(2.0 * M_PI * 1000.0 * i / kSampleRate));
+    }
+    const FLAC__int32* pcm[] = {channel.data(), channel.data()};
+    expect_true(encoder.process(pcm, kToneSamples), "FLAC encoder should accept PCM");
+    expect_true(encoder.finish(), "FLAC encoder should finish");
+    FLAC__metadata_object_delete(vorbis);
+};
+
 auto make_test_toc = []() {
     static CdRipTrackInfo tracks[] = {
         CdRipTrackInfo{1, 0, 14999, 1},
@@ -235,11 +270,56 @@ auto test_update_flac_tags_overrides_replaygain_values = []() {
     std::filesystem::remove_all(temp_dir);
 };
 
+auto test_scan_album_replaygain_tags_existing_files = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-replaygain-scan";
+    std::filesystem::create_directories(temp_dir);
+    const auto loud_path = (temp_dir / "01.flac").string();
+    const auto quiet_path = (temp_dir / "02.flac").string();
+    write_tone_flac(loud_path, {{"TITLE", "Loud"}, {"ARTIST", "Keep Me"}}, 0.5);
+    write_tone_flac(quiet_path, {{"TITLE", "Quiet"}}, 0.05);
+
+    std::vector<cdrip::detail::ReplayGainScanResult> tracks;
+    cdrip::detail::ReplayGainScanResult album{};
+    std::string err;
+    expect_true(
+        cdrip::detail::scan_album_replaygain({loud_path, quiet_path}, tracks, album, err),
+        err.empty() ? "album scan should succeed" : err);
+    expect_true(tracks.size() == 2, "every track should be measured");
+    expect_true(tracks[0].loudness_lufs > tracks[1].loudness_lufs, "louder tone should measure louder");
+    expect_true(album.peak >= tracks[0].peak, "album peak should cover every track");
+
+    bool changed = false;
+    expect_true(
+        cdrip::detail::update_flac_tags(
+            loud_path, nullptr, 0, nullptr,
+            cdrip::detail::build_replaygain_tags(tracks[0], album),
+            /*preserve_replaygain_tags=*/false, err, /*dry_run=*/false, &changed),
+        err.empty() ? "ReplayGain merge should succeed" : err);
+    expect_true(changed, "new ReplayGain tags should change the file");
+
+    const auto tags = read_vorbis_comments(loud_path);
+    expect_eq("Loud", tags.at("TITLE"), "existing title should be kept");
+    expect_eq("Keep Me", tags.at("ARTIST"), "existing artist should be kept");
+    expect_true(tags.count("REPLAYGAIN_TRACK_GAIN") == 1, "track gain should be written");
+    expect_true(tags.count("REPLAYGAIN_ALBUM_PEAK") == 1, "album peak should be written");
+
+    expect_true(
+        cdrip::detail::update_flac_tags(
+            loud_path, nullptr, 0, nullptr,
+            cdrip::detail::build_replaygain_tags(tracks[0], album),
+            /*preserve_replaygain_tags=*/false, err, /*dry_run=*/false, &changed),
+        err.empty() ? "repeated merge should succeed" : err);
+    expect_true(!changed, "identical ReplayGain tags should leave the file alone");
+
+    std::filesystem::remove_all(temp_dir);
+};
+
 }
 
 int main() {
     test_build_replaygain_tags_formats_values();
     test_update_mode_preserves_existing_replaygain_tags();
     test_update_flac_tags_overrides_replaygain_values();
+    test_scan_album_replaygain_tags_existing_files();
     return 0;
 }
@@ -98,11 +98,28 @@ auto test_print_rip_progress_line_uses_completed_rendering = []() {
     expect_true(!rendered.empty() && rendered.back() == '\n', "completed printing should terminate the line");
 };
 
+auto test_build_rip_progress_line_shows_adaptive_compression_level = []() {
+    CdRipProgressInfo info{};
+    info.track_number = 5;
+    info.total_tracks = 25;
+    info.percent = 45.0;
+    info.track_name = "PLANET BLUE";
+    info.compression_level = 7;
+
+    const std::string fixed = build_rip_progress_line(make_rip_progress_snapshot(info), '/', false);
+    expect_not_contains(" L7", fixed, "fixed compression should not be shown");
+
+    info.compression_adaptive = 1;
+    const std::string adaptive = build_rip_progress_line(make_rip_progress_snapshot(info), '/', false);
+    expect_contains("] L7: \"PLANET BLUE\"", adaptive, "adaptive compression level should be shown");
+};
+
 }  // namespace
 
 int main() {
     test_build_rip_progress_line_keeps_inflight_spinner_state();
     test_build_rip_progress_line_marks_completion_with_checkmark();
     test_print_rip_progress_line_uses_completed_rendering();
+    test_build_rip_progress_line_shows_adaptive_compression_level();
     return 0;
 }
@@ -0,0 +1,129 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <glib.h>
+
+#include "../src/cdrip/internal.h"
+
+using cdrip::detail::get_scan_index_path;
+using cdrip::detail::load_scan_index;
+using cdrip::detail::save_scan_index;
+using cdrip::detail::ScanIndex;
+using cdrip::detail::ScanIndexEntry;
+using cdrip::detail::stat_scan_identity;
+
+namespace {
+
+auto expect_true = [](
+    bool condition,
+    const std::string& message) {
+
+    if (!condition) {
+        std::cerr << "assert_true failed: " << message << "\n";
+        std::exit(1);
+    }
+};
+
+auto expect_eq = [](
+    const std::string& expected,
+    const std::string& actual,
+    const std::string& message) {
+
+    if (expected != actual) {
+        std::cerr << "assert_eq failed: " << message << "\n";
+        std::cerr << "  expected: " << expected << "\n";
+        std::cerr << "  actual:   " << actual << "\n";
+        std::exit(1);
+    }
+};
+
+auto test_round_trip_preserves_entries = [](const std::filesystem::path& dir) {
+    const std::string index_path = (dir / "nested" / "scan_index").string();
+
+    ScanIndex index;
+    ScanIndexEntry entry{};
+    entry.size = 123456789;
+    entry.mtime_ns = 1700000000123456789LL;
+    entry.inode = 42;
+    entry.tags["CDDB_DISCID"] = "a50ab10c";
+    entry.tags["CDDB_OFFSETS"] = "150,20000\t30000";
+    entry.tags["TRACKNUMBER"] = "1\\n";
+    index["/music/A\tB/01\n.flac"] = entry;
+    index["/music/plain.flac"] = ScanIndexEntry{};
+
+    std::string err;
+    expect_true(save_scan_index(index_path, index, err), "index should be saved: " + err);
+
+    ScanIndex loaded;
+    expect_true(load_scan_index(index_path, loaded), "index should be loaded");
+    expect_true(loaded.size() == 2, "all entries should be loaded");
+    const auto it = loaded.find("/music/A\tB/01\n.flac");
+    expect_true(it != loaded.end(), "escaped path should round trip");
+    expect_true(it->second.size == entry.size, "size should round trip");
+    expect_true(it->second.mtime_ns == entry.mtime_ns, "mtime should round trip");
+    expect_true(it->second.inode == entry.inode, "inode should round trip");
+    expect_eq("150,20000\t30000", it->second.tags["CDDB_OFFSETS"], "tab in value should round trip");
+    expect_eq("1\\n", it->second.tags["TRACKNUMBER"], "backslash in value should round trip");
+    expect_true(loaded["/music/plain.flac"].tags.empty(), "entry without tags should round trip");
+};
+
+auto test_unknown_format_is_ignored = [](const std::filesystem::path& dir) {
+    const auto index_path = dir / "foreign_index";
+    std::ofstream(index_path) << "something else\n/x.flac\t1\t2\t3\n";
+    ScanIndex loaded;
+    expect_true(!load_scan_index(index_path.string(), loaded), "foreign file should not load");
+    expect_true(loaded.empty(), "foreign file should yield an empty index");
+    expect_true(!load_scan_index((dir / "missing").string(), loaded), "missing file should not load");
+};
+
+auto test_identity_tracks_file_changes = [](const std::filesystem::path& dir) {
+    const auto file = dir / "track.flac";
+    std::ofstream(file) << "abc";
+    ScanIndexEntry before{};
+    expect_true(stat_scan_identity(file.string(), before), "identity should be read");
+    expect_true(before.size == 3, "size should match the file");
+
+    std::ofstream(file, std::ios::app) << "def";
+    ScanIndexEntry after{};
+    expect_true(stat_scan_identity(file.string(), after), "identity should be read again");
+    expect_true(after.size == 6, "size should follow the append");
+    expect_true(after.inode == before.inode, "inode should be stable");
+    expect_true(!stat_scan_identity((dir / "missing.flac").string(), after), "missing file has no identity");
+
+    gchar* uri = g_filename_to_uri(file.string().c_str(), nullptr, nullptr);
+    expect_true(uri != nullptr, "file URI should be built");
+    ScanIndexEntry via_gio{};
+    expect_true(stat_scan_identity(uri, via_gio), "identity should be read through GIO");
+    g_free(uri);
+    expect_true(via_gio.size == after.size, "GIO size should match stat");
+    expect_true(via_gio.inode == after.inode, "GIO inode should match stat");
+    expect_true(via_gio.mtime_ns / 1000 == after.mtime_ns / 1000, "GIO mtime should match stat (usec)");
+};
+
+auto test_setter_controls_path = []() {
+    cdrip_set_scan_index("/tmp/index");
+    expect_eq("/tmp/index", get_scan_index_path(), "configured path should be returned");
+    cdrip_set_scan_index(nullptr);
+    expect_true(get_scan_index_path().empty(), "null should disable the index");
+};
+
+}  // namespace
+
+int main() {
+    gchar* tmp = g_dir_make_tmp("cdrip-scan-index-XXXXXX", nullptr);
+    expect_true(tmp != nullptr, "temp directory should be created");
+    const std::filesystem::path root(tmp);
+    g_free(tmp);
+
+    test_round_trip_preserves_entries(root);
+    test_unknown_format_is_ignored(root);
+    test_identity_tracks_file_changes(root);
+    test_setter_controls_path();
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    return 0;
+}
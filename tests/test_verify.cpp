@@ -0,0 +1,467 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <FLAC++/encoder.h>
+
+#include "../src/cdrip/internal.h"
+
+namespace {
+
+constexpr unsigned int kChannels = 2;
+constexpr unsigned int kSampleRate = 44100;
+constexpr unsigned int kSamples = 4096;
+
+auto expect_true = [](
+    bool condition,
+    const std::string& message) {
+
+    if (!condition) {
+        std::cerr << "assert_true failed: " << message << "\n";
+        std::exit(1);
+    }
+};
+
+auto expect_eq = [](
+    const std::string& expected,
+    const std::string& actual,
+    const std::string& message) {
+
+    if (expected != actual) {
+        std::cerr << "assert_eq failed: " << message << "\n";
+        std::cerr << "  expected: " << expected << "\n";
+        std::cerr << "  actual:   " << actual << "\n";
+        std::exit(1);
+    }
+};
+
+auto make_pcm = []() {
+    std::vector<int16_t> pcm(kSamples * kChannels);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>((i * 7919) % 65536 - 32768);
+    }
+    return pcm;
+};
+
+auto write_test_flac = [](
+    const std::string& path,
+    const std::vector<int16_t>& pcm,
+    const std::map<std::string, std::string>& tags) {
+
+    FLAC::Encoder::File encoder;
+    encoder.set_verify(false);
+    encoder.set_compression_level(1);
+    encoder.set_channels(kChannels);
+    encoder.set_bits_per_sample(16);
+    encoder.set_sample_rate(kSampleRate);
+    encoder.set_total_samples_estimate(kSamples);
+
+    FLAC__StreamMetadata* vorbis = cdrip::detail::build_vorbis_comments(tags);
+    expect_true(vorbis != nullptr, "Vorbis block should be created");
+    std::vector<FLAC__StreamMetadata*> blocks{vorbis};
+    encoder.set_metadata(blocks.data(), static_cast<unsigned>(blocks.size()));
+    expect_true(
+        encoder.init(path.c_str()) == FLAC__STREAM_ENCODER_INIT_STATUS_OK,
+        "FLAC encoder should initialize");
+
+    std::vector<FLAC__int32> interleaved(pcm.begin(), pcm.end());
+    expect_true(
+        encoder.process_interleaved(interleaved.data(), kSamples),
+        "FLAC encoder should accept PCM");
+    expect_true(encoder.finish(), "FLAC encoder should finish");
+    FLAC__metadata_object_delete(vorbis);
+};
+
+// 160x4 solid RGB PNG, wider than the 128px track thumbnail.
+const uint8_t kCoverPng[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x04, 0x08, 0x02, 0x00, 0x00, 0x00, 0x86, 0x20, 0xa3,
+    0x82, 0x00, 0x00, 0x00, 0x1e, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x38, 0xa1, 0xa1, 0x31,
+    0x8a, 0x86, 0x31, 0x62, 0x18, 0x0d, 0x82, 0xd1, 0x08, 0x1e, 0x45, 0xa3, 0x11, 0x3c, 0x8a, 0x06,
+    0x2b, 0x02, 0x00, 0xa9, 0xbc, 0xbc, 0x1f, 0xfb, 0x11, 0xd2, 0xa3, 0x00, 0x00, 0x00, 0x00, 0x49,
+    0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+auto read_picture_widths = [](
+    const std::string& path) {
+
+    std::vector<unsigned> widths;
+    FLAC__Metadata_Chain* chain = FLAC__metadata_chain_new();
+    expect_true(chain != nullptr, "FLAC chain should be created");
+    expect_true(FLAC__metadata_chain_read(chain, path.c_str()), "FLAC file should open");
+    FLAC__Metadata_Iterator* it = FLAC__metadata_iterator_new();
+    expect_true(it != nullptr, "FLAC iterator should be created");
+    FLAC__metadata_iterator_init(it, chain);
+    do {
+        const FLAC__StreamMetadata* block = FLAC__metadata_iterator_get_block(it);
+        if (block && block->type == FLAC__METADATA_TYPE_PICTURE) {
+            widths.push_back(block->data.picture.width);
+        }
+    } while (FLAC__metadata_iterator_next(it));
+    FLAC__metadata_iterator_delete(it);
+    FLAC__metadata_chain_delete(chain);
+    return widths;
+};
+
+auto test_crc_matches_reference_vector = []() {
+    // "12345678" as little-endian 16-bit samples; the value matches zlib's crc32.
+    const int16_t samples[] = {0x3231, 0x3433, 0x3635, 0x3837};
+    const uint32_t crc = cdrip::detail::update_pcm_crc32(0, samples, 4);
+    expect_eq("9AE0DAAF", cdrip::detail::format_pcm_crc32(crc), "CRC of \"12345678\" should match");
+
+    const auto pcm = make_pcm();
+    const uint32_t whole = cdrip::detail::update_pcm_crc32(0, pcm.data(), pcm.size());
+    uint32_t chunked = cdrip::detail::update_pcm_crc32(0, pcm.data(), 100);
+    chunked = cdrip::detail::update_pcm_crc32(chunked, pcm.data() + 100, pcm.size() - 100);
+    expect_true(whole == chunked, "CRC should not depend on chunking");
+};
+
+auto test_accuraterip_checksum_matches_reference = []() {
+    const auto pcm = make_pcm();
+    auto reference = [&pcm](uint64_t from, uint64_t to, uint32_t& v1, uint32_t& v2) {
+        v1 = 0;
+        v2 = 0;
+        for (uint64_t i = 0; i < kSamples; ++i) {
+            const uint64_t position = i + 1;
+            if (position < from || position > to) continue;
+            const uint32_t frame = static_cast<uint16_t>(pcm[i * 2]) |
+                (static_cast<uint32_t>(static_cast<uint16_t>(pcm[i * 2 + 1])) << 16);
+            const uint64_t product = static_cast<uint64_t>(frame) * position;
+            v1 += static_cast<uint32_t>(product);
+            v2 += static_cast<uint32_t>(product) + static_cast<uint32_t>(product >> 32);
+        }
+    };
+
+    uint32_t v1 = 0;
+    uint32_t v2 = 0;
+    cdrip::detail::AccurateRipChecksum middle{};
+    cdrip::detail::begin_accuraterip_checksum(middle, kSamples, false, false);
+    cdrip::detail::update_accuraterip_checksum(middle, pcm.data(), 1000);
+    cdrip::detail::update_accuraterip_checksum(middle, pcm.data() + 2000, kSamples - 1000);
+    reference(1, kSamples, v1, v2);
+    expect_true(middle.v1 == v1 && middle.v2 == v2, "middle track checksums should cover every frame");
+
+    cdrip::detail::AccurateRipChecksum first{};
+    cdrip::detail::begin_accuraterip_checksum(first, kSamples, true, false);
+    cdrip::detail::update_accuraterip_checksum(first, pcm.data(), kSamples);
+    reference(5 * 588, kSamples, v1, v2);
+    expect_true(first.v1 == v1 && first.v2 == v2, "first track should skip its first five sectors");
+    expect_true(first.v1 != middle.v1, "skipping frames should change the checksum");
+};
+
+auto test_accuraterip_database_lookup = []() {
+    static CdRipTrackInfo tracks[] = {
+        CdRipTrackInfo{1, 0, 14999, 1},
+        CdRipTrackInfo{2, 15000, 29999, 1},
+    };
+    CdRipDiscToc toc{};
+    toc.cddb_discid = "0a01c402";
+    toc.leadout_sector = 30000;
+    toc.tracks = tracks;
+    toc.tracks_count = 2;
+
+    cdrip::detail::AccurateRipDiscIds ids{};
+    expect_true(cdrip::detail::compute_accuraterip_disc_ids(&toc, ids), "disc ids should be computed");
+    expect_true(ids.id1 == 0 + 15000 + 30000, "id1 should sum the track offsets and lead-out");
+    expect_true(ids.id2 == 1 * 1 + 15000 * 2 + 30000 * 3, "id2 should weight offsets by track number");
+    expect_eq(
+        "8/c/f/dBAR-002-0000afc8-0001d4c1-0a01c402.bin",
+        cdrip::detail::accuraterip_db_relative_path(ids),
+        "database path should follow the AccurateRip layout");
+
+    auto put32 = [](std::vector<uint8_t>& out, uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+    };
+    std::vector<uint8_t> db;
+    for (const uint32_t track2_crc : {0x11111111u, 0x22222222u}) {
+        db.push_back(2);
+        put32(db, ids.id1);
+        put32(db, ids.id2);
+        put32(db, ids.cddb);
+        db.push_back(7);
+        put32(db, 0xCAFEBABEu);
+        put32(db, 0);
+        db.push_back(3);
+        put32(db, track2_crc);
+        put32(db, 0);
+    }
+
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-verify-accuraterip";
+    std::filesystem::create_directories(temp_dir);
+    {
+        std::ofstream out(temp_dir / "dBAR-002-0000afc8-0001d4c1-0a01c402.bin", std::ios::binary);
+        out.write(reinterpret_cast<const char*>(db.data()), static_cast<std::streamsize>(db.size()));
+    }
+    cdrip_set_accuraterip_database(temp_dir.string().c_str());
+
+    cdrip::detail::AccurateRipChecksum checksum{};
+    checksum.v1 = 0x01234567u;
+    checksum.v2 = 0xCAFEBABEu;
+    std::string result;
+    expect_true(cdrip::detail::check_accuraterip(&toc, 0, checksum, result), "lookup should run");
+    expect_eq("verified v2 (confidence 14)", result, "both pressings should add confidence");
+    checksum.v2 = 0;
+    checksum.v1 = 0x22222222u;
+    cdrip::detail::check_accuraterip(&toc, 1, checksum, result);
+    expect_eq("verified v1 (confidence 3)", result, "v1 checksums should still match");
+    checksum.v1 = 0;
+    cdrip::detail::check_accuraterip(&toc, 1, checksum, result);
+    expect_eq("mismatch (2 submission(s))", result, "unknown checksums should be a mismatch");
+
+    toc.cddb_discid = "0a01c403";
+    cdrip::detail::check_accuraterip(&toc, 0, checksum, result);
+    expect_eq("not in database", result, "discs without a file should not be found");
+
+    cdrip_set_accuraterip_database(nullptr);
+    expect_true(!cdrip::detail::check_accuraterip(&toc, 0, checksum, result), "lookups should stop when disabled");
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_decode_checks_md5_and_crc = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-verify";
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "track.flac").string();
+    const auto pcm = make_pcm();
+    write_test_flac(flac_path, pcm, {{"TITLE", "Verify"}});
+
+    uint32_t crc = 0;
+    std::vector<int16_t> pcm16;
+    const cdrip::detail::FlacPcmSink sink = [&](const FLAC__int32* samples, size_t frames, unsigned channels, unsigned bits_per_sample) {
+        expect_true(bits_per_sample == 16, "test file should be 16-bit");
+        pcm16.assign(samples, samples + frames * channels);
+        crc = cdrip::detail::update_pcm_crc32(crc, pcm16.data(), pcm16.size());
+        return true;
+    };
+    cdrip::detail::FlacDecodeResult decoded{};
+    std::string err;
+    expect_true(cdrip::detail::decode_flac_file(flac_path, true, sink, decoded, err), err);
+    expect_true(decoded.md5_checked && decoded.md5_ok, "STREAMINFO MD5 should match");
+    expect_true(decoded.decoded_samples == kSamples, "every sample should be decoded");
+    expect_true(
+        crc == cdrip::detail::update_pcm_crc32(0, pcm.data(), pcm.size()),
+        "decoded PCM CRC should match the source PCM");
+
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_metadata_refresh_keeps_crc_tag = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-verify-refresh";
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "track.flac").string();
+    write_test_flac(flac_path, make_pcm(), {{"TITLE", "Old"}, {"PCM_CRC32", "0123ABCD"}});
+
+    static CdRipTrackInfo tracks[] = {
+        CdRipTrackInfo{1, 0, 14999, 1},
+    };
+    CdRipDiscToc toc{};
+    toc.cddb_discid = "deadbeef";
+    toc.tracks = tracks;
+    toc.tracks_count = 1;
+    static CdRipTagKV album_tags[] = {
+        CdRipTagKV{"ALBUM", "New Album"},
+    };
+    CdRipCddbEntry entry{};
+    entry.cddb_discid = "deadbeef";
+    entry.album_tags = album_tags;
+    entry.album_tags_count = 1;
+
+    std::string err;
+    expect_true(
+        cdrip::detail::update_flac_tags(flac_path, &toc, 1, &entry, {}, false, err),
+        err.empty() ? "update should succeed" : err);
+
+    std::map<std::string, std::string> tags;
+    expect_true(cdrip::detail::read_flac_vorbis_tags(flac_path, tags), "tags should be readable");
+    expect_eq("New Album", tags["ALBUM"], "metadata should be refreshed");
+    expect_eq("0123ABCD", tags["PCM_CRC32"], "PCM checksum should survive the refresh");
+
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_update_skips_unchanged_files_and_dry_runs = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-verify-update";
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "track.flac").string();
+    write_test_flac(flac_path, make_pcm(), {{"TITLE", "Old"}});
+    auto read_file = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    };
+
+    static CdRipTrackInfo tracks[] = {
+        CdRipTrackInfo{1, 0, 14999, 1},
+    };
+    CdRipDiscToc toc{};
+    toc.cddb_discid = "deadbeef";
+    toc.tracks = tracks;
+    toc.tracks_count = 1;
+    static CdRipTagKV album_tags[] = {
+        CdRipTagKV{"ALBUM", "New Album"},
+    };
+    CdRipCddbEntry entry{};
+    entry.cddb_discid = "deadbeef";
+    entry.album_tags = album_tags;
+    entry.album_tags_count = 1;
+    CdRipTaggedToc tagged{};
+    tagged.path = flac_path.c_str();
+    tagged.toc = &toc;
+    tagged.track_number = 1;
+    tagged.valid = 1;
+
+    // A dry run reports the change but leaves the file alone.
+    const std::string before = read_file(flac_path);
+    const auto old_time = std::filesystem::last_write_time(flac_path) - std::chrono::hours(1);
+    std::filesystem::last_write_time(flac_path, old_time);
+    const char* err = nullptr;
+    expect_true(
+        cdrip_update_flac_with_cddb_entry_ex(&tagged, &entry, 1, &err) == CDRIP_UPDATE_CHANGED,
+        "dry run should report the change");
+    cdrip_release_error(err);
+    expect_true(read_file(flac_path) == before, "dry run should not modify the file");
+    expect_true(std::filesystem::last_write_time(flac_path) == old_time, "dry run should keep the mtime");
+
+    err = nullptr;
+    expect_true(
+        cdrip_update_flac_with_cddb_entry_ex(&tagged, &entry, 0, &err) == CDRIP_UPDATE_CHANGED,
+        "first update should write the tags");
+    cdrip_release_error(err);
+    std::map<std::string, std::string> tags;
+    expect_true(cdrip::detail::read_flac_vorbis_tags(flac_path, tags), "tags should be readable");
+    expect_eq("New Album", tags["ALBUM"], "first update should write the album");
+
+    // The same update again finds nothing to write and keeps the file untouched.
+    const std::string updated = read_file(flac_path);
+    std::filesystem::last_write_time(flac_path, old_time);
+    err = nullptr;
+    expect_true(
+        cdrip_update_flac_with_cddb_entry_ex(&tagged, &entry, 0, &err) == CDRIP_UPDATE_UNCHANGED,
+        "identical update should report unchanged");
+    cdrip_release_error(err);
+    expect_true(read_file(flac_path) == updated, "unchanged update should not rewrite the file");
+    expect_true(std::filesystem::last_write_time(flac_path) == old_time, "unchanged update should keep the mtime");
+
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_cover_art_embed_modes = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-verify-embed";
+    std::filesystem::remove_all(temp_dir);
+    std::filesystem::create_directories(temp_dir);
+
+    static CdRipTrackInfo tracks[] = {
+        CdRipTrackInfo{1, 0, 14999, 1},
+    };
+    CdRipDiscToc toc{};
+    toc.cddb_discid = "deadbeef";
+    toc.tracks = tracks;
+    toc.tracks_count = 1;
+    CdRipCddbEntry entry{};
+    entry.cddb_discid = "deadbeef";
+    entry.cover_art.data = kCoverPng;
+    entry.cover_art.size = sizeof(kCoverPng);
+    entry.cover_art.mime_type = "image/png";
+    entry.cover_art.is_front = 1;
+
+    struct Case {
+        CdRipCoverArtEmbedModes mode;
+        const char* name;
+        std::vector<unsigned> widths;
+    };
+    const Case cases[] = {
+        {CDRIP_COVER_ART_EMBED_FULL, "full", {160}},
+        {CDRIP_COVER_ART_EMBED_THUMBNAIL, "thumbnail", {128}},
+        {CDRIP_COVER_ART_EMBED_NONE, "none", {}},
+    };
+    for (const auto& c : cases) {
+        const auto album_dir = temp_dir / c.name;
+        std::filesystem::create_directories(album_dir);
+        const auto flac_path = (album_dir / "01.flac").string();
+        write_test_flac(flac_path, make_pcm(), {{"TITLE", "Track"}});
+
+        cdrip_set_cover_art_embed_mode(c.mode);
+        CdRipTaggedToc tagged{};
+        tagged.path = flac_path.c_str();
+        tagged.toc = &toc;
+        tagged.track_number = 1;
+        tagged.valid = 1;
+        const char* err = nullptr;
+        const int result = cdrip_update_flac_with_cddb_entry_ex(&tagged, &entry, 0, &err);
+        expect_true(result == CDRIP_UPDATE_CHANGED, std::string(c.name) + ": update should succeed: " + (err ? err : ""));
+        cdrip_release_error(err);
+
+        const auto widths = read_picture_widths(flac_path);
+        expect_true(widths == c.widths, std::string(c.name) + ": unexpected PICTURE blocks");
+
+        // The album cover file is written in every mode, always at full size.
+        const std::string cover_path = cdrip::detail::resolve_album_cover_path(flac_path);
+        expect_eq((album_dir / "cover.png").string(), cover_path, std::string(c.name) + ": cover sits next to the track");
+        std::string cover_err;
+        expect_true(
+            cdrip::detail::publish_album_cover_file(entry.cover_art, cover_path, cover_err),
+            std::string(c.name) + ": cover file should be written: " + cover_err);
+        std::ifstream in(cover_path, std::ios::binary);
+        const std::string cover{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        expect_true(
+            cover == std::string(reinterpret_cast<const char*>(kCoverPng), sizeof(kCoverPng)),
+            std::string(c.name) + ": cover file should hold the album art");
+    }
+    cdrip_set_cover_art_embed_mode(CDRIP_COVER_ART_EMBED_FULL);
+
+    std::filesystem::remove_all(temp_dir);
+};
+
+auto test_recompress_keeps_audio_and_tags = []() {
+    const auto temp_dir = std::filesystem::temp_directory_path() / "cdrip-test-verify-recompress";
+    std::filesystem::create_directories(temp_dir);
+    const auto flac_path = (temp_dir / "track.flac").string();
+    const auto pcm = make_pcm();
+    write_test_flac(flac_path, pcm, {{"TITLE", "Recompress"}, {"PCM_CRC32", "0123ABCD"}});
+
+    cdrip::detail::FlacRecompressResult result{};
+    std::string err;
+    expect_true(!cdrip::detail::recompress_flac_file(flac_path, 9, false, result, err), "level 9 should be rejected");
+    expect_true(cdrip::detail::recompress_flac_file(flac_path, 8, false, result, err), err);
+    expect_true(result.original_bytes > 0 && result.recompressed_bytes > 0, "sizes should be reported");
+    expect_true(result.replaced == (result.recompressed_bytes < result.original_bytes), "only smaller files replace");
+
+    std::map<std::string, std::string> tags;
+    expect_true(cdrip::detail::read_flac_vorbis_tags(flac_path, tags), "tags should be readable");
+    expect_eq("Recompress", tags["TITLE"], "tags should survive recompression");
+    expect_eq("0123ABCD", tags["PCM_CRC32"], "PCM checksum should survive recompression");
+
+    uint32_t crc = 0;
+    std::vector<int16_t> pcm16;
+    const cdrip::detail::FlacPcmSink sink = [&](const FLAC__int32* samples, size_t frames, unsigned channels, unsigned) {
+        pcm16.assign(samples, samples + frames * channels);
+        crc = cdrip::detail::update_pcm_crc32(crc, pcm16.data(), pcm16.size());
+        return true;
+    };
+    cdrip::detail::FlacDecodeResult decoded{};
+    expect_true(cdrip::detail::decode_flac_file(flac_path, true, sink, decoded, err), err);
+    expect_true(decoded.md5_checked && decoded.md5_ok, "recompressed MD5 should match");
+    expect_true(
+        crc == cdrip::detail::update_pcm_crc32(0, pcm.data(), pcm.size()),
+        "recompressed audio should equal the source PCM");
+
+    std::filesystem::remove_all(temp_dir);
+};
+
+}  // namespace
+
+int main() {
+    test_crc_matches_reference_vector();
+    test_accuraterip_checksum_matches_reference();
+    test_accuraterip_database_lookup();
+    test_decode_checks_md5_and_crc();
+    test_metadata_refresh_keeps_crc_tag();
+    test_update_skips_unchanged_files_and_dry_runs();
+    test_cover_art_embed_modes();
+    test_recompress_keeps_audio_and_tags();
+    return 0;
+}